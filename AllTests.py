@@ -305,6 +305,7 @@ class TestCase(object):
 
 gAllTests = [ TestCase('TestBuffer', [], True)
              ,TestCase('TestStream', [], True)
+             ,TestCase('TestCompression', [], True)
              ,TestCase('TestThread', ['--full'], False)
              ,TestCase('TestFunctorGeneric', [], True)
              ,TestCase('TestFifo', [], True)
@@ -76,9 +76,18 @@ android_ndk_debug = 0
 
 !message Building for system $(openhome_system), architecture $(openhome_architecture), configuration $(openhome_configuration)
 
+# zlib=yes links against zlib.lib so that descriptions and action responses can be compressed
+!if "$(zlib)"=="yes"
+zlib_cflags = -DDEFINE_ZLIB
+libs_core = zlib.lib
+!else
+zlib_cflags =
+libs_core =
+!endif
+
 # Macros used by Common.mak
 ar = lib /nologo /out:$(objdir)
-cflags_tp = $(debug_specific_cflags) /c /W4 $(error_handling) /FR$(objdir) -DDEFINE_LITTLE_ENDIAN -DDEFINE_TRACE $(defines_universal)
+cflags_tp = $(debug_specific_cflags) /c /W4 $(error_handling) /FR$(objdir) -DDEFINE_LITTLE_ENDIAN -DDEFINE_TRACE $(zlib_cflags) $(defines_universal)
 cflags = $(cflags_tp) $(additional_includes) /WX
 cppflags = $(cflags) $(universal_cppflags) $(force_cpp) 
 
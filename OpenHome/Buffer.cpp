@@ -546,12 +546,18 @@ void Bwh::TransferTo(Brh& aBrh)
 void Bwh::TransferTo(Brhz& aBrhz)
 {
     free((void*)aBrhz.iPtr);
-    aBrhz.iPtr = (TByte*)malloc(iBytes+1);
-    ASSERT(aBrhz.iPtr != NULL);
-    (void)memcpy((void*)aBrhz.iPtr, iPtr, iBytes);
-    const_cast<TByte*>(aBrhz.iPtr)[iBytes] = '\0';
+    if (iPtr != NULL && iBytes < iMaxBytes) {
+        const_cast<TByte*>(iPtr)[iBytes] = '\0';
+        aBrhz.iPtr = iPtr;
+    }
+    else {
+        aBrhz.iPtr = (TByte*)malloc(iBytes+1);
+        ASSERT(aBrhz.iPtr != NULL);
+        (void)memcpy((void*)aBrhz.iPtr, iPtr, iBytes);
+        const_cast<TByte*>(aBrhz.iPtr)[iBytes] = '\0';
+        free((void*)iPtr);
+    }
     aBrhz.iBytes = iBytes;
-    free((void*)iPtr);
     iPtr = NULL;
     iBytes = 0;
 }
@@ -180,7 +180,7 @@ public:
     virtual ~Bwh();
     void Grow(TUint aMaxBytes);
     void TransferTo(Brh& aBrh);
-    void TransferTo(Brhz& aBrh); // reallocates buffer for aBrh
+    void TransferTo(Brhz& aBrh); // reallocates buffer for aBrh unless there's room for a nul terminator
     void TransferTo(Bwh& aBwh);
     virtual const TByte* Ptr() const;
 protected:
@@ -0,0 +1,112 @@
+#include <OpenHome/Private/Compression.h>
+#include <OpenHome/Types.h>
+#include <OpenHome/Buffer.h>
+
+#ifdef DEFINE_ZLIB
+# include <zlib.h>
+#endif
+#include <string.h>
+
+using namespace OpenHome;
+
+TBool Compression::Available()
+{
+#ifdef DEFINE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef DEFINE_ZLIB
+
+static const int kWindowBits = 15;
+static const int kWindowBitsGzip = 16 + kWindowBits; // zlib selects gzip wrapping for windowBits > 15
+
+static int WindowBits(Compression::EFormat aFormat)
+{
+    return (aFormat == Compression::eGzip? kWindowBitsGzip : kWindowBits);
+}
+
+void Compression::Compress(const Brx& aSrc, Bwh& aDest, EFormat aFormat)
+{
+    z_stream stream;
+    (void)memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, WindowBits(aFormat), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        THROW(CompressionError);
+    }
+    aDest.SetBytes(0);
+    aDest.Grow((TUint)deflateBound(&stream, aSrc.Bytes()));
+    stream.next_in = const_cast<Bytef*>(aSrc.Ptr());
+    stream.avail_in = aSrc.Bytes();
+    stream.next_out = const_cast<Bytef*>(aDest.Ptr());
+    stream.avail_out = aDest.MaxBytes();
+    const int err = deflate(&stream, Z_FINISH); // output buffer is large enough for the whole stream
+    const TUint bytes = (TUint)stream.total_out;
+    (void)deflateEnd(&stream);
+    if (err != Z_STREAM_END) {
+        THROW(CompressionError);
+    }
+    aDest.SetBytes(bytes);
+}
+
+void Compression::Decompress(const Brx& aSrc, Bwh& aDest, EFormat aFormat)
+{
+    TUint capacity = 4 * aSrc.Bytes() + 1024;
+    if (aFormat == eGzip && aSrc.Bytes() >= 18) {
+        // gzip trailer holds the uncompressed size (mod 2^32); only trusted as a starting point
+        const TByte* trailer = aSrc.Ptr() + aSrc.Bytes() - 4;
+        const TUint hint = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | ((TUint)trailer[3] << 24);
+        if (hint > 0 && hint < kMaxDecompressedBytes) {
+            capacity = hint;
+        }
+    }
+    if (capacity > kMaxDecompressedBytes) {
+        capacity = kMaxDecompressedBytes;
+    }
+    z_stream stream;
+    (void)memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, WindowBits(aFormat)) != Z_OK) {
+        THROW(CompressionError);
+    }
+    aDest.SetBytes(0);
+    aDest.Grow(capacity);
+    stream.next_in = const_cast<Bytef*>(aSrc.Ptr());
+    stream.avail_in = aSrc.Bytes();
+    int err;
+    for (;;) {
+        stream.next_out = const_cast<Bytef*>(aDest.Ptr()) + stream.total_out;
+        stream.avail_out = aDest.MaxBytes() - (TUint)stream.total_out;
+        err = inflate(&stream, Z_NO_FLUSH);
+        aDest.SetBytes((TUint)stream.total_out);
+        if (err != Z_OK && err != Z_BUF_ERROR) {
+            break;
+        }
+        if (stream.avail_out != 0 || aDest.MaxBytes() >= kMaxDecompressedBytes) {
+            // no progress possible (truncated input) or output limit reached
+            err = Z_DATA_ERROR;
+            break;
+        }
+        capacity = 2 * aDest.MaxBytes();
+        aDest.Grow(capacity > kMaxDecompressedBytes? kMaxDecompressedBytes : capacity);
+    }
+    const TBool trailingData = (stream.avail_in != 0);
+    (void)inflateEnd(&stream);
+    if (err != Z_STREAM_END || trailingData) {
+        THROW(CompressionError);
+    }
+}
+
+#else // !DEFINE_ZLIB
+
+void Compression::Compress(const Brx& /*aSrc*/, Bwh& /*aDest*/, EFormat /*aFormat*/)
+{
+    THROW(CompressionError);
+}
+
+void Compression::Decompress(const Brx& /*aSrc*/, Bwh& /*aDest*/, EFormat /*aFormat*/)
+{
+    THROW(CompressionError);
+}
+
+#endif // DEFINE_ZLIB
@@ -0,0 +1,35 @@
+#ifndef HEADER_COMPRESSION
+#define HEADER_COMPRESSION
+
+#include <OpenHome/Types.h>
+#include <OpenHome/Buffer.h>
+#include <OpenHome/Exception.h>
+
+EXCEPTION(CompressionError)
+
+namespace OpenHome {
+
+/**
+ * Utilities for compressing/decompressing whole buffers using the HTTP content codings
+ *
+ * Only available in builds linked against zlib (make zlib=yes).  Other builds throw
+ * CompressionError from every call.
+ */
+class Compression
+{
+public:
+    enum EFormat
+    {
+        eDeflate // zlib wrapped, as HTTP's "deflate" coding
+       ,eGzip
+    };
+    static const TUint kMaxDecompressedBytes = 16 * 1024 * 1024;
+public:
+    static TBool Available();
+    static void Compress(const Brx& aSrc, Bwh& aDest, EFormat aFormat); // throws CompressionError
+    static void Decompress(const Brx& aSrc, Bwh& aDest, EFormat aFormat); // throws CompressionError
+};
+
+} // namespace OpenHome
+
+#endif // HEADER_COMPRESSION
@@ -327,3 +327,14 @@ TUint16 Converter::LeUint16At(const Brx& aBuf, TUint aIndex)
     }
     return (TUint16)((b[1] << 8) | b[0]);
 }
+
+TUint32 Converter::Fnv1a(const Brx& aBuf, TUint32 aHash)
+{
+    static const TUint32 kFnvPrime = 16777619u;
+    const TByte* ptr = aBuf.Ptr();
+    const TUint bytes = aBuf.Bytes();
+    for (TUint i=0; i<bytes; i++) {
+        aHash = (aHash ^ ptr[i]) * kFnvPrime;
+    }
+    return aHash;
+}
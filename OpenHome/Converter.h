@@ -8,10 +8,12 @@
 namespace OpenHome {
 
 /**
- * Utilities for converting to/from base64 and (un)escaping XML
+ * Utilities for converting to/from base64, (un)escaping XML and hashing
  */
 class Converter
 {
+public:
+    static const TUint32 kFnv1aOffsetBasis = 2166136261u;
 public:
     static void ToBase64(IWriter& aWriter, const Brx& aValue);
     static void FromBase64(Bwx& aValue); // Converts in place
@@ -22,6 +24,7 @@ public:
     static TUint16 BeUint16At(const Brx& aBuf, TUint aIndex);
     static TUint32 LeUint32At(const Brx& aBuf, TUint aIndex);
     static TUint16 LeUint16At(const Brx& aBuf, TUint aIndex);
+    static TUint32 Fnv1a(const Brx& aBuf, TUint32 aHash = kFnv1aOffsetBasis); // pass an earlier result as aHash to hash several buffers
 private:
     static void ToXmlEscaped(IWriter& aWriter, TByte aValue);
     static TBool IsMultiByteChar(TByte aChar, TUint& aBytes);
@@ -88,9 +88,13 @@ const Brn Http::kConnectionUpgrade("upgrade");
 const Brn Http::kContentLanguageEnglish("en");
 const Brn Http::kRangeBytes("bytes=");
 const Brn Http::kRangeSeparator("-");
+const Brn Http::kAcceptRangesBytes("bytes");
 const Brn Http::kExpect100Continue("100-continue");
 const Brn Http::kTransferEncodingChunked("chunked");
 const Brn Http::kTransferEncodingIdentity("identity");
+const Brn Http::kContentCodingGzip("gzip");
+const Brn Http::kContentCodingDeflate("deflate");
+const Brn Http::kAcceptEncodingGzipDeflate("gzip, deflate");
 
 // Http::EVersion
 
@@ -154,6 +158,20 @@ void Http::WriteHeaderRange(WriterHttpHeader& aWriter, TUint64 aFirst, TUint64 a
     aWriter.WriteHeader(Http::kHeaderRange, buf);
 }
 
+void Http::WriteHeaderContentRange(WriterHttpHeader& aWriter, TUint64 aFirst, TUint64 aLast, TUint64 aTotal)
+{
+    Bws<6+20+1+20+1+20> buf;
+    buf.Append(kAcceptRangesBytes);
+    buf.Append(' ');
+    Ascii::AppendDec(buf, aFirst);
+    buf.Append(Http::kRangeSeparator);
+    Ascii::AppendDec(buf, aLast);
+    buf.Append('/');
+    Ascii::AppendDec(buf, aTotal);
+
+    aWriter.WriteHeader(Http::kHeaderContentRange, buf);
+}
+
 void Http::WriteHeaderHostAndPort(WriterHttpHeader& aWriter, const Brx& aHost, TUint aPort)
 {
     IWriterAscii& writer = aWriter.WriteHeaderField(Http::kHeaderHost);
@@ -191,6 +209,48 @@ void Http::WriteHeaderUserAgent(WriterHttpHeader& aWriter, Environment& aEnv)
     }
 }
 
+static void AppendTwoDigits(Bwx& aBuf, TUint aValue)
+{
+    aBuf.Append((TChar)('0' + (aValue / 10) % 10));
+    aBuf.Append((TChar)('0' + aValue % 10));
+}
+
+void Http::WriteHeaderLastModified(WriterHttpHeader& aWriter, TUint aSecsSince1970)
+{
+    static const TChar* kDays[] = { "Thu", "Fri", "Sat", "Sun", "Mon", "Tue", "Wed" }; // 1 Jan 1970 was a Thursday
+    static const TChar* kMonths[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+    const TUint days = aSecsSince1970 / 86400;
+    const TUint secsInDay = aSecsSince1970 % 86400;
+
+    // convert days since 1970 to a civil date, treating years as starting in March
+    const TUint z = days + 719468; // days since 1 Mar 0000
+    const TUint era = z / 146097;
+    const TUint dayOfEra = z - era * 146097;
+    const TUint yearOfEra = (dayOfEra - dayOfEra/1460 + dayOfEra/36524 - dayOfEra/146096) / 365;
+    const TUint dayOfYear = dayOfEra - (365*yearOfEra + yearOfEra/4 - yearOfEra/100);
+    const TUint mp = (5*dayOfYear + 2) / 153;
+    const TUint day = dayOfYear - (153*mp + 2)/5 + 1;
+    const TUint month = (mp < 10? mp + 3 : mp - 9);
+    const TUint year = yearOfEra + era * 400 + (month <= 2? 1 : 0);
+
+    Bws<32> buf; // e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+    buf.Append(kDays[days % 7]);
+    buf.Append(", ");
+    AppendTwoDigits(buf, day);
+    buf.Append(' ');
+    buf.Append(kMonths[month-1]);
+    buf.Append(' ');
+    (void)Ascii::AppendDec(buf, year);
+    buf.Append(' ');
+    AppendTwoDigits(buf, secsInDay / 3600);
+    buf.Append(':');
+    AppendTwoDigits(buf, (secsInDay / 60) % 60);
+    buf.Append(':');
+    AppendTwoDigits(buf, secsInDay % 60);
+    buf.Append(" GMT");
+    aWriter.WriteHeader(Http::kHeaderLastModified, buf);
+}
+
 
 // HttpStatus
 
@@ -617,6 +677,12 @@ void WriterHttpHeader::WriteFlush()
     iWriter.Flush();
 }
 
+void WriterHttpHeader::WriteHeadersEnd()
+{
+    LOG(kHttp, "Http Write Header   ");
+    iWriter.WriteNewline();
+}
+
 void WriterHttpHeader::WriteHeader(const Brx& aField, const Brx& aValue)
 {
     LOG(kHttp, "Http Write Header %.*s: %.*s\n", PBUF(aField), PBUF(aValue));
@@ -963,6 +1029,243 @@ void HttpHeaderUserAgent::Process(const Brx& aValue)
 }
 
 
+// HttpHeaderETag
+
+const Brx& HttpHeaderETag::ETag() const
+{
+    return iETag;
+}
+
+TBool HttpHeaderETag::Recognise(const Brx& aHeader)
+{
+    return Ascii::CaseInsensitiveEquals(aHeader, Http::kHeaderETag);
+}
+
+void HttpHeaderETag::Process(const Brx& aValue)
+{
+    try {
+        iETag.ReplaceThrow(aValue);
+        SetReceived();
+    }
+    catch (BufferOverflow&) {
+    }
+}
+
+
+// HttpHeaderIfNoneMatch
+
+TBool HttpHeaderIfNoneMatch::Matches(const Brx& aETag) const
+{
+    if (!Received() || aETag.Bytes() == 0) {
+        return false;
+    }
+    const Brn target = Opaque(aETag);
+    Parser parser(iValue);
+    while (!parser.Finished()) {
+        Brn tag = Ascii::Trim(parser.Next(','));
+        if (tag == Brn("*") || (tag.Bytes() > 0 && Opaque(tag) == target)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TBool HttpHeaderIfNoneMatch::Recognise(const Brx& aHeader)
+{
+    return Ascii::CaseInsensitiveEquals(aHeader, Http::kHeaderIfNoneMatch);
+}
+
+void HttpHeaderIfNoneMatch::Process(const Brx& aValue)
+{
+    try {
+        iValue.ReplaceThrow(aValue);
+        SetReceived();
+    }
+    catch (BufferOverflow&) {
+    }
+}
+
+Brn HttpHeaderIfNoneMatch::Opaque(const Brx& aETag)
+{ // static
+    static const Brn kWeakPrefix("W/");
+    if (aETag.Bytes() > kWeakPrefix.Bytes() && aETag.Split(0, kWeakPrefix.Bytes()) == kWeakPrefix) {
+        return aETag.Split(kWeakPrefix.Bytes());
+    }
+    return Brn(aETag);
+}
+
+
+// HttpHeaderRange
+
+TBool HttpHeaderRange::Resolve(TUint aTotalBytes, TUint& aFirst, TUint& aBytes) const
+{
+    ASSERT(Received());
+    if (iSuffix) {
+        if (iLast == 0 || aTotalBytes == 0) {
+            return false;
+        }
+        aBytes = (iLast < aTotalBytes? (TUint)iLast : aTotalBytes);
+        aFirst = aTotalBytes - aBytes;
+        return true;
+    }
+    if (iFirst >= aTotalBytes) {
+        return false;
+    }
+    aFirst = (TUint)iFirst;
+    const TUint64 last = ((iOpenEnded || iLast >= aTotalBytes)? aTotalBytes - 1 : iLast);
+    aBytes = (TUint)(last - iFirst + 1);
+    return true;
+}
+
+TBool HttpHeaderRange::Recognise(const Brx& aHeader)
+{
+    return Ascii::CaseInsensitiveEquals(aHeader, Http::kHeaderRange);
+}
+
+void HttpHeaderRange::Process(const Brx& aValue)
+{
+    Brn value = Ascii::Trim(aValue);
+    const TUint prefixBytes = Http::kRangeBytes.Bytes();
+    if (value.Bytes() <= prefixBytes || !Ascii::CaseInsensitiveEquals(value.Split(0, prefixBytes), Http::kRangeBytes)) {
+        return;
+    }
+    value.Set(value.Split(prefixBytes));
+    if (Ascii::Contains(value, ',')) {
+        return; // multipart/byteranges responses aren't supported
+    }
+    Parser parser(value);
+    Brn first = Ascii::Trim(parser.Next('-'));
+    Brn last = Ascii::Trim(parser.Remaining());
+    iSuffix = (first.Bytes() == 0);
+    iOpenEnded = (last.Bytes() == 0);
+    if (iSuffix && iOpenEnded) {
+        return;
+    }
+    try {
+        iFirst = (iSuffix? 0 : Ascii::Uint64(first));
+        iLast = (iOpenEnded? 0 : Ascii::Uint64(last));
+    }
+    catch (AsciiError&) {
+        return;
+    }
+    if (!iSuffix && !iOpenEnded && iLast < iFirst) {
+        return;
+    }
+    SetReceived();
+}
+
+
+// HttpHeaderIfRange
+
+TBool HttpHeaderIfRange::Matches(const Brx& aETag) const
+{
+    static const Brn kWeakPrefix("W/");
+    if (!Received() || aETag.Bytes() == 0 || iValue.Bytes() == 0 || iValue[0] != '\"') {
+        return false;
+    }
+    if (aETag.Bytes() >= kWeakPrefix.Bytes() && aETag.Split(0, kWeakPrefix.Bytes()) == kWeakPrefix) {
+        return false;
+    }
+    return (iValue == aETag);
+}
+
+TBool HttpHeaderIfRange::Recognise(const Brx& aHeader)
+{
+    return Ascii::CaseInsensitiveEquals(aHeader, Http::kHeaderIfRange);
+}
+
+void HttpHeaderIfRange::Process(const Brx& aValue)
+{
+    try {
+        iValue.ReplaceThrow(Ascii::Trim(aValue));
+        SetReceived();
+    }
+    catch (BufferOverflow&) {
+    }
+}
+
+
+// HttpHeaderAcceptEncoding
+
+TBool HttpHeaderAcceptEncoding::Gzip() const
+{
+    return (Received()? iGzip : false);
+}
+
+TBool HttpHeaderAcceptEncoding::Deflate() const
+{
+    return (Received()? iDeflate : false);
+}
+
+TBool HttpHeaderAcceptEncoding::Recognise(const Brx& aHeader)
+{
+    return Ascii::CaseInsensitiveEquals(aHeader, Http::kHeaderAcceptEncoding);
+}
+
+void HttpHeaderAcceptEncoding::Process(const Brx& aValue)
+{
+    // header may be split over several lines; only clear state for the first of these
+    if (!Received()) {
+        iGzip = false;
+        iDeflate = false;
+    }
+    SetReceived();
+    Parser parser(aValue);
+    while (!parser.Finished()) {
+        Parser params(parser.Next(','));
+        Brn coding = params.Next(';');
+        if (Ascii::CaseInsensitiveEquals(coding, Http::kContentCodingGzip)) {
+            iGzip = Acceptable(params.Remaining());
+        }
+        else if (Ascii::CaseInsensitiveEquals(coding, Http::kContentCodingDeflate)) {
+            iDeflate = Acceptable(params.Remaining());
+        }
+    }
+}
+
+TBool HttpHeaderAcceptEncoding::Acceptable(const Brx& aParams)
+{ // static
+    Parser params(aParams);
+    while (!params.Finished()) {
+        Parser param(params.Next(';'));
+        Brn name = param.Next('=');
+        if (Ascii::CaseInsensitiveEquals(name, Brn("q"))) {
+            Brn qvalue = Ascii::Trim(param.Remaining());
+            for (TUint i=0; i<qvalue.Bytes(); i++) {
+                if (qvalue[i] >= '1' && qvalue[i] <= '9') {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// HttpHeaderContentEncoding
+
+const Brx& HttpHeaderContentEncoding::Encoding() const
+{
+    return iEncoding;
+}
+
+TBool HttpHeaderContentEncoding::Recognise(const Brx& aHeader)
+{
+    return Ascii::CaseInsensitiveEquals(aHeader, Http::kHeaderContentEncoding);
+}
+
+void HttpHeaderContentEncoding::Process(const Brx& aValue)
+{
+    try {
+        iEncoding.ReplaceThrow(Ascii::Trim(aValue));
+        SetReceived();
+    }
+    catch (BufferOverflow&) {
+    }
+}
+
+
 // ReaderHttpChunked
 
 ReaderHttpChunked::ReaderHttpChunked(IReader& aReader)
@@ -1048,6 +1351,9 @@ void WriterHttpChunked::Write(TByte aValue)
 void WriterHttpChunked::Write(const Brx& aBuffer)
 {
     if (iChunked) {
+        if (aBuffer.Bytes() == 0) {
+            return; // an empty chunk would terminate the body
+        }
         Bws<16> count;
         Ascii::AppendHexTrim(count, aBuffer.Bytes());
         iBuffer.Write(count);
@@ -1060,6 +1366,27 @@ void WriterHttpChunked::Write(const Brx& aBuffer)
     }
 }
 
+void WriterHttpChunked::WriteVector(const Brx* const aBuffers[], TUint aCount)
+{
+    if (!iChunked) {
+        iBuffer.WriteVector(aBuffers, aCount);
+        return;
+    }
+    TUint bytes = 0;
+    for (TUint i=0; i<aCount; i++) {
+        bytes += aBuffers[i]->Bytes();
+    }
+    if (bytes == 0) {
+        return;
+    }
+    Bws<16> count;
+    Ascii::AppendHexTrim(count, bytes);
+    iBuffer.Write(count);
+    iBuffer.Write(Http::kHeaderTerminator);
+    iBuffer.WriteVector(aBuffers, aCount);
+    iBuffer.Write(Http::kHeaderTerminator);
+}
+
 void WriterHttpChunked::WriteFlush()
 {
     if (iChunked) {
@@ -93,10 +93,14 @@ public:
     static const Brn kContentLanguageEnglish;
     static const Brn kRangeBytes;
     static const Brn kRangeSeparator;
+    static const Brn kAcceptRangesBytes;
     static const Brn kExpect100Continue;
     static const Brn kChunkedCountSeparator;
     static const Brn kTransferEncodingChunked;
     static const Brn kTransferEncodingIdentity;
+    static const Brn kContentCodingGzip;
+    static const Brn kContentCodingDeflate;
+    static const Brn kAcceptEncodingGzipDeflate;
 public:
     enum EVersion
     {
@@ -110,11 +114,13 @@ public:
     static const Brx& Version(EVersion aVersion);
     static void WriteHeaderRangeFirstOnly(WriterHttpHeader& aWriter, TUint64 aFirst); //bytes=<aFirst>-
     static void WriteHeaderRange(WriterHttpHeader& aWriter, TUint64 aFirst, TUint64 aLast); //bytes=<aFirst>-<aLast>
+    static void WriteHeaderContentRange(WriterHttpHeader& aWriter, TUint64 aFirst, TUint64 aLast, TUint64 aTotal); //bytes <aFirst>-<aLast>/<aTotal>
     static void WriteHeaderHostAndPort(WriterHttpHeader& aWriter, const Brx& aHost, TUint aPort);
     static void WriteHeaderContentLength(WriterHttpHeader& aWriter, TUint aLength);
     static void WriteHeaderContentType(WriterHttpHeader& aWriter, const Brx& aType);
     static void WriteHeaderConnectionClose(WriterHttpHeader& aWriter);
     static void WriteHeaderUserAgent(WriterHttpHeader& aWriter, Environment& aEnv);
+    static void WriteHeaderLastModified(WriterHttpHeader& aWriter, TUint aSecsSince1970); // RFC 1123 date
 };
 
 class HttpStatus
@@ -329,6 +335,8 @@ public: // from IWriterHeader
     void WriteHeader(const Brx& aField, const Brx& aValue);
     void WriteHeaderBase64(const Brx& aField, const Brx& aValue);
     IWriterAscii& WriteHeaderField(const Brx& aField); // returns a stream for writing the value
+public:
+    void WriteHeadersEnd(); // as WriteFlush but leaves data buffered so the start of a body can be sent with it
 protected:
     WriterHttpHeader(IWriter& aWriter);
 protected:
@@ -463,6 +471,96 @@ private:
     Bws<kMaxUserAgentBytes> iUserAgent;
 };
 
+class HttpHeaderETag : public HttpHeader
+{
+public:
+    static const TUint kMaxETagBytes = 128;
+public:
+    const Brx& ETag() const;
+private:
+    TBool Recognise(const Brx& aHeader);
+    void Process(const Brx& aValue);
+private:
+    Bws<kMaxETagBytes> iETag;
+};
+
+class HttpHeaderIfNoneMatch : public HttpHeader
+{
+    static const TUint kMaxValueBytes = 1024;
+public:
+    /**
+     * Returns true if aETag (including its surrounding quotes) is listed in this header.
+     * Uses the weak comparison function required for If-None-Match.
+     */
+    TBool Matches(const Brx& aETag) const;
+private:
+    TBool Recognise(const Brx& aHeader);
+    void Process(const Brx& aValue);
+    static Brn Opaque(const Brx& aETag);
+private:
+    Bws<kMaxValueBytes> iValue;
+};
+
+class HttpHeaderRange : public HttpHeader
+{
+public:
+    /**
+     * Resolves the requested range against an entity of aTotalBytes.
+     * Only single byte ranges are recognised; other requests are treated as not received.
+     * Returns false if the range can't be satisfied.
+     */
+    TBool Resolve(TUint aTotalBytes, TUint& aFirst, TUint& aBytes) const;
+private:
+    TBool Recognise(const Brx& aHeader);
+    void Process(const Brx& aValue);
+private:
+    TUint64 iFirst;
+    TUint64 iLast;
+    TBool iSuffix;      // "bytes=-n"; iLast holds n
+    TBool iOpenEnded;   // "bytes=n-"
+};
+
+class HttpHeaderIfRange : public HttpHeader
+{
+public:
+    /**
+     * Returns true if aETag (including its surrounding quotes) is a strong match for this header.
+     * Dates aren't supported so never match.
+     */
+    TBool Matches(const Brx& aETag) const;
+private:
+    TBool Recognise(const Brx& aHeader);
+    void Process(const Brx& aValue);
+private:
+    Bws<HttpHeaderETag::kMaxETagBytes> iValue;
+};
+
+class HttpHeaderAcceptEncoding : public HttpHeader
+{
+public:
+    TBool Gzip() const;
+    TBool Deflate() const;
+private:
+    TBool Recognise(const Brx& aHeader);
+    void Process(const Brx& aValue);
+    static TBool Acceptable(const Brx& aParams); // false if a q value of 0 is given
+private:
+    TBool iGzip;
+    TBool iDeflate;
+};
+
+class HttpHeaderContentEncoding : public HttpHeader
+{
+    static const TUint kMaxEncodingBytes = 32;
+public:
+    const Brx& Encoding() const;
+private:
+    TBool Recognise(const Brx& aHeader);
+    void Process(const Brx& aValue);
+private:
+    Bws<kMaxEncodingBytes> iEncoding;
+};
+
 class ReaderHttpChunked : public IReader
 {
     static const TUint kChunkSizeBufBytes = 10;
@@ -490,6 +588,7 @@ public: // from IWriter
     void Write(TByte aValue);
     void Write(const Brx& aBuffer);
     void WriteFlush();
+    void WriteVector(const Brx* const aBuffers[], TUint aCount); // writes a single chunk
 private:
     Sws<kMaxBufferBytes> iBuffer;
     TBool iChunked;
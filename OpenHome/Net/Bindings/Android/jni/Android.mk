@@ -14,6 +14,7 @@ LOCAL_SRC_FILES := $(ohroot)OpenHome/Ascii.cpp \
                    $(ohroot)OpenHome/Net/Device/Bonjour/Bonjour.cpp \
                    $(ohroot)OpenHome/Buffer.cpp \
                    $(ohroot)OpenHome/Converter.cpp \
+                   $(ohroot)OpenHome/Compression.cpp \
                    $(ohroot)thirdparty/libb64/cencode.c \
                    $(ohroot)thirdparty/libb64/cdecode.c \
                    $(ohroot)OpenHome/Net/Discovery.cpp \
@@ -28,6 +29,7 @@ LOCAL_SRC_FILES := $(ohroot)OpenHome/Ascii.cpp \
                    $(ohroot)OpenHome/Net/Bindings/C/ControlPoint/CpDeviceUpnpC.cpp \
                    $(ohroot)OpenHome/Net/Bindings/Cpp/ControlPoint/CpDeviceUpnpStd.cpp \
                    $(ohroot)OpenHome/Net/ControlPoint/CpiDevice.cpp \
+                   $(ohroot)OpenHome/Net/ControlPoint/Upnp/CpiDeviceCacheUpnp.cpp \
                    $(ohroot)OpenHome/Net/ControlPoint/Dv/CpiDeviceDv.cpp \
                    $(ohroot)OpenHome/Net/ControlPoint/Lpec/CpiDeviceLpec.cpp \
                    $(ohroot)OpenHome/Net/ControlPoint/Upnp/CpiDeviceUpnp.cpp \
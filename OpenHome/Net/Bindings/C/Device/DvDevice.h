@@ -32,7 +32,8 @@ typedef THandle DvDeviceC;
  * Callback which is run before serving a file begins
  *
  * @param[in] aWriterData  Opaque pointer passed to OhNetCallbackResourceManager
- * @param[in] aTotalBytes  Size in bytes of the file.  Can be 0 if size is unknown.
+ * @param[in] aTotalBytes  Size in bytes of the file.  Can be 0 if size is unknown, in which
+ *                         case the file is streamed using chunked transfer encoding.
  * @param[in] aMimeType    MIME type of the file.  May be NULL if this is unknown.
  *
  * @return  0 on success; non-zero on error.
@@ -43,12 +44,14 @@ typedef int32_t (STDCALL *OhNetCallbackWriteResourceBegin)(void* aWriterData, ui
  * Callback which runs to serve a chunk of a file
  *
  * Will be called 0..n times after OhNetCallbackWriteResourceBegin and before OhNetCallbackWriteResourceEnd
+ * May block until the client has read earlier data.
  *
  * @param[in] aWriterData  Opaque pointer passed to OhNetCallbackResourceManager
  * @param[in] aData        File data to write
  * @param[in] aBytes       Size in bytes of aData
  *
- * @return  0 on success; non-zero on error.
+ * @return  0 on success; non-zero on error (e.g. the client has disconnected).  No further
+ *          data should be written after an error.
  */
 typedef int32_t (STDCALL *OhNetCallbackWriteResource)(void* aWriterData, const uint8_t* aData, uint32_t aBytes);
 
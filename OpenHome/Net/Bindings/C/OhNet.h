@@ -299,6 +299,15 @@ DllExport void STDCALL OhNetInitParamsSetMsearchTime(OhNetHandleInitParams aPara
  */
 DllExport void STDCALL OhNetInitParamsSetMsearchTtl(OhNetHandleInitParams aParams, uint32_t aTtl);
 
+/**
+ * Set the period over which repeated ssdp:alive notifications from the same sender
+ * with unchanged location and max-age are suppressed.
+ *
+ * @param[in] aParams          Initialisation params
+ * @param[in] aMs              Window in milliseconds.  Zero disables suppression.
+ */
+DllExport void STDCALL OhNetInitParamsSetSsdpDuplicateWindow(OhNetHandleInitParams aParams, uint32_t aMs);
+
 /**
  * Set a custom number of threads which will be dedicated to eventing (handling
  * updates to subscribed state variables)
@@ -311,6 +320,24 @@ DllExport void STDCALL OhNetInitParamsSetMsearchTtl(OhNetHandleInitParams aParam
  */
 DllExport void STDCALL OhNetInitParamsSetNumEventSessionThreads(OhNetHandleInitParams aParams, uint32_t aNumThreads);
 
+/**
+ * Set the number of threads which run proxy property change callbacks
+ *
+ * By default (zero threads), callbacks run on the event session thread that received
+ * each update, once per update.  A slow callback then holds up that session's later
+ * events.
+ * Any other value moves callbacks onto that many dispatch threads.  Event session
+ * threads then only apply updates, so a slow callback doesn't delay the processing
+ * of later events.  Callbacks then run asynchronously and changes which arrive while
+ * a callback is pending are reported together, so a callback may see values from
+ * later updates and will not run once per update.
+ *
+ * @param[in] aParams          Initialisation params
+ * @param[in] aNumThreads      Number of threads.  Zero (the default) runs callbacks on
+ *                             the event session threads.
+ */
+DllExport void STDCALL OhNetInitParamsSetNumEventDispatchThreads(OhNetHandleInitParams aParams, uint32_t aNumThreads);
+
 /**
  * Set the number of threads which should be dedicated to fetching device/service XML.
  *
@@ -411,6 +438,27 @@ DllExport void STDCALL OhNetInitParamsSetDvMaxUpdateTime(OhNetHandleInitParams a
  */
 DllExport void STDCALL OhNetInitParamsSetDvNumServerThreads(OhNetHandleInitParams aParams, uint32_t aNumThreads);
 
+/**
+ * Set the number of listening sockets each UPnP device server opens on its port.
+ *
+ * Where the platform supports SO_REUSEPORT, incoming connections are spread between
+ * listeners, each served by its own group of server threads.  Other platforms always
+ * use a single listener.
+ *
+ * @param[in] aParams          Initialisation params
+ * @param[in] aNumListeners    Number of listeners.  Must be greater than zero.
+ */
+DllExport void STDCALL OhNetInitParamsSetDvNumServerListeners(OhNetHandleInitParams aParams, uint32_t aNumListeners);
+
+/**
+ * Set the maximum rate at which all devices together send multicast alive/byebye/update
+ * notifications.
+ *
+ * @param[in] aParams          Initialisation params
+ * @param[in] aPacketsPerSec   Packets per second.  Zero removes the limit.
+ */
+DllExport void STDCALL OhNetInitParamsSetDvSsdpPacketsPerSec(OhNetHandleInitParams aParams, uint32_t aPacketsPerSec);
+
 /**
  * Set the number of threads which should be dedicated to publishing changes
  * to state variables on a service + device.
@@ -492,6 +540,17 @@ DllExport void STDCALL OhNetInitParamsSetDvEnableBonjour(OhNetHandleInitParams a
 */
 DllExport void STDCALL OhNetInitParamsSetHttpUserAgent(OhNetHandleInitParams aParams, const char* aUserAgent);
 
+/**
+ * Persist UPnP devices found by control points to a file.
+ *
+ * Devices in this cache are reported by device lists immediately on startup then
+ * revalidated in the background.
+ *
+ * @param[in] aParams          Initialisation params
+ * @param[in] aFilename        Full path of the cache file.  Will be created if it doesn't exist.
+ */
+DllExport void STDCALL OhNetInitParamsSetCpUpnpDeviceCache(OhNetHandleInitParams aParams, const char* aFilename);
+
 /**
  * Query the tcp connection timeout
  *
@@ -519,6 +578,15 @@ DllExport uint32_t STDCALL OhNetInitParamsMsearchTimeSecs(OhNetHandleInitParams
  */
 DllExport uint32_t STDCALL OhNetInitParamsMsearchTtl(OhNetHandleInitParams aParams);
 
+/**
+ * Query the period over which duplicate ssdp:alive notifications are suppressed
+ *
+ * @param[in] aParams          Initialisation params
+ *
+ * @return  window in milliseconds
+ */
+DllExport uint32_t STDCALL OhNetInitParamsSsdpDuplicateWindowMs(OhNetHandleInitParams aParams);
+
 /**
  * Query the number of event session threads
  *
@@ -528,6 +596,15 @@ DllExport uint32_t STDCALL OhNetInitParamsMsearchTtl(OhNetHandleInitParams aPara
  */
 DllExport uint32_t STDCALL OhNetInitParamsNumEventSessionThreads(OhNetHandleInitParams aParams);
 
+/**
+ * Query the number of threads which run proxy property change callbacks
+ *
+ * @param[in] aParams          Initialisation params
+ *
+ * @return  number of threads (0 => callbacks run on event session threads)
+ */
+DllExport uint32_t STDCALL OhNetInitParamsNumEventDispatchThreads(OhNetHandleInitParams aParams);
+
 /**
  * Query the number of XML fetcher threads
  *
@@ -601,6 +678,24 @@ DllExport uint32_t STDCALL OhNetInitParamsDvMaxUpdateTimeSecs(OhNetHandleInitPar
  */
 DllExport uint32_t STDCALL OhNetInitParamsDvNumServerThreads(OhNetHandleInitParams aParams);
 
+/**
+ * Query the number of listening sockets per device stack server
+ *
+ * @param[in] aParams          Initialisation params
+ *
+ * @return  number of listeners
+ */
+DllExport uint32_t STDCALL OhNetInitParamsDvNumServerListeners(OhNetHandleInitParams aParams);
+
+/**
+ * Query the maximum rate for multicast device announcements
+ *
+ * @param[in] aParams          Initialisation params
+ *
+ * @return  packets per second (0 => unlimited)
+ */
+DllExport uint32_t STDCALL OhNetInitParamsDvSsdpPacketsPerSec(OhNetHandleInitParams aParams);
+
 /**
  * Query the number of device stack publisher threads
  *
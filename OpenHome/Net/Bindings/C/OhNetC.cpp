@@ -169,12 +169,24 @@ void STDCALL OhNetInitParamsSetMsearchTtl(OhNetHandleInitParams aParams, uint32_
     ip->SetMsearchTtl(aTtl);
 }
 
+void STDCALL OhNetInitParamsSetSsdpDuplicateWindow(OhNetHandleInitParams aParams, uint32_t aMs)
+{
+    InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
+    ip->SetSsdpDuplicateWindow(aMs);
+}
+
 void STDCALL OhNetInitParamsSetNumEventSessionThreads(OhNetHandleInitParams aParams, uint32_t aNumThreads)
 {
     InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
     ip->SetNumEventSessionThreads(aNumThreads);
 }
 
+void STDCALL OhNetInitParamsSetNumEventDispatchThreads(OhNetHandleInitParams aParams, uint32_t aNumThreads)
+{
+    InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
+    ip->SetNumEventDispatchThreads(aNumThreads);
+}
+
 void STDCALL OhNetInitParamsSetNumXmlFetcherThreads(OhNetHandleInitParams aParams, uint32_t aNumThreads)
 {
     InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
@@ -241,6 +253,18 @@ void STDCALL OhNetInitParamsSetDvNumServerThreads(OhNetHandleInitParams aParams,
     ip->SetDvNumServerThreads(aNumThreads);
 }
 
+void STDCALL OhNetInitParamsSetDvNumServerListeners(OhNetHandleInitParams aParams, uint32_t aNumListeners)
+{
+    InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
+    ip->SetDvNumServerListeners(aNumListeners);
+}
+
+void STDCALL OhNetInitParamsSetDvSsdpPacketsPerSec(OhNetHandleInitParams aParams, uint32_t aPacketsPerSec)
+{
+    InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
+    ip->SetDvSsdpPacketsPerSec(aPacketsPerSec);
+}
+
 void STDCALL OhNetInitParamsSetDvNumPublisherThreads(OhNetHandleInitParams aParams, uint32_t aNumThreads)
 {
     InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
@@ -284,6 +308,12 @@ void STDCALL OhNetInitParamsSetHttpUserAgent(OhNetHandleInitParams aParams, cons
     ip->SetHttpUserAgent(userAgent);
 }
 
+void STDCALL OhNetInitParamsSetCpUpnpDeviceCache(OhNetHandleInitParams aParams, const char* aFilename)
+{
+    InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
+    ip->SetCpUpnpDeviceCache(aFilename);
+}
+
 uint32_t STDCALL OhNetInitParamsTcpConnectTimeoutMs(OhNetHandleInitParams aParams)
 {
     InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
@@ -302,12 +332,24 @@ uint32_t STDCALL OhNetInitParamsMsearchTtl(OhNetHandleInitParams aParams)
     return ip->MsearchTtl();
 }
 
+uint32_t STDCALL OhNetInitParamsSsdpDuplicateWindowMs(OhNetHandleInitParams aParams)
+{
+    InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
+    return ip->SsdpDuplicateWindowMs();
+}
+
 uint32_t STDCALL OhNetInitParamsNumEventSessionThreads(OhNetHandleInitParams aParams)
 {
     InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
     return ip->NumEventSessionThreads();
 }
 
+uint32_t STDCALL OhNetInitParamsNumEventDispatchThreads(OhNetHandleInitParams aParams)
+{
+    InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
+    return ip->NumEventDispatchThreads();
+}
+
 uint32_t STDCALL OhNetInitParamsNumXmlFetcherThreads(OhNetHandleInitParams aParams)
 {
     InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
@@ -356,6 +398,18 @@ uint32_t STDCALL OhNetInitParamsDvNumServerThreads(OhNetHandleInitParams aParams
     return ip->DvNumServerThreads();
 }
 
+uint32_t STDCALL OhNetInitParamsDvNumServerListeners(OhNetHandleInitParams aParams)
+{
+    InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
+    return ip->DvNumServerListeners();
+}
+
+uint32_t STDCALL OhNetInitParamsDvSsdpPacketsPerSec(OhNetHandleInitParams aParams)
+{
+    InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
+    return ip->DvSsdpPacketsPerSec();
+}
+
 uint32_t STDCALL OhNetInitParamsDvNumPublisherThreads(OhNetHandleInitParams aParams)
 {
     InitialisationParams* ip = reinterpret_cast<InitialisationParams*>(aParams);
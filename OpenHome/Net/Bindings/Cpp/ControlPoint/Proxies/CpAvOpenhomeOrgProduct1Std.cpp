@@ -1415,6 +1415,11 @@ void CpProxyAvOpenhomeOrgProduct1Cpp::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyAvOpenhomeOrgProduct1Cpp::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyAvOpenhomeOrgProduct1Cpp::Version() const
 {
   return iCpProxy.Version();
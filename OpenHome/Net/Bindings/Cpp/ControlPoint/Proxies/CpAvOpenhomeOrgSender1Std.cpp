@@ -504,6 +504,11 @@ void CpProxyAvOpenhomeOrgSender1Cpp::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyAvOpenhomeOrgSender1Cpp::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyAvOpenhomeOrgSender1Cpp::Version() const
 {
   return iCpProxy.Version();
@@ -20,6 +20,7 @@ class PropertyInt;
 class PropertyString;
 class PropertyUint;
 class CpProxy;
+class IChangedPropertyWriter;
 class ICpProxyOpenhomeOrgSubscriptionLongPoll1Cpp : public ICpProxy
 {
 public:
@@ -213,6 +214,10 @@ public:
     */
     void ReportEvent(Functor aFunctor);
     /**
+    * This function exposes the WriteChangedProperties() function of the iCpProxy member variable
+    */
+    void WriteChangedProperties(IChangedPropertyWriter& aWriter) const;
+    /**
     * This function exposes the Version() function of the iCpProxy member variable
     */
     TUint Version() const;
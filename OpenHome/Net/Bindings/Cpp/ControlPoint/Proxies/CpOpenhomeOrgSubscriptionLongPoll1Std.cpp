@@ -351,6 +351,11 @@ void CpProxyOpenhomeOrgSubscriptionLongPoll1Cpp::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyOpenhomeOrgSubscriptionLongPoll1Cpp::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyOpenhomeOrgSubscriptionLongPoll1Cpp::Version() const
 {
   return iCpProxy.Version();
@@ -1557,6 +1557,11 @@ void CpProxyOpenhomeOrgTestBasic1Cpp::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyOpenhomeOrgTestBasic1Cpp::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyOpenhomeOrgTestBasic1Cpp::Version() const
 {
   return iCpProxy.Version();
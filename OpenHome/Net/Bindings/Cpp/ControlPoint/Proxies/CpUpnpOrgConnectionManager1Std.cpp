@@ -554,6 +554,11 @@ void CpProxyUpnpOrgConnectionManager1Cpp::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyUpnpOrgConnectionManager1Cpp::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyUpnpOrgConnectionManager1Cpp::Version() const
 {
   return iCpProxy.Version();
@@ -18,7 +18,7 @@ namespace OpenHome.Net.Device
         /// <summary>
         /// Must be called before writing any file data
         /// </summary>
-        /// <param name="aTotalBytes">Size in bytes of the file.  Can be 0 if size is unknown.</param>
+        /// <param name="aTotalBytes">Size in bytes of the file.  Can be 0 if size is unknown, in which case the file is streamed using chunked transfer encoding.</param>
         /// <param name="aMimeType">MIME type of the file.  May be NULL if this is unknown.</param>
         void WriteResourceBegin(int aTotalBytes, string aMimeType);
         /// <summary>
@@ -9,7 +9,8 @@ public interface IResourceWriter
 	/**
 	 * Must be called before writing any file data.
 	 * 
-	 * @param aTotalBytes	size in bytes of the file. Can be 0 if size is unknown.
+	 * @param aTotalBytes	size in bytes of the file. Can be 0 if size is unknown, in which
+	 *						case the file is streamed using chunked transfer encoding.
 	 * @param aMimeType		MIME type of the file. May be NULL if this is unknown.
 	 */
 	public void writeResourceBegin(int aTotalBytes, String aMimeType);
@@ -1,10 +1,38 @@
 #include <OpenHome/Net/Core/CpProxy.h>
 #include <OpenHome/Net/Private/CpiService.h>
+#include <OpenHome/Net/Private/CpiDevice.h>
+#include <OpenHome/Net/Private/CpiStack.h>
+#include <OpenHome/Net/Private/CpiSubscription.h>
 #include <OpenHome/Private/Thread.h>
 
 using namespace OpenHome;
 using namespace OpenHome::Net;
 
+namespace OpenHome {
+namespace Net {
+
+/**
+ * Passes the values Property::Write() gives the device stack's IPropertyWriter on to a
+ * client's IChangedPropertyWriter
+ */
+class ChangedPropertyWriter : public IPropertyWriter
+{
+public:
+    ChangedPropertyWriter(IChangedPropertyWriter& aWriter);
+private: // from IPropertyWriter
+    void PropertyWriteString(const Brx& aName, const Brx& aValue);
+    void PropertyWriteInt(const Brx& aName, TInt aValue);
+    void PropertyWriteUint(const Brx& aName, TUint aValue);
+    void PropertyWriteBool(const Brx& aName, TBool aValue);
+    void PropertyWriteBinary(const Brx& aName, const Brx& aValue);
+    void PropertyWriteEnd();
+private:
+    IChangedPropertyWriter& iWriter;
+};
+
+} // namespace Net
+} // namespace OpenHome
+
 // ProxyError
 
 ProxyError::ProxyError()
@@ -53,7 +81,7 @@ ProxyError& ProxyError::operator=(const ProxyError& aProxyError)
 
 void CpProxy::Subscribe()
 {
-    if (iProperties.size() == 0) {
+    if (iProperties->Count() == 0) {
         THROW(SubscriptionErrorUnrecoverable);
     }
     if (iInitialEventLock == NULL) {
@@ -75,16 +103,15 @@ void CpProxy::Unsubscribe()
     iService->Unsubscribe();
     iLock->Wait();
     iInitialEventDelivered = false;
-    PropertyMap::iterator it = iProperties.begin();
-    while (it != iProperties.end()) {
-        it->second->ResetSequenceNumber();
-        it++;
+    for (TUint i=0; i<iProperties->Count(); i++) {
+        iProperties->At(i).ResetSequenceNumber();
     }
     iLock->Signal();
 }
 
 CpProxy::CpProxy(const TChar* aDomain, const TChar* aName, TUint aVersion, CpiDevice& aDevice)
     : iInvocable(aDevice)
+    , iEventDispatcher(aDevice.GetCpStack().EventDispatcher())
 {
     iService = new CpiService(aDomain, aName, aVersion, aDevice);
     iCpSubscriptionStatus = eNotSubscribed;
@@ -93,6 +120,7 @@ CpProxy::CpProxy(const TChar* aDomain, const TChar* aName, TUint aVersion, CpiDe
     iPropertyWriteLock = new OpenHome::Mutex("PRX3");
     iInitialEventDelivered = false;
     iInitialEventLock = NULL;
+    iProperties = new CpiPropertyTable();
 }
 
 CpProxy::~CpProxy()
@@ -102,18 +130,15 @@ CpProxy::~CpProxy()
     delete iPropertyReadLock;
     delete iPropertyWriteLock;
     delete iInitialEventLock;
-    PropertyMap::iterator it = iProperties.begin();
-    while (it != iProperties.end()) {
-        delete it->second;
-        it++;
-    }
+    delete iProperties;
 }
 
 void CpProxy::AddProperty(Property* aProperty)
 {
     ASSERT(aProperty != NULL);
-    Brn name(aProperty->Parameter().Name());
-    iProperties.insert(std::pair<Brn,Property*>(name, aProperty));
+    iProperties->Add(aProperty);
+    iChangedProperties.reserve(iProperties->Count());
+    iStagedProperties.reserve(iProperties->Count());
 }
 
 void CpProxy::DestroyService()
@@ -139,6 +164,15 @@ void CpProxy::SetPropertyInitialEvent(Functor& aFunctor)
     iLock->Signal();
 }
 
+void CpProxy::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+    ChangedPropertyWriter writer(aWriter);
+    for (TUint i=0; i<(TUint)iChangedProperties.size(); i++) {
+        iChangedProperties[i]->Write(writer);
+    }
+    aWriter.PropertyWriteEnd();
+}
+
 TUint CpProxy::Version() const
 {
     return iService->Version();
@@ -163,53 +197,92 @@ void CpProxy::ReportEvent(Functor aFunctor)
 
 void CpProxy::EventUpdateStart()
 {
+    /* The write lock is held for the whole update so it is applied in one piece.  Values are
+       only staged as they're read; the read lock is claimed to commit them in EventUpdateEnd
+       so clients are never blocked while an update is being read. */
     iPropertyWriteLock->Wait();
-    iPropertyReadLock->Wait();
 }
 
 void CpProxy::EventUpdate(const Brx& aName, const Brx& aValue, IOutputProcessor& aProcessor)
 {
     if (iCpSubscriptionStatus != eNotSubscribed) {
-        Brn name(aName);
-        PropertyMap::iterator it = iProperties.find(name);
-        if (it != iProperties.end()) {
-            it->second->Process(aProcessor, aValue);
+        Property* property = iProperties->Find(aName);
+        if (property != NULL) {
+            if (!property->Staged()) {
+                iStagedProperties.push_back(property);
+            }
+            property->Stage(aProcessor, aValue);
         }
     }
 }
 
 void CpProxy::EventUpdateEnd()
 {
+    iPropertyReadLock->Wait();
+    for (TUint i=0; i<(TUint)iStagedProperties.size(); i++) {
+        iStagedProperties[i]->Commit();
+    }
     iPropertyReadLock->Signal();
-    TBool changed = false;
-    PropertyMap::iterator it = iProperties.begin();
-    while (it != iProperties.end()) {
-        changed = changed | it->second->ReportChanged();
-        it++;
-    }
-    if (changed || !iInitialEventDelivered) {
-        iLock->Wait();
-        if (iPropertyChanged) {
-            iPropertyChanged();
+    iStagedProperties.clear();
+    if (iEventDispatcher.Enabled()) {
+        // queue while still holding the write lock so EventUpdatePrepareForDelete can't miss it
+        iEventDispatcher.Queue(*this);
+    }
+    else {
+        CollectChanges();
+        ReportChanges();
+    }
+    iPropertyWriteLock->Signal();
+}
+
+void CpProxy::CollectChanges()
+{
+    iChangedProperties.clear();
+    for (TUint i=0; i<iProperties->Count(); i++) {
+        Property& property = iProperties->At(i);
+        if (property.ClearChanged()) {
+            iChangedProperties.push_back(&property);
         }
-        iLock->Signal();
-        if (!iInitialEventDelivered) {
-            iInitialEventDelivered = true;
-            iInitialEventLock->Wait();
-            if (iInitialEvent) {
-                iInitialEvent();
-            }
-            iInitialEventLock->Signal();
-            delete iInitialEventLock;
-            iInitialEventLock = NULL;
+    }
+}
+
+void CpProxy::ReportChanges()
+{
+    if (iChangedProperties.size() == 0 && iInitialEventDelivered) {
+        return;
+    }
+    for (TUint i=0; i<(TUint)iChangedProperties.size(); i++) {
+        iChangedProperties[i]->NotifyChanged();
+    }
+    ReportGroupChanged();
+}
+
+void CpProxy::ReportGroupChanged()
+{
+    iLock->Wait();
+    if (iPropertyChanged) {
+        iPropertyChanged();
+    }
+    iLock->Signal();
+    if (!iInitialEventDelivered) {
+        iInitialEventDelivered = true;
+        iInitialEventLock->Wait();
+        if (iInitialEvent) {
+            iInitialEvent();
         }
+        iInitialEventLock->Signal();
+        delete iInitialEventLock;
+        iInitialEventLock = NULL;
     }
-    iPropertyWriteLock->Signal();
 }
 
 void CpProxy::EventUpdateError()
 {
-    iPropertyReadLock->Signal();
+    // the subscription will be renewed, prompting an update with all properties' values
+    for (TUint i=0; i<(TUint)iStagedProperties.size(); i++) {
+        iStagedProperties[i]->DiscardStaged();
+    }
+    iStagedProperties.clear();
     iPropertyWriteLock->Signal();
 }
 
@@ -217,6 +290,18 @@ void CpProxy::EventUpdatePrepareForDelete()
 {
     iPropertyWriteLock->Wait();
     iPropertyWriteLock->Signal();
+    iEventDispatcher.Cancel(*this);
+}
+
+void CpProxy::EventDispatch()
+{
+    /* Only the changed flags are read, under the read lock that updates are committed
+       under.  Callbacks run without it so a slow client doesn't hold up the next update;
+       any values that change meanwhile will be reported by a further dispatch. */
+    iPropertyReadLock->Wait();
+    CollectChanges();
+    iPropertyReadLock->Signal();
+    ReportChanges();
 }
 
 CpiService& CpProxy::GetService() const
@@ -238,3 +323,41 @@ CpProxy::SubscriptionStatus CpProxy::GetSubscriptionStatus() const
 {
     return iCpSubscriptionStatus;
 }
+
+
+// ChangedPropertyWriter
+
+ChangedPropertyWriter::ChangedPropertyWriter(IChangedPropertyWriter& aWriter)
+    : iWriter(aWriter)
+{
+}
+
+void ChangedPropertyWriter::PropertyWriteString(const Brx& aName, const Brx& aValue)
+{
+    iWriter.PropertyWriteString(aName, aValue);
+}
+
+void ChangedPropertyWriter::PropertyWriteInt(const Brx& aName, TInt aValue)
+{
+    iWriter.PropertyWriteInt(aName, aValue);
+}
+
+void ChangedPropertyWriter::PropertyWriteUint(const Brx& aName, TUint aValue)
+{
+    iWriter.PropertyWriteUint(aName, aValue);
+}
+
+void ChangedPropertyWriter::PropertyWriteBool(const Brx& aName, TBool aValue)
+{
+    iWriter.PropertyWriteBool(aName, aValue);
+}
+
+void ChangedPropertyWriter::PropertyWriteBinary(const Brx& aName, const Brx& aValue)
+{
+    iWriter.PropertyWriteBinary(aName, aValue);
+}
+
+void ChangedPropertyWriter::PropertyWriteEnd()
+{
+    iWriter.PropertyWriteEnd();
+}
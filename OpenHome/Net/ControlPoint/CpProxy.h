@@ -6,16 +6,19 @@
 #include <OpenHome/Exception.h>
 #include <OpenHome/Buffer.h>
 
-#include <map>
+#include <vector>
 
 EXCEPTION(SubscriptionErrorUnrecoverable)
 EXCEPTION(ProxyNotSubscribed);
 
 namespace OpenHome {
 class Mutex;
+class Thread;
 namespace Net {
 
 class CpiDevice;
+class CpiEventDispatcher;
+class CpiPropertyTable;
 class CpiService;
 class IOutputProcessor;
 class IInvocable;
@@ -35,6 +38,27 @@ public:
     virtual ~IEventProcessor() {}
 };
 
+/**
+ * @internal
+ *
+ * Reports property changes applied by an earlier IEventProcessor update.
+ * Holds its own CpiEventDispatcher queue entry so that queueing never searches.
+ */
+class EventDispatchable
+{
+    friend class CpiEventDispatcher;
+public:
+    virtual void EventDispatch() = 0;
+protected:
+    EventDispatchable() : iDispatchQueued(false), iDispatchPrev(NULL), iDispatchNext(NULL), iDispatcher(NULL) {}
+    virtual ~EventDispatchable() {}
+private: // all guarded by CpiEventDispatcher's lock
+    TBool iDispatchQueued;
+    EventDispatchable* iDispatchPrev;
+    EventDispatchable* iDispatchNext;
+    Thread* iDispatcher; // non-NULL while being dispatched
+};
+
 /**
  * Thrown by Sync or End action invocations.
  */
@@ -55,6 +79,22 @@ private:
 #define THROW_PROXYERROR(level, code)   throw(ProxyError(__FILE__, __LINE__, (level), (code)))
 
 
+/**
+ * Receives the properties changed by an update.  Passed to CpProxy::WriteChangedProperties()
+ * @ingroup ControlPoint
+ */
+class IChangedPropertyWriter
+{
+public:
+    virtual void PropertyWriteString(const Brx& aName, const Brx& aValue) = 0;
+    virtual void PropertyWriteInt(const Brx& aName, TInt aValue) = 0;
+    virtual void PropertyWriteUint(const Brx& aName, TUint aValue) = 0;
+    virtual void PropertyWriteBool(const Brx& aName, TBool aValue) = 0;
+    virtual void PropertyWriteBinary(const Brx& aName, const Brx& aValue) = 0;
+    virtual void PropertyWriteEnd() = 0;
+    virtual ~IChangedPropertyWriter() {}
+};
+
 class ICpProxy
 {
 public:
@@ -66,6 +106,7 @@ public:
     virtual void AddProperty(Property* aProperty) = 0;
     virtual void DestroyService() = 0;
     virtual void ReportEvent(Functor aFunctor) = 0;
+    virtual void WriteChangedProperties(IChangedPropertyWriter& aWriter) const = 0;
     virtual TUint Version() const = 0;
 };
 
@@ -73,7 +114,7 @@ public:
  * Base class for all proxies
  * @ingroup ControlPoint
  */
-class DllExportClass CpProxy : public ICpProxy, private IEventProcessor
+class DllExportClass CpProxy : public ICpProxy, private IEventProcessor, private EventDispatchable
 {
 public:
     enum SubscriptionStatus
@@ -112,6 +153,19 @@ public: // from ICpProxy
      * @param[in]  aFunctor  The callback to be run
      */
     DllExport void SetPropertyInitialEvent(Functor& aFunctor);
+    /**
+     * Write the name and value of each property changed by the update being reported,
+     * followed by PropertyWriteEnd().
+     *
+     * Only meaningful from within a property change callback.  Values are passed
+     * directly from the properties (no copy is made) so are only valid for the
+     * duration of each aWriter call.
+     *
+     * Only available to C++ clients; the C, C#, Java and JavaScript bindings don't expose it.
+     *
+     * @param[in]  aWriter   Receives each changed property
+     */
+    DllExport void WriteChangedProperties(IChangedPropertyWriter& aWriter) const;
     /**
      * Query which service version the remote device implements.
      *
@@ -146,8 +200,13 @@ private: // IEventProcessor
     DllExport void EventUpdateEnd();
     DllExport void EventUpdateError();
     DllExport void EventUpdatePrepareForDelete();
+private: // EventDispatchable
+    void EventDispatch();
 private:
     void operator=(const CpProxy&);
+    void CollectChanges();
+    void ReportChanges();
+    void ReportGroupChanged();
 private: //gettable
     CpiService* iService;
     IInvocable& iInvocable;
@@ -157,11 +216,13 @@ private:
     Functor iPropertyChanged;
     TBool iInitialEventDelivered;
     Functor iInitialEvent;
-    typedef std::map<Brn,Property*,BufferCmp> PropertyMap;
-    PropertyMap iProperties;
+    CpiPropertyTable* iProperties;
     mutable Mutex* iPropertyReadLock;
     Mutex* iPropertyWriteLock;
     Mutex* iInitialEventLock;
+    CpiEventDispatcher& iEventDispatcher;
+    std::vector<Property*> iChangedProperties;
+    std::vector<Property*> iStagedProperties; // values read from the current update, not yet committed
 
     friend class CpProxyC;
 };
@@ -5,6 +5,7 @@
 #include <OpenHome/Private/Env.h>
 #include <OpenHome/Net/Private/CpiStack.h>
 #include <OpenHome/Private/Debug.h>
+#include <OpenHome/Private/Converter.h>
 #include <OpenHome/Net/Core/CpProxy.h>
 #include <OpenHome/Net/Private/Error.h>
 #include <OpenHome/Net/Private/CpiSubscription.h>
@@ -820,3 +821,69 @@ void InvocationManager::Run()
         }
     }
 }
+
+
+// CpiPropertyTable
+
+CpiPropertyTable::CpiPropertyTable()
+    : iMask(0)
+{
+}
+
+CpiPropertyTable::~CpiPropertyTable()
+{
+    for (TUint i=0; i<(TUint)iProperties.size(); i++) {
+        delete iProperties[i];
+    }
+}
+
+void CpiPropertyTable::Add(Property* aProperty)
+{
+    iProperties.push_back(aProperty);
+    iHashes.push_back(Converter::Fnv1a(aProperty->Parameter().Name()));
+    Rebuild();
+}
+
+Property* CpiPropertyTable::Find(const Brx& aName) const
+{
+    if (iSlots.size() == 0) {
+        return NULL;
+    }
+    const TUint32 hash = Converter::Fnv1a(aName);
+    for (TUint i = hash & iMask; iSlots[i] != kSlotEmpty; i = (i+1) & iMask) {
+        const TUint index = (TUint)iSlots[i];
+        if (iHashes[index] == hash && iProperties[index]->Parameter().Name() == aName) {
+            return iProperties[index];
+        }
+    }
+    return NULL;
+}
+
+TUint CpiPropertyTable::Count() const
+{
+    return (TUint)iProperties.size();
+}
+
+Property& CpiPropertyTable::At(TUint aIndex) const
+{
+    ASSERT(aIndex < iProperties.size());
+    return *iProperties[aIndex];
+}
+
+void CpiPropertyTable::Rebuild()
+{
+    // keep the table no more than half full so probe sequences stay short
+    TUint slots = 4;
+    while (slots < 2 * iProperties.size()) {
+        slots *= 2;
+    }
+    iSlots.assign(slots, kSlotEmpty);
+    iMask = slots - 1;
+    for (TUint i=0; i<(TUint)iProperties.size(); i++) {
+        TUint slot = iHashes[i] & iMask;
+        while (iSlots[slot] != kSlotEmpty) {
+            slot = (slot + 1) & iMask;
+        }
+        iSlots[slot] = (TInt)i;
+    }
+}
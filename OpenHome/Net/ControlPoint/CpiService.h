@@ -455,6 +455,32 @@ private:
     TBool iActive;
 };
 
+/**
+ * A proxy's properties, indexed by name for lookup of each evented value.
+ *
+ * Property names are fixed once a proxy is constructed so lookups use an open
+ * addressing table that is rebuilt as each property is added.  Iteration is in
+ * the order properties were added.  Owns the properties it is passed.
+ */
+class CpiPropertyTable : private INonCopyable
+{
+public:
+    CpiPropertyTable();
+    ~CpiPropertyTable();
+    void Add(Property* aProperty);
+    Property* Find(const Brx& aName) const; // NULL if aName isn't a known property
+    TUint Count() const;
+    Property& At(TUint aIndex) const;
+private:
+    void Rebuild();
+private:
+    static const TInt kSlotEmpty = -1;
+    std::vector<Property*> iProperties;
+    std::vector<TUint32> iHashes;
+    std::vector<TInt> iSlots;
+    TUint iMask;
+};
+
 } // namespace Net
 } // namespace OpenHome
 
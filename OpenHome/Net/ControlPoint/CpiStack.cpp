@@ -4,6 +4,8 @@
 #include <OpenHome/Net/Private/XmlFetcher.h>
 #include <OpenHome/Net/Private/CpiSubscription.h>
 #include <OpenHome/Net/Private/CpiDevice.h>
+#include <OpenHome/Net/Private/CpiDeviceCacheUpnp.h>
+#include <OpenHome/Net/Core/OhNet.h>
 #include <OpenHome/Private/Printer.h>
 
 using namespace OpenHome;
@@ -17,14 +19,24 @@ CpStack::CpStack(OpenHome::Environment& aStack)
     iEnv.SetCpStack(this);
     iInvocationManager = new OpenHome::Net::InvocationManager(*this);
     iXmlFetchManager = new OpenHome::Net::XmlFetchManager(*this);
+    iEventDispatcher = new CpiEventDispatcher(iEnv.InitParams()->NumEventDispatchThreads());
     iSubscriptionManager = new CpiSubscriptionManager(*this);
     iDeviceListUpdater = new CpiDeviceListUpdater();
+    const TChar* deviceCache;
+    if (iEnv.InitParams()->CpUpnpDeviceCacheEnabled(deviceCache)) {
+        iDeviceCacheUpnp = new CpiDeviceCacheUpnp(iEnv, deviceCache);
+    }
+    else {
+        iDeviceCacheUpnp = NULL;
+    }
 }
 
 CpStack::~CpStack()
 {
+    delete iDeviceCacheUpnp;
     delete iDeviceListUpdater;
     delete iSubscriptionManager;
+    delete iEventDispatcher;
     delete iXmlFetchManager;
     delete iInvocationManager;
 }
@@ -48,3 +60,13 @@ CpiDeviceListUpdater& CpStack::DeviceListUpdater()
 {
     return *iDeviceListUpdater;
 }
+
+CpiDeviceCacheUpnp* CpStack::DeviceCacheUpnp()
+{
+    return iDeviceCacheUpnp;
+}
+
+CpiEventDispatcher& CpStack::EventDispatcher()
+{
+    return *iEventDispatcher;
+}
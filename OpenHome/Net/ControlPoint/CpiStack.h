@@ -20,6 +20,8 @@ class InvocationManager;
 class XmlFetchManager;
 class CpiSubscriptionManager;
 class CpiDeviceListUpdater;
+class CpiDeviceCacheUpnp;
+class CpiEventDispatcher;
 
 class CpStack : public IStack, private INonCopyable
 {
@@ -30,6 +32,8 @@ public:
     OpenHome::Net::XmlFetchManager& XmlFetchManager();
     CpiSubscriptionManager& SubscriptionManager();
     CpiDeviceListUpdater& DeviceListUpdater();
+    CpiDeviceCacheUpnp* DeviceCacheUpnp(); // NULL if caching is disabled
+    CpiEventDispatcher& EventDispatcher();
 private:
     ~CpStack();
 private:
@@ -38,6 +42,8 @@ private:
     OpenHome::Net::XmlFetchManager* iXmlFetchManager;
     CpiSubscriptionManager* iSubscriptionManager;
     CpiDeviceListUpdater* iDeviceListUpdater;
+    CpiDeviceCacheUpnp* iDeviceCacheUpnp;
+    CpiEventDispatcher* iEventDispatcher;
 };
 
 } // namespace Net
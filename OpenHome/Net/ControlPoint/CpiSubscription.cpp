@@ -63,17 +63,65 @@ void CpiSubscription::RemoveRef()
 TBool CpiSubscription::UpdateSequenceNumber(TUint aSequenceNumber)
 {
     iLock.Wait();
-    if (aSequenceNumber != iNextSequenceNumber) {
+    const TUint expected = iNextSequenceNumber;
+    const TBool ok = CheckSequenceNumberLocked(aSequenceNumber);
+    iLock.Signal();
+    if (!ok) {
+        SequenceGap(expected, aSequenceNumber);
+    }
+    return ok;
+}
+
+TBool CpiSubscription::StartNotification(TUint aSequenceNumber)
+{
+    iLock.Wait();
+    const TUint expected = iNextSequenceNumber;
+    if (!CheckSequenceNumberLocked(aSequenceNumber)) {
         iLock.Signal();
+        SequenceGap(expected, aSequenceNumber);
         return false;
     }
-    iNextSequenceNumber++;
+    // apply updates in the order they passed the check above, even if they were read on different sessions
+    const TUint ticket = iNotificationNext++;
+    while (iNotificationServing != ticket) {
+        iNotificationWaiters++;
+        iLock.Signal();
+        iNotificationComplete.Wait();
+        iLock.Wait();
+    }
+    iLock.Signal();
     return true;
 }
 
-void CpiSubscription::Unlock()
+void CpiSubscription::EndNotification()
 {
-    iLock.Signal();
+    AutoMutex a(iLock);
+    iNotificationServing++;
+    for (; iNotificationWaiters > 0; iNotificationWaiters--) {
+        iNotificationComplete.Signal();
+    }
+}
+
+TBool CpiSubscription::NextSequenceNumber(TUint& aExpected, TUint aReceived)
+{ // static
+    if (aReceived != aExpected) {
+        return false;
+    }
+    // sequence numbers wrap to 1 rather than 0; 0 is reserved for the initial event
+    aExpected = (aExpected == UINT32_MAX? 1 : aExpected + 1);
+    return true;
+}
+
+TBool CpiSubscription::CheckSequenceNumberLocked(TUint aSequenceNumber)
+{
+    return NextSequenceNumber(iNextSequenceNumber, aSequenceNumber);
+}
+
+void CpiSubscription::SequenceGap(TUint aExpected, TUint aReceived)
+{
+    LOG2(kEvent, kError, "Sequence gap for subscription (%p) sid %.*s - expected %u, received %u\n",
+                         this, PBUF(iSid), aExpected, aReceived);
+    iCpStack.SubscriptionManager().NotifySequenceGap();
 }
 
 void CpiSubscription::SetNotificationError()
@@ -166,12 +214,20 @@ CpiSubscription::CpiSubscription(CpiDevice& aDevice, IEventProcessor& aEventProc
     , iCpStack(aDevice.GetCpStack())
     , iEnv(iCpStack.Env())
     , iEventProcessor(&aEventProcessor)
+    , iUpdateProcessor(NULL)
     , iServiceType(aServiceType)
     , iId(aId)
+    , iNotificationComplete("SUBN", 0)
+    , iNotificationNext(0)
+    , iNotificationServing(0)
+    , iNotificationWaiters(0)
     , iPendingOperation(eNone)
     , iRefCount(1)
     , iInterruptHandler(NULL)
     , iSuspended(false)
+    , iRenewTimerActive(false)
+    , iRenewBatchTime(0)
+    , iBatchNext(NULL)
 {
     iTimer = new Timer(iEnv, MakeFunctor(*this, &CpiSubscription::Renew), "CpiSubscription");
     iDevice.AddRef();
@@ -200,8 +256,14 @@ TBool CpiSubscription::StartSchedule(EOperation aOperation, TBool aRejectFutureO
 {
     Mutex& lock = iEnv.Mutex();
     lock.Wait();
+    TBool scheduled = StartScheduleLocked(aOperation, aRejectFutureOperations);
+    lock.Signal();
+    return scheduled;
+}
+
+TBool CpiSubscription::StartScheduleLocked(EOperation aOperation, TBool aRejectFutureOperations)
+{
     if (iRejectFutureOperations) {
-        lock.Signal();
         return false;
     }
     if (aRejectFutureOperations) {
@@ -209,7 +271,6 @@ TBool CpiSubscription::StartSchedule(EOperation aOperation, TBool aRejectFutureO
     }
     iRefCount++;
     iPendingOperation = aOperation;
-    lock.Signal();
     return true;
 }
 
@@ -262,7 +323,27 @@ void CpiSubscription::DoSubscribe()
 
 void CpiSubscription::Renew()
 {
-    Schedule(eRenew);
+    iCpStack.SubscriptionManager().ScheduleRenew(*this);
+}
+
+TBool CpiSubscription::StartRenew(TBool aEarly)
+{
+    /* Check and claim the renewal in one go.  Any other operation scheduled between the two
+       would otherwise be overwritten by eRenew (e.g. a resubscribe after a sequence gap). */
+    Mutex& lock = iEnv.Mutex();
+    lock.Wait();
+    if (!iRenewTimerActive || iPendingOperation != eNone ||
+        (aEarly && !Time::IsInPastOrNow(iEnv, iRenewBatchTime))) {
+        lock.Signal();
+        return false;
+    }
+    iRenewTimerActive = false;
+    TBool scheduled = StartScheduleLocked(eRenew, false);
+    lock.Signal();
+    if (scheduled && aEarly) {
+        iTimer->Cancel();
+    }
+    return scheduled;
 }
 
 void CpiSubscription::DoRenew()
@@ -309,7 +390,7 @@ void CpiSubscription::DoUnsubscribe()
     LOG(kEvent, "Unsubscribing (%p) sid %.*s\n", this, PBUF(iSid));
 
     const TUint startTime = Os::TimeInMs(iEnv.OsCtx());
-    iTimer->Cancel();
+    CancelRenewTimer();
     if (iSid.Bytes() == 0) {
         LOG(kEvent, "Skipped unsubscribing since sid is empty (we're not subscribed)\n");
         return;
@@ -345,9 +426,27 @@ void CpiSubscription::SetRenewTimer(TUint aMaxSeconds)
     const TUint randMin = (TUint)((maxSeconds*1000*3)/4);
     const TUint randMax = (TUint)((maxSeconds*1000)/2);
     TUint renewMs = iEnv.Random(randMin, randMax);
+    TUint batchWindowMs = (TUint)((maxSeconds*1000)/kRenewBatchWindowDivisor);
+    if (batchWindowMs > kMaxRenewBatchWindowMs) {
+        batchWindowMs = kMaxRenewBatchWindowMs;
+    }
+    Mutex& lock = iEnv.Mutex();
+    lock.Wait();
+    iRenewTimerActive = true;
+    iRenewBatchTime = Time::Now(iEnv) + renewMs - batchWindowMs;
+    lock.Signal();
     iTimer->FireIn(renewMs);
 }
 
+void CpiSubscription::CancelRenewTimer()
+{
+    iTimer->Cancel();
+    Mutex& lock = iEnv.Mutex();
+    lock.Wait();
+    iRenewTimerActive = false;
+    lock.Signal();
+}
+
 void CpiSubscription::Resubscribe()
 {
     EOperation op = iSuspended? eSubscribe : eResubscribe;
@@ -374,7 +473,7 @@ void CpiSubscription::NotifySubnetChanged()
 
 void CpiSubscription::Suspend()
 {
-    iTimer->Cancel();
+    CancelRenewTimer();
     iSuspended = true;
     if (StartSchedule(eUnsubscribe, false)) {
         iDevice.GetCpStack().SubscriptionManager().ScheduleLocked(*this);
@@ -386,24 +485,31 @@ TBool CpiSubscription::RemoveOnSubnetChange() const
     return iDevice.OrphanSubscriptionsOnSubnetChange();
 }
 
+/* Updates are read without iLock held.  It is only claimed to start an update so that
+   Unsubscribe() can't delete the processor first.  EventUpdatePrepareForDelete() then waits
+   for the update to end so the rest of it is passed to the same processor without iLock. */
+
 void CpiSubscription::EventUpdateStart()
 {
-    if (iEventProcessor != NULL) {
-        iEventProcessor->EventUpdateStart();
+    AutoMutex a(iLock);
+    iUpdateProcessor = iEventProcessor;
+    if (iUpdateProcessor != NULL) {
+        iUpdateProcessor->EventUpdateStart();
     }
 }
 
 void CpiSubscription::EventUpdate(const Brx& aName, const Brx& aValue, IOutputProcessor& aProcessor)
 {
-    if (iEventProcessor != NULL) {
-        iEventProcessor->EventUpdate(aName, aValue, aProcessor);
+    if (iUpdateProcessor != NULL) {
+        iUpdateProcessor->EventUpdate(aName, aValue, aProcessor);
     }
 }
 
 void CpiSubscription::EventUpdateEnd()
 {
-    if (iEventProcessor != NULL) {
-        iEventProcessor->EventUpdateEnd();
+    if (iUpdateProcessor != NULL) {
+        iUpdateProcessor->EventUpdateEnd();
+        iUpdateProcessor = NULL;
     }
 }
 
@@ -411,8 +517,9 @@ void CpiSubscription::EventUpdateError()
 {
     LOG2(kEvent, kError, "ERROR: subscription (%p) sid %.*s failure processing update\n", this, PBUF(iSid));
     SetNotificationError();
-    if (iEventProcessor != NULL) {
-        iEventProcessor->EventUpdateError();
+    if (iUpdateProcessor != NULL) {
+        iUpdateProcessor->EventUpdateError();
+        iUpdateProcessor = NULL;
     }
 }
 
@@ -484,33 +591,195 @@ void Subscriber::Run()
             }
             exit = true;
         }
-        try {
-            iSubscription->RunInSubscriber();
-        }
-        catch (HttpError&) {
-            Error("Http");
+        while (iSubscription != NULL) {
+            CpiSubscription* next = iSubscription->iBatchNext;
+            iSubscription->iBatchNext = NULL;
+            try {
+                iSubscription->RunInSubscriber();
+            }
+            catch (HttpError&) {
+                Error("Http");
+            }
+            catch (NetworkError&) {
+                Error("Network");
+            }
+            catch (NetworkTimeout&) {
+                Error("Timeout");
+            }
+            catch (WriterError&) {
+                Error("Writer");
+            }
+            catch (ReaderError&) {
+                Error("Reader");
+            }
+            catch (XmlError&) {
+                Error("XmlError");
+            }
+            iSubscription->RemoveRef();
+            iSubscription = next;
         }
-        catch (NetworkError&) {
-            Error("Network");
+        if (exit) {
+            break;
         }
-        catch (NetworkTimeout&) {
-            Error("Timeout");
+        iFree.Write(this);
+    }
+}
+
+
+// CpiEventDispatcher
+
+CpiEventDispatcher::CpiEventDispatcher(TUint aNumThreads)
+    : iLock("EVDL")
+    , iHead(NULL)
+    , iTail(NULL)
+    , iDispatchComplete("EVDC", 0)
+    , iCancelWaiters(0)
+{
+    for (TUint i=0; i<aNumThreads; i++) {
+        Bws<Thread::kMaxNameBytes+1> thName;
+        thName.AppendPrintf("EventDispatch %d", i);
+        thName.PtrZ();
+        Dispatcher* dispatcher = new Dispatcher((const TChar*)thName.Ptr(), *this);
+        iDispatchers.push_back(dispatcher);
+        iIdle.push_back(dispatcher);
+        dispatcher->Start();
+    }
+}
+
+CpiEventDispatcher::~CpiEventDispatcher()
+{
+    for (TUint i=0; i<(TUint)iDispatchers.size(); i++) {
+        delete iDispatchers[i];
+    }
+}
+
+TBool CpiEventDispatcher::Enabled() const
+{
+    return (iDispatchers.size() > 0);
+}
+
+void CpiEventDispatcher::Queue(EventDispatchable& aTarget)
+{
+    AutoMutex a(iLock);
+    if (aTarget.iDispatchQueued) {
+        return; // coalesce with the dispatch that's already pending
+    }
+    aTarget.iDispatchQueued = true;
+    if (aTarget.iDispatcher != NULL) {
+        return; // its current dispatcher will queue it again once it completes
+    }
+    Append(aTarget);
+    if (iIdle.size() > 0) {
+        Dispatcher* dispatcher = iIdle.back();
+        iIdle.pop_back();
+        dispatcher->Signal();
+    }
+}
+
+void CpiEventDispatcher::Cancel(EventDispatchable& aTarget)
+{
+    AutoMutex a(iLock);
+    if (aTarget.iDispatchQueued) {
+        aTarget.iDispatchQueued = false;
+        if (aTarget.iDispatcher == NULL) {
+            Remove(aTarget);
         }
-        catch (WriterError&) {
-            Error("Writer");
+    }
+    while (aTarget.iDispatcher != NULL) {
+        if (aTarget.iDispatcher == Thread::Current()) {
+            static_cast<Dispatcher*>(aTarget.iDispatcher)->iActive = NULL;
+            aTarget.iDispatcher = NULL;
+            return;
         }
-        catch (ReaderError&) {
-            Error("Reader");
+        iCancelWaiters++;
+        iLock.Signal();
+        iDispatchComplete.Wait();
+        iLock.Wait();
+    }
+}
+
+void CpiEventDispatcher::Dispatch(Dispatcher& aDispatcher)
+{
+    iLock.Wait();
+    while (iHead != NULL) {
+        EventDispatchable* target = iHead;
+        Remove(*target);
+        target->iDispatchQueued = false;
+        target->iDispatcher = &aDispatcher;
+        aDispatcher.iActive = target;
+        iLock.Signal();
+        target->EventDispatch();
+        iLock.Wait();
+        if (aDispatcher.iActive != NULL) {
+            target->iDispatcher = NULL;
+            if (target->iDispatchQueued) {
+                Append(*target);
+            }
+            aDispatcher.iActive = NULL;
         }
-        catch (XmlError&) {
-            Error("XmlError");
+        for (; iCancelWaiters > 0; iCancelWaiters--) {
+            iDispatchComplete.Signal();
         }
-        iSubscription->RemoveRef();
-        iSubscription = NULL;
-        if (exit) {
-            break;
+    }
+    iIdle.push_back(&aDispatcher);
+    iLock.Signal();
+}
+
+void CpiEventDispatcher::Append(EventDispatchable& aTarget)
+{
+    aTarget.iDispatchPrev = iTail;
+    aTarget.iDispatchNext = NULL;
+    if (iTail == NULL) {
+        iHead = &aTarget;
+    }
+    else {
+        iTail->iDispatchNext = &aTarget;
+    }
+    iTail = &aTarget;
+}
+
+void CpiEventDispatcher::Remove(EventDispatchable& aTarget)
+{
+    if (aTarget.iDispatchPrev == NULL) {
+        iHead = aTarget.iDispatchNext;
+    }
+    else {
+        aTarget.iDispatchPrev->iDispatchNext = aTarget.iDispatchNext;
+    }
+    if (aTarget.iDispatchNext == NULL) {
+        iTail = aTarget.iDispatchPrev;
+    }
+    else {
+        aTarget.iDispatchNext->iDispatchPrev = aTarget.iDispatchPrev;
+    }
+    aTarget.iDispatchPrev = NULL;
+    aTarget.iDispatchNext = NULL;
+}
+
+// CpiEventDispatcher::Dispatcher
+
+CpiEventDispatcher::Dispatcher::Dispatcher(const TChar* aName, CpiEventDispatcher& aOwner)
+    : Thread(aName)
+    , iActive(NULL)
+    , iOwner(aOwner)
+{
+}
+
+CpiEventDispatcher::Dispatcher::~Dispatcher()
+{
+    Kill();
+    Join();
+}
+
+void CpiEventDispatcher::Dispatcher::Run()
+{
+    try {
+        for (;;) {
+            Wait();
+            iOwner.Dispatch(*this);
         }
-        iFree.Write(this);
+    }
+    catch (ThreadKill&) {
     }
 }
 
@@ -526,6 +795,8 @@ CpiSubscriptionManager::CpiSubscriptionManager(CpStack& aCpStack)
     , iShutdownSem("SBMS", 0)
     , iInterface(0)
     , iNextSubscriptionId(1)
+    , iSequenceGaps(0)
+    , iBatchedRenewals(0)
 {
     NetworkAdapterList& ifList = iCpStack.Env().NetworkAdapterList();
     AutoNetworkAdapterRef ref(aCpStack.Env(), "CpiSubscriptionManager ctor");
@@ -674,6 +945,32 @@ void CpiSubscriptionManager::ScheduleLocked(CpiSubscription& aSubscription)
     Signal();
 }
 
+void CpiSubscriptionManager::ScheduleRenew(CpiSubscription& aSubscription)
+{
+    AutoMutex a(iLock);
+    if (!aSubscription.StartRenew(false)) {
+        return;
+    }
+    /* Pull forward any other renewals for this device that are nearly due so that they're
+       processed together rather than each waking a Subscriber at a slightly different time */
+    CpiSubscription* last = &aSubscription;
+    TUint count = 1;
+    for (std::map<TUint,CpiSubscription*>::iterator it=iMap.begin(); it!=iMap.end() && count<kMaxRenewBatchSize; ++it) {
+        CpiSubscription* subscription = it->second;
+        if (subscription != &aSubscription && &subscription->iDevice == &aSubscription.iDevice && subscription->StartRenew(true)) {
+            last->iBatchNext = subscription;
+            last = subscription;
+            count++;
+        }
+    }
+    iBatchedRenewals += count - 1;
+    if (count > 1) {
+        const Brx& udn = aSubscription.iDevice.Udn();
+        LOG(kEvent, "Renewing %u subscriptions for device %.*s together\n", count, PBUF(udn));
+    }
+    ScheduleLocked(aSubscription);
+}
+
 TUint CpiSubscriptionManager::EventServerPort()
 {
     AutoMutex a(iLock);
@@ -694,6 +991,24 @@ void CpiSubscriptionManager::RenewAll()
     }
 }
 
+void CpiSubscriptionManager::NotifySequenceGap()
+{
+    AutoMutex a(iLock);
+    iSequenceGaps++;
+}
+
+TUint CpiSubscriptionManager::SequenceGapCount()
+{
+    AutoMutex a(iLock);
+    return iSequenceGaps;
+}
+
+TUint CpiSubscriptionManager::BatchedRenewalCount()
+{
+    AutoMutex a(iLock);
+    return iBatchedRenewals;
+}
+
 void CpiSubscriptionManager::NotifySuspended()
 {
     AutoMutex a(iLock);
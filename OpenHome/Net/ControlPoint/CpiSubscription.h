@@ -61,10 +61,27 @@ public:
      * Used by the comms thread which receives updates on the state of properties.
      * Assumes that updates are incrementally numbered and returns false if
      * aSequenceNumber suggests that previous updates may have been missed.
-     * Locks subscription iff true is returned.
+     * Callers should resync by calling SetNotificationError() if false is returned.
      */
     TBool UpdateSequenceNumber(TUint aSequenceNumber);
 
+    /**
+     * As UpdateSequenceNumber() but, if true is returned, also waits until any updates
+     * that passed the check earlier have completed.  Allows updates to be read and
+     * applied without holding the subscription locked.
+     * Callers must call EndNotification() iff true is returned.
+     */
+    TBool StartNotification(TUint aSequenceNumber);
+    void EndNotification();
+
+    /**
+     * Returns true and moves aExpected on to the following sequence number iff aReceived
+     * matches it.  Sequence numbers wrap from UINT32_MAX to 1; 0 is only used for the
+     * initial event.
+     * Intended for internal use only
+     */
+    static TBool NextSequenceNumber(TUint& aExpected, TUint aReceived);
+
     /**
      * Inform the subscription of an error in processing an update.
      * Occurence of any error risks one or more properties having the wrong value.
@@ -101,12 +118,6 @@ public:
      * Intended for internal use only
      */
     void RunInSubscriber();
-
-    /**
-     * Used by event processing threads to serialise handling of updates to a particular subscription.
-     * Intended for internal use only
-     */
-    void Unlock();
 private:
     enum EOperation
     {
@@ -131,11 +142,20 @@ private:
      */
     void Schedule(EOperation aOperation, TBool aRejectFutureOperations = false);
     TBool StartSchedule(EOperation aOperation, TBool aRejectFutureOperations);
+    TBool StartScheduleLocked(EOperation aOperation, TBool aRejectFutureOperations);
     void DoSubscribe();
     void Renew();
     void DoRenew();
     void DoUnsubscribe();
     void SetRenewTimer(TUint aMaxSeconds);
+    void CancelRenewTimer();
+    TBool CheckSequenceNumberLocked(TUint aSequenceNumber);
+    void SequenceGap(TUint aExpected, TUint aReceived);
+    /**
+     * Claim a renew operation.  aEarly indicates the renewal is being brought forward to
+     * join a batch for the same device.  This only succeeds if the renewal is due soon.
+     */
+    TBool StartRenew(TBool aEarly);
     void Resubscribe();
     void NotifySubnetChanged();
     void Suspend();
@@ -148,6 +168,9 @@ private: // IEventProcessor
     void EventUpdatePrepareForDelete();
 private: // from IStackObject
     void ListObjectDetails() const;
+private:
+    static const TUint kRenewBatchWindowDivisor = 8; // may renew up to 1/8 of the duration early
+    static const TUint kMaxRenewBatchWindowMs = 60 * 1000;
 private:
     OpenHome::Mutex iLock;
     OpenHome::Mutex iSubscriberLock;
@@ -156,18 +179,27 @@ private:
     CpStack& iCpStack;
     Environment& iEnv;
     IEventProcessor* iEventProcessor;
+    IEventProcessor* iUpdateProcessor; // processor for the update in progress
     OpenHome::Net::ServiceType iServiceType;
     TUint iId;
     Brh iSid;
     Timer* iTimer;
     TUint iNextSequenceNumber;
+    Semaphore iNotificationComplete;
+    TUint iNotificationNext;    // ticket given to the next update to pass its sequence check
+    TUint iNotificationServing; // ticket of the update currently being applied
+    TUint iNotificationWaiters;
     EOperation iPendingOperation;
     TUint iRefCount;
     IInterruptHandler* iInterruptHandler;
     TBool iRejectFutureOperations;
     TBool iSuspended;
+    TBool iRenewTimerActive;
+    TUint iRenewBatchTime; // renewal can be brought forward to join a batch from this time
+    CpiSubscription* iBatchNext; // next subscription to be processed by the same Subscriber
 
     friend class CpiSubscriptionManager;
+    friend class Subscriber;
 };
 
 /**
@@ -175,6 +207,7 @@ private:
  *
  * Subscribe, renew (subscription) and unsubscribe are handled in these threads.
  * Notification of state variable changes are handled separately (e.g. EventSessionUpnp for UPnP)
+ * Batched renewals for a device are processed one after another by a single thread.
  *
  * Intended for internal use only
  */
@@ -194,6 +227,51 @@ private:
 
 class PendingSubscription;
 
+/**
+ * Runs proxy change callbacks on a pool of threads, away from the event sessions which
+ * apply updates.  Each target is queued at most once; updates which arrive while it is
+ * queued are reported together by a single dispatch.  A target is never dispatched by
+ * more than one thread at a time.
+ */
+class CpiEventDispatcher : private INonCopyable
+{
+public:
+    CpiEventDispatcher(TUint aNumThreads);
+    ~CpiEventDispatcher();
+    TBool Enabled() const; // false => callbacks should be run inline
+    void Queue(EventDispatchable& aTarget);
+    /**
+     * Remove any queued dispatch for aTarget, waiting for one in progress to complete.
+     * Doesn't wait if called from aTarget's own dispatch.
+     */
+    void Cancel(EventDispatchable& aTarget);
+private:
+    class Dispatcher : public Thread
+    {
+    public:
+        Dispatcher(const TChar* aName, CpiEventDispatcher& aOwner);
+        ~Dispatcher();
+    private:
+        void Run();
+    public:
+        EventDispatchable* iActive; // cleared if the target cancels itself from its own dispatch
+    private:
+        CpiEventDispatcher& iOwner;
+    };
+private:
+    void Dispatch(Dispatcher& aDispatcher);
+    void Append(EventDispatchable& aTarget);
+    void Remove(EventDispatchable& aTarget);
+private:
+    Mutex iLock;
+    EventDispatchable* iHead;
+    EventDispatchable* iTail;
+    std::vector<Dispatcher*> iDispatchers;
+    std::vector<Dispatcher*> iIdle;
+    Semaphore iDispatchComplete;
+    TUint iCancelWaiters;
+};
+
 /**
  * Singleton which manages the pools of Subscriber and active Subscription instances
  */
@@ -217,8 +295,17 @@ public:
     void Remove(CpiSubscription& aSubscription);
     void Schedule(CpiSubscription& aSubscription);
     void ScheduleLocked(CpiSubscription& aSubscription);
+    /**
+     * Schedule renewal of aSubscription, batched with any other subscriptions to the same
+     * device whose renewals are due soon.
+     */
+    void ScheduleRenew(CpiSubscription& aSubscription);
     TUint EventServerPort();
     void RenewAll();
+    void NotifySequenceGap();
+    TUint SequenceGapCount(); // number of notifications received out of sequence
+    TUint BatchedRenewalCount(); // number of renewals brought forward to join another's batch
+
 private: // from ISuspendObserver
     void NotifySuspended();
 private: // from IResumeObserver
@@ -240,6 +327,8 @@ private:
     TBool ReadyForShutdown() const;
     void ShutdownHasHung();
     void Run();
+private:
+    static const TUint kMaxRenewBatchSize = 4; // limits how long one slow renewal can delay the rest of its batch
 private:
     CpStack& iCpStack;
     OpenHome::Mutex iLock;
@@ -256,6 +345,8 @@ private:
     TUint iInterface;
     TUint iSubnetListenerId;
     TUint iNextSubscriptionId;
+    TUint iSequenceGaps;
+    TUint iBatchedRenewals;
 };
 
 } // namespace Net
@@ -159,7 +159,6 @@ IPropertyWriter* CpiDeviceDv::ClaimWriter(const IDviSubscriptionUserData* /*aUse
         subscription->iCp->SetNotificationError();
         return NULL;
     }
-    subscription->iCp->Unlock();
     return new PropertyWriterDv(*(subscription->iCp));
 }
 
@@ -174,7 +173,7 @@ void CpiDeviceDv::NotifySubscriptionCreated(const Brx& /*aSid*/)
 
 void CpiDeviceDv::NotifySubscriptionDeleted(const Brx& aSid)
 {
-    AutoMutex _(iLock);
+    iLock.Wait();
     Brn sid(aSid);
     SubscriptionMap::iterator it = iSubscriptions.find(sid);
     ASSERT(it != iSubscriptions.end());
@@ -183,7 +182,9 @@ void CpiDeviceDv::NotifySubscriptionDeleted(const Brx& aSid)
     if (iSubscriptions.size() == 0) {
         iShutdownSem.Signal(); // unblock shutdown now we have no subscriptions that may be trying to event out updates
     }
-    iDeviceCp->RemoveRef();
+    CpiDevice* device = iDeviceCp;
+    iLock.Signal();
+    device->RemoveRef(); // may delete this if it releases the last reference
 }
 
 void CpiDeviceDv::NotifySubscriptionExpired(const Brx& /*aSid*/)
@@ -345,6 +346,7 @@ void InvocationDv::InvocationWriteBinaryStart(const TChar* aName)
     ASSERT(iWriteArg == NULL);
     iWriteArg = OutputArgument(aName);
     ASSERT(static_cast<ArgumentBinary*>(iWriteArg)->Value().Bytes() == 0);
+    iWriteBuffer.SetBytes(0);
 }
 
 void InvocationDv::InvocationWriteBinary(TByte aValue)
@@ -368,6 +370,7 @@ void InvocationDv::InvocationWriteStringStart(const TChar* aName)
     ASSERT(iWriteArg == NULL);
     iWriteArg = OutputArgument(aName);
     ASSERT(static_cast<ArgumentString*>(iWriteArg)->Value().Bytes() == 0);
+    iWriteBuffer.SetBytes(0);
 }
 
 void InvocationDv::InvocationWriteString(TByte aValue)
@@ -379,12 +382,24 @@ void InvocationDv::InvocationWriteString(TByte aValue)
 void InvocationDv::InvocationWriteString(const Brx& aValue)
 {
     ASSERT(iWriteArg != NULL);
-    OutputProcessorDv procDv;
-    iWriteArg->ProcessOutput(procDv, aValue);
+    // grow geometrically, always leaving room for the nul terminator strings require
+    const TUint bytes = iWriteBuffer.Bytes() + aValue.Bytes();
+    if (iWriteBuffer.Ptr() == NULL || bytes >= iWriteBuffer.MaxBytes()) {
+        TUint maxBytes = (iWriteBuffer.Ptr() == NULL? kMinWriteBytes : 2 * iWriteBuffer.MaxBytes());
+        if (maxBytes <= bytes) {
+            maxBytes = bytes + 1;
+        }
+        iWriteBuffer.Grow(maxBytes);
+    }
+    iWriteBuffer.Append(aValue);
 }
 
 void InvocationDv::InvocationWriteStringEnd(const TChar* /*aName*/)
 {
+    if (iWriteBuffer.Bytes() > 0) {
+        OutputProcessorDvTransfer procDv(iWriteBuffer);
+        iWriteArg->ProcessOutput(procDv, iWriteBuffer);
+    }
     iWriteArg = NULL;
 }
 
@@ -521,3 +536,36 @@ void OutputProcessorDv::ProcessBinary(const Brx& aBuffer, Brh& aVal)
     tmp.Append(aBuffer);
     tmp.TransferTo(aVal);
 }
+
+
+// OutputProcessorDvTransfer
+
+OutputProcessorDvTransfer::OutputProcessorDvTransfer(Bwh& aBuffer)
+    : iBuffer(aBuffer)
+{
+}
+
+void OutputProcessorDvTransfer::ProcessString(const Brx& /*aBuffer*/, Brhz& aVal)
+{
+    iBuffer.TransferTo(aVal);
+}
+
+void OutputProcessorDvTransfer::ProcessInt(const Brx& /*aBuffer*/, TInt& /*aVal*/)
+{
+    ASSERTS();
+}
+
+void OutputProcessorDvTransfer::ProcessUint(const Brx& /*aBuffer*/, TUint& /*aVal*/)
+{
+    ASSERTS();
+}
+
+void OutputProcessorDvTransfer::ProcessBool(const Brx& /*aBuffer*/, TBool& /*aVal*/)
+{
+    ASSERTS();
+}
+
+void OutputProcessorDvTransfer::ProcessBinary(const Brx& /*aBuffer*/, Brh& aVal)
+{
+    iBuffer.TransferTo(aVal);
+}
@@ -116,11 +116,13 @@ private:
     OpenHome::Net::Argument* Argument(const TChar* aName, const Invocation::VectorArguments& aVector, TUint& aIndex);
     void GetNextIndex(TUint& aIndex, const Invocation::VectorArguments& aVector);
 private:
+    static const TUint kMinWriteBytes = 64;
     Invocation& iInvocation;
     DviService& iService;
     TUint iReadIndex;
     TUint iWriteIndex;
     OpenHome::Net::Argument* iWriteArg; // used for binary & string writing only
+    Bwh iWriteBuffer; // binary or string output, passed to iWriteArg without copying once complete
 };
 
 class PropertyWriterDv : public IPropertyWriter, private INonCopyable
@@ -151,6 +153,23 @@ private: // IOutputProcessor
     void ProcessBinary(const Brx& aBuffer, Brh& aVal);
 };
 
+/**
+ * Passes ownership of a complete string or binary output to an Argument
+ */
+class OutputProcessorDvTransfer : public IOutputProcessor, private INonCopyable
+{
+public:
+    OutputProcessorDvTransfer(Bwh& aBuffer);
+private: // IOutputProcessor
+    void ProcessString(const Brx& aBuffer, Brhz& aVal);
+    void ProcessInt(const Brx& aBuffer, TInt& aVal);
+    void ProcessUint(const Brx& aBuffer, TUint& aVal);
+    void ProcessBool(const Brx& aBuffer, TBool& aVal);
+    void ProcessBinary(const Brx& aBuffer, Brh& aVal);
+private:
+    Bwh& iBuffer;
+};
+
 } // namespace Net
 } // namespace OpenHome
 
@@ -207,7 +207,6 @@ void CpiDeviceLpec::HandleEventedUpdate(const Brx& aUpdate)
         LOG2(kLpec, kError, "LPEC: Invalid evented update - %.*s\n", PBUF(aUpdate));
         processor->EventUpdateError();
     }
-    subscription->Unlock();
     subscription->RemoveRef();
 }
 
@@ -1352,6 +1352,11 @@ void CpProxyAvOpenhomeOrgProduct1::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyAvOpenhomeOrgProduct1::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyAvOpenhomeOrgProduct1::Version() const
 {
   return iCpProxy.Version();
@@ -497,6 +497,11 @@ void CpProxyAvOpenhomeOrgSender1::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyAvOpenhomeOrgSender1::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyAvOpenhomeOrgSender1::Version() const
 {
   return iCpProxy.Version();
@@ -336,6 +336,11 @@ void CpProxyOpenhomeOrgSubscriptionLongPoll1::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyOpenhomeOrgSubscriptionLongPoll1::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyOpenhomeOrgSubscriptionLongPoll1::Version() const
 {
   return iCpProxy.Version();
@@ -1528,6 +1528,11 @@ void CpProxyOpenhomeOrgTestBasic1::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyOpenhomeOrgTestBasic1::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyOpenhomeOrgTestBasic1::Version() const
 {
   return iCpProxy.Version();
@@ -530,6 +530,11 @@ void CpProxyUpnpOrgConnectionManager1::ReportEvent(Functor aFunctor)
   iCpProxy.ReportEvent(aFunctor);
 }
 
+void CpProxyUpnpOrgConnectionManager1::WriteChangedProperties(IChangedPropertyWriter& aWriter) const
+{
+  iCpProxy.WriteChangedProperties(aWriter);
+}
+
 TUint CpProxyUpnpOrgConnectionManager1::Version() const
 {
   return iCpProxy.Version();
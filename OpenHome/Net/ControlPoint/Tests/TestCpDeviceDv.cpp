@@ -7,7 +7,15 @@
 #include <OpenHome/Private/Env.h>
 #include <OpenHome/Net/Private/DviStack.h>
 #include <OpenHome/Private/NetworkAdapterList.h>
+#include <OpenHome/Net/Private/Service.h>
+#include <OpenHome/Net/Private/CpiStack.h>
+#include <OpenHome/Net/Private/CpiSubscription.h>
+#include <OpenHome/Net/Private/ProtocolUpnp.h>
+#include <OpenHome/Net/Private/CpiDeviceCacheUpnp.h>
+#include <OpenHome/Private/File.h>
+#include <OpenHome/Private/Stream.h>
 
+#include <cstdio>
 #include <vector>
 
 using namespace OpenHome;
@@ -300,6 +308,15 @@ static void TestInvocation(CpDevice& aDevice)
         proxy->SyncEchoString(valStr, result);
         ASSERT(result == valStr);
     }
+    Bwh longStr(4 * 1024);
+    while (longStr.Bytes() < longStr.MaxBytes()) {
+        longStr.Append((TByte)('a' + (longStr.Bytes() % 26)));
+    }
+    for (i=0; i<kTestIterations; i++) {
+        Brh result;
+        proxy->SyncEchoString(longStr, result);
+        ASSERT(result == longStr);
+    }
 
     Print("    Binary arguments...\n");
     char bin[256];
@@ -436,6 +453,864 @@ static void TestSubscription(CpDevice& aDevice)
     delete proxy; // automatically unsubscribes
 }
 
+class ChangedPropertyRecorder : public IChangedPropertyWriter
+{
+public:
+    ChangedPropertyRecorder(CpProxyOpenhomeOrgTestBasic1& aProxy);
+    void Changed();
+    Semaphore iSem;
+    std::vector<Brh*> iNames;
+    TUint iUint;
+    TBool iEnded;
+private: // from IChangedPropertyWriter
+    void PropertyWriteString(const Brx& aName, const Brx& aValue);
+    void PropertyWriteInt(const Brx& aName, TInt aValue);
+    void PropertyWriteUint(const Brx& aName, TUint aValue);
+    void PropertyWriteBool(const Brx& aName, TBool aValue);
+    void PropertyWriteBinary(const Brx& aName, const Brx& aValue);
+    void PropertyWriteEnd();
+    void Add(const Brx& aName);
+private:
+    CpProxyOpenhomeOrgTestBasic1& iProxy;
+};
+
+ChangedPropertyRecorder::ChangedPropertyRecorder(CpProxyOpenhomeOrgTestBasic1& aProxy)
+    : iSem("TCPR", 0)
+    , iUint(0)
+    , iEnded(false)
+    , iProxy(aProxy)
+{
+}
+
+void ChangedPropertyRecorder::Changed()
+{
+    for (TUint i=0; i<(TUint)iNames.size(); i++) {
+        delete iNames[i];
+    }
+    iNames.clear();
+    iEnded = false;
+    iProxy.WriteChangedProperties(*this);
+    iSem.Signal();
+}
+
+void ChangedPropertyRecorder::PropertyWriteString(const Brx& aName, const Brx& /*aValue*/)
+{
+    Add(aName);
+}
+
+void ChangedPropertyRecorder::PropertyWriteInt(const Brx& aName, TInt /*aValue*/)
+{
+    Add(aName);
+}
+
+void ChangedPropertyRecorder::PropertyWriteUint(const Brx& aName, TUint aValue)
+{
+    Add(aName);
+    iUint = aValue;
+}
+
+void ChangedPropertyRecorder::PropertyWriteBool(const Brx& aName, TBool /*aValue*/)
+{
+    Add(aName);
+}
+
+void ChangedPropertyRecorder::PropertyWriteBinary(const Brx& aName, const Brx& /*aValue*/)
+{
+    Add(aName);
+}
+
+void ChangedPropertyRecorder::PropertyWriteEnd()
+{
+    iEnded = true;
+}
+
+void ChangedPropertyRecorder::Add(const Brx& aName)
+{
+    iNames.push_back(new Brh(aName));
+}
+
+static void TestChangedProperties(CpDevice& aDevice)
+{
+    Print("  Changed properties\n");
+    CpProxyOpenhomeOrgTestBasic1* proxy = new CpProxyOpenhomeOrgTestBasic1(aDevice);
+    ChangedPropertyRecorder recorder(*proxy);
+    Functor functor = MakeFunctor(recorder, &ChangedPropertyRecorder::Changed);
+    proxy->SetPropertyChanged(functor);
+    proxy->Subscribe();
+    recorder.iSem.Wait(); // initial event reports every property
+    ASSERT(recorder.iEnded);
+    ASSERT(recorder.iNames.size() == 5);
+
+    TUint val;
+    proxy->SyncGetUint(val);
+    proxy->SyncSetUint(val+1);
+    recorder.iSem.Wait();
+    ASSERT(recorder.iNames.size() == 1);
+    ASSERT(*recorder.iNames[0] == Brn("VarUint"));
+    ASSERT(recorder.iUint == val+1);
+
+    delete proxy;
+    for (TUint i=0; i<(TUint)recorder.iNames.size(); i++) {
+        delete recorder.iNames[i];
+    }
+}
+
+static void TestStagedValues()
+{
+    Print("  Staged values\n");
+    OutputProcessorUpnp processor;
+    PropertyUint propUint(new ParameterUint("Uint"));
+    propUint.Stage(processor, Brn("5"));
+    TEST(propUint.Staged());
+    TEST_THROWS(propUint.Value(), PropertyError); // staging doesn't apply a value
+    propUint.Commit();
+    TEST(!propUint.Staged());
+    TEST(propUint.Value() == 5);
+    TEST(propUint.ClearChanged());
+    propUint.Stage(processor, Brn("6"));
+    propUint.DiscardStaged();
+    propUint.Commit();
+    TEST(propUint.Value() == 5);
+    TEST(!propUint.ClearChanged());
+    propUint.Stage(processor, Brn("5"));
+    propUint.Commit();
+    TEST(!propUint.ClearChanged()); // same value as before
+
+    PropertyString propStr(new ParameterString("Str"));
+    propStr.Stage(processor, Brn("a &amp; b"));
+    propStr.Commit();
+    TEST(propStr.Value() == Brn("a & b"));
+    TEST(propStr.ClearChanged());
+    propStr.Stage(processor, Brn("c"));
+    TEST(propStr.Value() == Brn("a & b"));
+    propStr.Commit();
+    TEST(propStr.Value() == Brn("c"));
+    TEST(propStr.ClearChanged());
+}
+
+class DispatchTarget : public EventDispatchable
+{
+public:
+    DispatchTarget(Semaphore& aDispatched);
+    void Block(); // next dispatch waits until Release() is called
+    void WaitBlocked();
+    void Release();
+    TUint Count() const;
+    TUint MaxConcurrent() const;
+private: // from EventDispatchable
+    void EventDispatch();
+private:
+    mutable Mutex iLock;
+    Semaphore& iDispatched;
+    Semaphore iBlocked;
+    Semaphore iRelease;
+    TBool iBlock;
+    TUint iCount;
+    TUint iConcurrent;
+    TUint iMaxConcurrent;
+};
+
+DispatchTarget::DispatchTarget(Semaphore& aDispatched)
+    : iLock("TDTL")
+    , iDispatched(aDispatched)
+    , iBlocked("TDT1", 0)
+    , iRelease("TDT2", 0)
+    , iBlock(false)
+    , iCount(0)
+    , iConcurrent(0)
+    , iMaxConcurrent(0)
+{
+}
+
+void DispatchTarget::Block()
+{
+    AutoMutex a(iLock);
+    iBlock = true;
+}
+
+void DispatchTarget::WaitBlocked()
+{
+    iBlocked.Wait();
+}
+
+void DispatchTarget::Release()
+{
+    iRelease.Signal();
+}
+
+TUint DispatchTarget::Count() const
+{
+    AutoMutex a(iLock);
+    return iCount;
+}
+
+TUint DispatchTarget::MaxConcurrent() const
+{
+    AutoMutex a(iLock);
+    return iMaxConcurrent;
+}
+
+void DispatchTarget::EventDispatch()
+{
+    iLock.Wait();
+    iCount++;
+    if (++iConcurrent > iMaxConcurrent) {
+        iMaxConcurrent = iConcurrent;
+    }
+    const TBool block = iBlock;
+    iBlock = false;
+    iLock.Signal();
+    if (block) {
+        iBlocked.Signal();
+        iRelease.Wait();
+    }
+    iLock.Wait();
+    iConcurrent--;
+    iLock.Signal();
+    iDispatched.Signal();
+}
+
+class DispatchCanceller
+{
+public:
+    DispatchCanceller(CpiEventDispatcher& aDispatcher, EventDispatchable& aTarget);
+    ~DispatchCanceller();
+    TBool Cancelled(TUint aTimeoutMs);
+private:
+    void Run();
+private:
+    CpiEventDispatcher& iDispatcher;
+    EventDispatchable& iTarget;
+    Semaphore iCancelled;
+    ThreadFunctor* iThread;
+};
+
+DispatchCanceller::DispatchCanceller(CpiEventDispatcher& aDispatcher, EventDispatchable& aTarget)
+    : iDispatcher(aDispatcher)
+    , iTarget(aTarget)
+    , iCancelled("TDCS", 0)
+{
+    iThread = new ThreadFunctor("TDCT", MakeFunctor(*this, &DispatchCanceller::Run));
+    iThread->Start();
+}
+
+DispatchCanceller::~DispatchCanceller()
+{
+    delete iThread;
+}
+
+TBool DispatchCanceller::Cancelled(TUint aTimeoutMs)
+{
+    try {
+        iCancelled.Wait(aTimeoutMs);
+    }
+    catch (Timeout&) {
+        return false;
+    }
+    return true;
+}
+
+void DispatchCanceller::Run()
+{
+    iDispatcher.Cancel(iTarget);
+    iCancelled.Signal();
+}
+
+static void TestEventDispatcher()
+{
+    Print("  Event dispatcher\n");
+    static const TUint kWaitMs = 100;
+    Semaphore dispatched("TEDS", 0);
+    DispatchTarget a(dispatched);
+    DispatchTarget b(dispatched);
+    DispatchTarget c(dispatched);
+    {
+        CpiEventDispatcher dispatcher(1);
+
+        // updates queued while the only dispatcher is busy are coalesced
+        a.Block();
+        dispatcher.Queue(a);
+        a.WaitBlocked();
+        dispatcher.Queue(b);
+        dispatcher.Queue(b);
+        dispatcher.Queue(a);
+        dispatcher.Queue(a);
+        dispatcher.Queue(c);
+        a.Release();
+        for (TUint i=0; i<4; i++) {
+            dispatched.Wait();
+        }
+        ASSERT(a.Count() == 2);
+        ASSERT(b.Count() == 1);
+        ASSERT(c.Count() == 1);
+
+        // a cancelled target isn't dispatched; c would follow b if b were still queued
+        a.Block();
+        dispatcher.Queue(a);
+        a.WaitBlocked();
+        dispatcher.Queue(b);
+        dispatcher.Cancel(b);
+        dispatcher.Queue(c);
+        a.Release();
+        dispatched.Wait();
+        dispatched.Wait();
+        ASSERT(a.Count() == 3);
+        ASSERT(b.Count() == 1);
+        ASSERT(c.Count() == 2);
+
+        // cancelling a target that's being dispatched waits for that dispatch and drops any update queued meanwhile
+        a.Block();
+        dispatcher.Queue(a);
+        a.WaitBlocked();
+        dispatcher.Queue(a);
+        DispatchCanceller* canceller = new DispatchCanceller(dispatcher, a);
+        ASSERT(!canceller->Cancelled(kWaitMs));
+        a.Release();
+        ASSERT(canceller->Cancelled(Semaphore::kWaitForever));
+        delete canceller;
+        dispatched.Wait();
+        dispatcher.Queue(c);
+        dispatched.Wait();
+        ASSERT(a.Count() == 4);
+        ASSERT(c.Count() == 3);
+    }
+    {
+        // a target isn't dispatched on a second thread while the first is still reporting it
+        CpiEventDispatcher dispatcher(2);
+        a.Block();
+        dispatcher.Queue(a);
+        a.WaitBlocked();
+        dispatcher.Queue(a);
+        Thread::Sleep(kWaitMs);
+        ASSERT(a.Count() == 5);
+        a.Release();
+        dispatched.Wait();
+        dispatched.Wait();
+        ASSERT(a.Count() == 6);
+        ASSERT(a.MaxConcurrent() == 1);
+    }
+}
+
+class BlockingObserver
+{
+public:
+    BlockingObserver();
+    void Block(); // next callback waits until Release() is called
+    void WaitBlocked();
+    void Release();
+    void WaitChanged();
+    TUint Count() const;
+    void Changed();
+private:
+    mutable Mutex iLock;
+    Semaphore iBlocked;
+    Semaphore iRelease;
+    Semaphore iChanged;
+    TBool iBlock;
+    TUint iCount;
+};
+
+BlockingObserver::BlockingObserver()
+    : iLock("TBOL")
+    , iBlocked("TBO1", 0)
+    , iRelease("TBO2", 0)
+    , iChanged("TBO3", 0)
+    , iBlock(false)
+    , iCount(0)
+{
+}
+
+void BlockingObserver::Block()
+{
+    AutoMutex a(iLock);
+    iBlock = true;
+}
+
+void BlockingObserver::WaitBlocked()
+{
+    iBlocked.Wait();
+}
+
+void BlockingObserver::Release()
+{
+    iRelease.Signal();
+}
+
+void BlockingObserver::WaitChanged()
+{
+    iChanged.Wait();
+}
+
+TUint BlockingObserver::Count() const
+{
+    AutoMutex a(iLock);
+    return iCount;
+}
+
+void BlockingObserver::Changed()
+{
+    iLock.Wait();
+    iCount++;
+    const TBool block = iBlock;
+    iBlock = false;
+    iLock.Signal();
+    if (block) {
+        iBlocked.Signal();
+        iRelease.Wait();
+    }
+    iChanged.Signal();
+}
+
+static void TestDeleteWithQueuedUpdate(CpDevice& aDevice)
+{
+    Print("  Delete proxy with queued update\n");
+    BlockingObserver observer1;
+    CpProxyOpenhomeOrgTestBasic1* proxy1 = new CpProxyOpenhomeOrgTestBasic1(aDevice);
+    Functor functor = MakeFunctor(observer1, &BlockingObserver::Changed);
+    proxy1->SetPropertyChanged(functor);
+    proxy1->Subscribe();
+    observer1.WaitChanged();
+    BlockingObserver observer2;
+    CpProxyOpenhomeOrgTestBasic1* proxy2 = new CpProxyOpenhomeOrgTestBasic1(aDevice);
+    functor = MakeFunctor(observer2, &BlockingObserver::Changed);
+    proxy2->SetPropertyChanged(functor);
+    proxy2->Subscribe();
+    observer2.WaitChanged();
+
+    // hold the (single) dispatcher in proxy1's callback so that proxy2's next update stays queued
+    TUint val;
+    proxy1->SyncGetUint(val);
+    observer1.Block();
+    proxy1->SyncSetUint(++val);
+    observer1.WaitBlocked();
+    proxy1->SyncSetUint(++val);
+    for (;;) {
+        TUint prop;
+        proxy2->PropertyVarUint(prop);
+        if (prop == val) {
+            break;
+        }
+        Thread::Sleep(10);
+    }
+    const TUint count2 = observer2.Count();
+    delete proxy2;
+    observer1.Release();
+    observer1.WaitChanged();
+    observer1.WaitChanged(); // proxy1's own coalesced update, dispatched after proxy2's would have been
+    ASSERT(observer2.Count() == count2);
+    delete proxy1;
+}
+
+class UpdateRecorder : public IEventProcessor
+{
+public:
+    UpdateRecorder();
+    void WaitUpdated();
+    std::vector<TUint> Values() const; // every value of VarUint, in the order received
+private: // from IEventProcessor
+    void EventUpdateStart() {}
+    void EventUpdate(const Brx& aName, const Brx& aValue, IOutputProcessor& aProcessor);
+    void EventUpdateEnd();
+    void EventUpdateError() {}
+    void EventUpdatePrepareForDelete() {}
+private:
+    mutable Mutex iLock;
+    Semaphore iUpdated;
+    std::vector<TUint> iValues;
+};
+
+UpdateRecorder::UpdateRecorder()
+    : iLock("TURL")
+    , iUpdated("TURS", 0)
+{
+}
+
+std::vector<TUint> UpdateRecorder::Values() const
+{
+    AutoMutex a(iLock);
+    return iValues;
+}
+
+void UpdateRecorder::EventUpdate(const Brx& aName, const Brx& aValue, IOutputProcessor& aProcessor)
+{
+    if (aName == Brn("VarUint")) {
+        TUint val;
+        aProcessor.ProcessUint(aValue, val);
+        AutoMutex a(iLock);
+        iValues.push_back(val);
+    }
+}
+
+void UpdateRecorder::WaitUpdated()
+{
+    iUpdated.Wait(5000);
+}
+
+void UpdateRecorder::EventUpdateEnd()
+{
+    iUpdated.Signal();
+}
+
+static void TestRenewBatching(CpDevice& aDevice, CpStack& aCpStack)
+{
+    Print("  Batched renewals\n");
+    // renewals are due 2-3s after subscribing and may be brought forward by up to 0.5s to join a batch
+    const TUint kDurationSecs = 4;
+    const TUint kNumSubscriptions = 6;
+    InitialisationParams* params = aCpStack.Env().InitParams();
+    const TUint durationSecs = params->SubscriptionDurationSecs();
+    params->SetSubscriptionDuration(kDurationSecs);
+    CpiSubscriptionManager& mgr = aCpStack.SubscriptionManager();
+    OpenHome::Net::ServiceType serviceType(aCpStack.Env(), "openhome.org", "TestBasic", 1);
+    std::vector<UpdateRecorder*> recorders;
+    std::vector<CpiSubscription*> subscriptions;
+    for (TUint i=0; i<kNumSubscriptions; i++) {
+        UpdateRecorder* recorder = new UpdateRecorder();
+        recorders.push_back(recorder);
+        subscriptions.push_back(mgr.NewSubscription(aDevice.Device(), *recorder, serviceType));
+    }
+    for (TUint i=0; i<kNumSubscriptions; i++) {
+        recorders[i]->WaitUpdated(); // initial event
+    }
+
+    /* All renewals fall within a 1s range which is twice the batch window, so at least
+       two of the first renewals of more than two subscriptions must be batched. */
+    Print("    Batching...\n");
+    const TUint batched = mgr.BatchedRenewalCount();
+    Thread::Sleep(kDurationSecs * 1000 * 3 / 4 + 500);
+    TEST(mgr.BatchedRenewalCount() > batched);
+
+    /* Resubscribes race renewals which may be claimed early by another subscription's timer.
+       Each must still happen (and deliver a new initial event) rather than being replaced
+       by a renewal.  Each subscription is resubscribed every 2.4s so some renew first. */
+    Print("    Resubscribe racing renewals...\n");
+    for (TUint i=0; i<4*kNumSubscriptions; i++) {
+        const TUint index = i % kNumSubscriptions;
+        subscriptions[index]->SetNotificationError();
+        recorders[index]->WaitUpdated();
+        Thread::Sleep(400);
+    }
+
+    // unsubscribe while batches may be pending; any leaked subscription is reported at shutdown
+    Print("    Unsubscribe racing renewals...\n");
+    for (TUint i=0; i<kNumSubscriptions; i++) {
+        Thread::Sleep(i * 100);
+        subscriptions[i]->Unsubscribe();
+        subscriptions[i]->RemoveRef();
+    }
+    for (TUint i=0; i<kNumSubscriptions; i++) {
+        delete recorders[i];
+    }
+    params->SetSubscriptionDuration(durationSecs);
+}
+
+static void TestSequenceNumbers(CpDevice& aDevice, CpStack& aCpStack)
+{
+    Print("  Sequence numbers\n");
+    Print("    Wrap and out of order...\n");
+    TUint expected = UINT32_MAX - 1;
+    TEST(CpiSubscription::NextSequenceNumber(expected, UINT32_MAX - 1));
+    TEST(CpiSubscription::NextSequenceNumber(expected, UINT32_MAX));
+    TEST(expected == 1);
+    TEST(!CpiSubscription::NextSequenceNumber(expected, 0)); // 0 is only used for the initial event
+    TEST(CpiSubscription::NextSequenceNumber(expected, 1));
+    TEST(!CpiSubscription::NextSequenceNumber(expected, 3)); // gap
+    TEST(!CpiSubscription::NextSequenceNumber(expected, 1)); // repeat
+    TEST(expected == 2);
+    TEST(CpiSubscription::NextSequenceNumber(expected, 2));
+
+    Print("    Gap...\n");
+    CpiSubscriptionManager& mgr = aCpStack.SubscriptionManager();
+    OpenHome::Net::ServiceType serviceType(aCpStack.Env(), "openhome.org", "TestBasic", 1);
+    UpdateRecorder recorder;
+    CpiSubscription* subscription = mgr.NewSubscription(aDevice.Device(), recorder, serviceType);
+    recorder.WaitUpdated(); // initial event, sequence number 0
+    TUint gaps = mgr.SequenceGapCount();
+    TEST(!subscription->UpdateSequenceNumber(2));
+    TEST(mgr.SequenceGapCount() == gaps + 1);
+    const Brh sid(subscription->Sid());
+
+    /* Claim the next sequence number so that the device's next update appears to follow
+       a missed one.  The subscription should resync by subscribing again. */
+    TEST(subscription->UpdateSequenceNumber(1));
+    gaps = mgr.SequenceGapCount();
+    CpProxyOpenhomeOrgTestBasic1* proxy = new CpProxyOpenhomeOrgTestBasic1(aDevice);
+    TUint val;
+    proxy->SyncGetUint(val);
+    proxy->SyncSetUint(val + 1);
+    recorder.WaitUpdated(); // initial event from the new subscription
+    TEST(mgr.SequenceGapCount() == gaps + 1);
+    TEST(subscription->Sid() != sid);
+    delete proxy;
+
+    subscription->Unsubscribe();
+    subscription->RemoveRef();
+}
+
+static void AppendNotify(Bwx& aRequest, CpiSubscription& aSubscription, TUint aSeq, TUint aValue, TBool aChunked)
+{
+    Bws<256> body("<?xml version=\"1.0\"?><e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\"><e:property><VarUint>");
+    Ascii::AppendDec(body, aValue);
+    body.Append("</VarUint></e:property></e:propertyset>");
+    aRequest.Append("NOTIFY /");
+    Ascii::AppendDec(aRequest, aSubscription.Id());
+    aRequest.Append("/ HTTP/1.1\r\nNT: upnp:event\r\nNTS: upnp:propchange\r\nSID: uuid:");
+    aRequest.Append(aSubscription.Sid());
+    aRequest.Append("\r\nSEQ: ");
+    Ascii::AppendDec(aRequest, aSeq);
+    if (aChunked) {
+        aRequest.Append("\r\nTransfer-Encoding: chunked\r\n\r\n");
+        // split the body between two chunks
+        const TUint bytes = body.Bytes() / 2;
+        Ascii::AppendHexTrim(aRequest, bytes);
+        aRequest.Append("\r\n");
+        aRequest.Append(body.Split(0, bytes));
+        aRequest.Append("\r\n");
+        Ascii::AppendHexTrim(aRequest, body.Bytes() - bytes);
+        aRequest.Append("\r\n");
+        aRequest.Append(body.Split(bytes));
+        aRequest.Append("\r\n0\r\n\r\n");
+    }
+    else {
+        aRequest.Append("\r\nContent-Length: ");
+        Ascii::AppendDec(aRequest, body.Bytes());
+        aRequest.Append("\r\n\r\n");
+        aRequest.Append(body);
+    }
+}
+
+static TUint CountResponses(const Brx& aResponses)
+{
+    const Brn status("HTTP/1.1 200 OK\r\n");
+    TUint count = 0;
+    for (TUint i=0; i+status.Bytes()<=aResponses.Bytes(); i++) {
+        if (aResponses.Split(i, status.Bytes()) == status) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void TestEventSessions(CpDevice& aDevice, CpStack& aCpStack)
+{
+    Print("  Event sessions\n");
+    Environment& env = aCpStack.Env();
+    CpiSubscriptionManager& mgr = aCpStack.SubscriptionManager();
+    OpenHome::Net::ServiceType serviceType(env, "openhome.org", "TestBasic", 1);
+    UpdateRecorder recorder;
+    CpiSubscription* subscription = mgr.NewSubscription(aDevice.Device(), recorder, serviceType);
+    recorder.WaitUpdated(); // initial event, sequence number 0
+    const Brh sid(subscription->Sid());
+    const TUint gaps = mgr.SequenceGapCount();
+    NetworkAdapter* adapter = env.NetworkAdapterList().CurrentAdapter("TestEventSessions");
+    const Endpoint endpoint(mgr.EventServerPort(), adapter->Address());
+    adapter->RemoveRef("TestEventSessions");
+
+    Print("    Pipelined chunked and Content-Length notifications...\n");
+    Bwh request(2048);
+    AppendNotify(request, *subscription, 1, 101, true);
+    AppendNotify(request, *subscription, 2, 102, false);
+    SocketTcpClient socket;
+    socket.Open(env);
+    socket.Connect(endpoint, 5000);
+    socket.Write(request);
+    recorder.WaitUpdated();
+    recorder.WaitUpdated();
+    std::vector<TUint> values = recorder.Values();
+    TEST(values.size() == 3); // initial event then both notifications
+    TEST(values[1] == 101);
+    TEST(values[2] == 102);
+    Bws<1024> responses;
+    Bws<512> buf;
+    while (CountResponses(responses) < 2) {
+        socket.Read(buf);
+        responses.Append(buf);
+    }
+    TEST(!Ascii::Contains(responses, Brn("Connection: close")));
+    socket.Close();
+    TEST(mgr.SequenceGapCount() == gaps);
+    TEST(subscription->Sid() == sid); // no resubscribe
+
+    /* Occupy all but one session with connections which send nothing.  The final session
+       must not then keep its connection alive. */
+    Print("    No keep-alive once all sessions are busy...\n");
+    const TUint numSessions = env.InitParams()->NumEventSessionThreads();
+    std::vector<SocketTcpClient*> idle;
+    for (TUint i=0; i<numSessions-1; i++) {
+        SocketTcpClient* client = new SocketTcpClient();
+        client->Open(env);
+        client->Connect(endpoint, 5000);
+        idle.push_back(client);
+    }
+    Thread::Sleep(200); // allow the idle connections to be accepted
+    request.SetBytes(0);
+    AppendNotify(request, *subscription, 3, 103, false);
+    SocketTcpClient socket2;
+    socket2.Open(env);
+    socket2.Connect(endpoint, 5000);
+    socket2.Write(request);
+    recorder.WaitUpdated();
+    values = recorder.Values();
+    TEST(values.size() == 4);
+    TEST(values[3] == 103);
+    responses.SetBytes(0);
+    try {
+        for (;;) {
+            socket2.Read(buf);
+            responses.Append(buf);
+        }
+    }
+    catch (ReaderError&) {
+    }
+    TEST(CountResponses(responses) == 1);
+    TEST(Ascii::Contains(responses, Brn("Connection: close")));
+    socket2.Close();
+    for (TUint i=0; i<idle.size(); i++) {
+        idle[i]->Close();
+        delete idle[i];
+    }
+
+    subscription->Unsubscribe();
+    subscription->RemoveRef();
+}
+
+static const TChar* kCacheFile = "TestCpDeviceDvCache.bin";
+static const TChar* kCacheTempFile = "TestCpDeviceDvCache.bin.tmp";
+
+static void AppendCacheEntry(WriterBwh& aWriter, const TChar* aUdn, const TChar* aLocation, const TChar* aXml, TBool aCorrupt)
+{
+    WriterBinary writerBinary(aWriter);
+    Brn udn(aUdn);
+    Brn location(aLocation);
+    Brn xml(aXml);
+    Bws<CpiDeviceCacheUpnp::kChecksumBytes> checksum;
+    CpiDeviceCacheUpnp::Checksum(xml, checksum);
+    if (aCorrupt) {
+        checksum[0] = (TByte)(checksum[0] ^ 0xff);
+    }
+    writerBinary.WriteUint16Be(udn.Bytes());
+    aWriter.Write(udn);
+    writerBinary.WriteUint16Be(location.Bytes());
+    aWriter.Write(location);
+    writerBinary.WriteUint16Be(0); // no ETag
+    aWriter.Write(checksum);
+    writerBinary.WriteUint32Be(xml.Bytes());
+    aWriter.Write(xml);
+}
+
+static void WriteCacheFile(const Brx& aMagic, TUint aVersion, TUint aEntries, const Brx& aEntryData)
+{
+    WriterBwh writer(1024);
+    WriterBinary writerBinary(writer);
+    writer.Write(aMagic);
+    writerBinary.WriteUint32Be(aVersion);
+    writerBinary.WriteUint32Be(aEntries);
+    writer.Write(aEntryData);
+    IFile* file = IFile::Open(kCacheFile, eFileWriteOnly);
+    file->Write(writer.Buffer());
+    delete file;
+}
+
+static TUint CachedEntries(Environment& aEnv, std::vector<CpiDeviceCacheUpnp::Entry*>& aEntries)
+{
+    CpiDeviceCacheUpnp* cache = new CpiDeviceCacheUpnp(aEnv, kCacheFile);
+    cache->Snapshot(aEntries);
+    delete cache;
+    return (TUint)aEntries.size();
+}
+
+static void ClearEntries(std::vector<CpiDeviceCacheUpnp::Entry*>& aEntries)
+{
+    for (TUint i=0; i<aEntries.size(); i++) {
+        delete aEntries[i];
+    }
+    aEntries.clear();
+}
+
+static TBool FileExists(const TChar* aFilename)
+{
+    try {
+        IFile* file = IFile::Open(aFilename, eFileReadOnly);
+        delete file;
+        return true;
+    }
+    catch (FileOpenError&) {
+        return false;
+    }
+}
+
+static void TestDeviceCache(Environment& aEnv)
+{
+    Print("  Device cache\n");
+    (void)remove(kCacheFile);
+    std::vector<CpiDeviceCacheUpnp::Entry*> entries;
+
+    Print("    Round trip...\n");
+    TEST(CachedEntries(aEnv, entries) == 0);
+    CpiDeviceCacheUpnp* cache = new CpiDeviceCacheUpnp(aEnv, kCacheFile);
+    cache->Add(Brn("uuid:b"), Brn("http://10.0.0.2/b.xml"), Brn("<root>b</root>"), Brx::Empty());
+    cache->Add(Brn("uuid:a"), Brn("http://10.0.0.1/a.xml"), Brn("<root>a</root>"), Brn("\"a1\""));
+    delete cache; // writes the cache
+    TEST(FileExists(kCacheFile));
+    TEST(!FileExists(kCacheTempFile));
+    TEST(CachedEntries(aEnv, entries) == 2);
+    TEST(entries[0]->Udn() == Brn("uuid:a")); // entries are ordered by udn
+    TEST(entries[0]->Location() == Brn("http://10.0.0.1/a.xml"));
+    TEST(entries[0]->Xml() == Brn("<root>a</root>"));
+    TEST(entries[0]->ETag() == Brn("\"a1\""));
+    TEST(entries[1]->Udn() == Brn("uuid:b"));
+    TEST(entries[1]->Location() == Brn("http://10.0.0.2/b.xml"));
+    TEST(entries[1]->Xml() == Brn("<root>b</root>"));
+    TEST(entries[1]->ETag().Bytes() == 0);
+    Bws<CpiDeviceCacheUpnp::kChecksumBytes> checksum;
+    CpiDeviceCacheUpnp::Checksum(Brn("<root>a</root>"), checksum);
+    TEST(entries[0]->Checksum() == checksum);
+    ClearEntries(entries);
+
+    Print("    Rewrite with fewer entries...\n");
+    cache = new CpiDeviceCacheUpnp(aEnv, kCacheFile);
+    TEST(cache->Matches(Brn("uuid:a"), checksum));
+    cache->Remove(Brn("uuid:b"));
+    delete cache;
+    TEST(!FileExists(kCacheTempFile));
+    TEST(CachedEntries(aEnv, entries) == 1);
+    TEST(entries[0]->Udn() == Brn("uuid:a"));
+    ClearEntries(entries);
+
+    WriterBwh valid(1024);
+    AppendCacheEntry(valid, "uuid:a", "http://10.0.0.1/a.xml", "<root>a</root>", false);
+    Print("    Bad magic...\n");
+    WriteCacheFile(Brn("ohDX"), 2, 1, valid.Buffer());
+    TEST(CachedEntries(aEnv, entries) == 0);
+    Print("    Bad version...\n");
+    WriteCacheFile(Brn("ohDC"), 1, 1, valid.Buffer());
+    TEST(CachedEntries(aEnv, entries) == 0);
+    WriteCacheFile(Brn("ohDC"), 2, 1, valid.Buffer()); // check the file format above is otherwise valid
+    TEST(CachedEntries(aEnv, entries) == 1);
+    ClearEntries(entries);
+
+    Print("    Bad md5...\n");
+    WriterBwh corrupt(1024);
+    AppendCacheEntry(corrupt, "uuid:a", "http://10.0.0.1/a.xml", "<root>a</root>", true);
+    AppendCacheEntry(corrupt, "uuid:b", "http://10.0.0.2/b.xml", "<root>b</root>", false);
+    WriteCacheFile(Brn("ohDC"), 2, 2, corrupt.Buffer());
+    TEST(CachedEntries(aEnv, entries) == 1); // only the corrupt entry is discarded
+    TEST(entries[0]->Udn() == Brn("uuid:b"));
+    ClearEntries(entries);
+
+    Print("    Duplicate udn...\n");
+    WriterBwh duplicate(1024);
+    AppendCacheEntry(duplicate, "uuid:a", "http://10.0.0.1/a.xml", "<root>a</root>", false);
+    AppendCacheEntry(duplicate, "uuid:a", "http://10.0.0.3/a.xml", "<root>a2</root>", false);
+    WriteCacheFile(Brn("ohDC"), 2, 2, duplicate.Buffer());
+    TEST(CachedEntries(aEnv, entries) == 1); // the later entry wins
+    TEST(entries[0]->Location() == Brn("http://10.0.0.3/a.xml"));
+    TEST(entries[0]->Xml() == Brn("<root>a2</root>"));
+    ClearEntries(entries);
+
+    (void)remove(kCacheFile);
+}
+
 void TestCpDeviceDv(CpStack& aCpStack, DvStack& aDvStack)
 {
     Print("TestCpDeviceDv - starting\n");
@@ -444,6 +1319,15 @@ void TestCpDeviceDv(CpStack& aCpStack, DvStack& aDvStack)
     CpDeviceDv* cpDevice = CpDeviceDv::New(aCpStack, device->Device());
     TestInvocation(*cpDevice);
     TestSubscription(*cpDevice);
+    TestChangedProperties(*cpDevice);
+    TestStagedValues();
+    TestDeviceCache(aCpStack.Env());
+    TestEventDispatcher();
+    TestDeleteWithQueuedUpdate(*cpDevice);
+    TestRenewBatching(*cpDevice, aCpStack);
+    TEST(aCpStack.SubscriptionManager().SequenceGapCount() == 0); // every notification was delivered in order
+    TestSequenceNumbers(*cpDevice, aCpStack);
+    TestEventSessions(*cpDevice, aCpStack);
     cpDevice->RemoveRef();
     delete device;
 
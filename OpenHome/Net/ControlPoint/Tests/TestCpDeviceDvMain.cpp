@@ -12,6 +12,7 @@ extern void TestCpDeviceDv(CpStack& aCpStack, DvStack& aDvStack);
 void OpenHome::TestFramework::Runner::Main(TInt /*aArgc*/, TChar* /*aArgv*/[], Net::InitialisationParams* aInitParams)
 {
     aInitParams->SetUseLoopbackNetworkAdapter();
+    aInitParams->SetNumEventDispatchThreads(1); // some tests hold the (single) dispatcher
     Library* lib = new Library(aInitParams);
     std::vector<NetworkAdapter*>* subnetList = lib->CreateSubnetList();
     TIpAddress subnet = (*subnetList)[0]->Subnet();
@@ -4,6 +4,7 @@
 //     service's state variables) on each device in a second
 
 #include <OpenHome/Private/TestFramework.h>
+#include <OpenHome/Private/OptionParser.h>
 #include <OpenHome/Types.h>
 #include <OpenHome/Net/Private/Discovery.h>
 #include <OpenHome/Private/Thread.h>
@@ -15,7 +16,9 @@
 #include <OpenHome/OsWrapper.h>
 #include <OpenHome/Net/Core/FunctorCpDevice.h>
 #include <OpenHome/Net/Core/CpUpnpOrgConnectionManager1.h>
+#include <OpenHome/Net/Private/CpiService.h>
 
+#include <map>
 #include <vector>
 
 using namespace OpenHome;
@@ -137,11 +140,63 @@ void DeviceList::Removed(CpDevice& aDevice)
 }
 
 
-void TestSubscription(CpStack& aCpStack)
+static void BenchmarkPropertyLookup(Environment& aEnv)
 {
+    // compare the lookup CpProxy uses for each evented property with the ordered map it replaced
+    const TUint kNumProperties = 64;
+    const TUint kIterations = 20000;
+    Functor functor;
+    CpiPropertyTable table;
+    std::map<Brn,Property*,BufferCmp> map;
+    for (TUint i=0; i<kNumProperties; i++) {
+        Bws<32> name;
+        name.AppendPrintf("StateVariable%u", i);
+        Property* property = new PropertyUint((const TChar*)name.PtrZ(), functor);
+        table.Add(property);
+        Brn key(property->Parameter().Name());
+        map.insert(std::pair<Brn,Property*>(key, property));
+    }
+
+    TUint found = 0;
+    TUint startTime = Os::TimeInMs(aEnv.OsCtx());
+    for (TUint i=0; i<kIterations; i++) {
+        for (TUint j=0; j<kNumProperties; j++) {
+            Brn name(table.At(j).Parameter().Name());
+            if (map.find(name) != map.end()) {
+                found++;
+            }
+        }
+    }
+    const TUint mapMs = Os::TimeInMs(aEnv.OsCtx()) - startTime;
+    startTime = Os::TimeInMs(aEnv.OsCtx());
+    for (TUint i=0; i<kIterations; i++) {
+        for (TUint j=0; j<kNumProperties; j++) {
+            if (table.Find(table.At(j).Parameter().Name()) != NULL) {
+                found++;
+            }
+        }
+    }
+    const TUint tableMs = Os::TimeInMs(aEnv.OsCtx()) - startTime;
+    ASSERT(found == 2 * kIterations * kNumProperties);
+    ASSERT(table.Find(Brn("StateVariable")) == NULL);
+    Print("Property lookup (%u properties x %u events): map %ums, table %ums\n\n",
+          kNumProperties, kIterations, mapMs, tableMs);
+}
+
+void TestSubscription(CpStack& aCpStack, const std::vector<Brn>& aArgs)
+{
+    OptionParser parser;
+    OptionBool benchmark("-b", "--benchmark", "Also time property lookups");
+    parser.AddOption(&benchmark);
+    if (!parser.Parse(aArgs) || parser.HelpDisplayed()) {
+        return;
+    }
     gSubscriptionCount = 0; // reset this here in case we're run multiple times via TestShell
     Debug::SetLevel(Debug::kNone);
     Environment& env = aCpStack.Env();
+    if (benchmark.Value()) {
+        BenchmarkPropertyLookup(env);
+    }
     DeviceList* deviceList = new DeviceList(env);
     FunctorCpDevice added = MakeFunctorCpDevice(*deviceList, &DeviceList::Added);
     FunctorCpDevice removed = MakeFunctorCpDevice(*deviceList, &DeviceList::Removed);
@@ -8,17 +8,18 @@
 using namespace OpenHome;
 using namespace OpenHome::Net;
 
-extern void TestSubscription(CpStack& aCpStack);
+extern void TestSubscription(CpStack& aCpStack, const std::vector<Brn>& aArgs);
 
-void OpenHome::TestFramework::Runner::Main(TInt /*aArgc*/, TChar* /*aArgv*/[], Net::InitialisationParams* aInitParams)
+void OpenHome::TestFramework::Runner::Main(TInt aArgc, TChar* aArgv[], Net::InitialisationParams* aInitParams)
 {
+    std::vector<Brn> args = OptionParser::ConvertArgs(aArgc, aArgv);
     Library* lib = new Library(aInitParams);
     std::vector<NetworkAdapter*>* subnetList = lib->CreateSubnetList();
     TIpAddress subnet = (*subnetList)[0]->Subnet();
     Library::DestroySubnetList(subnetList);
     CpStack* cpStack = lib->StartCp(subnet);
 
-    TestSubscription(*cpStack);
+    TestSubscription(*cpStack, args);
 
     delete lib;
 }
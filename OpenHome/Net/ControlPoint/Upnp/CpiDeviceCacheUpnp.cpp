@@ -0,0 +1,298 @@
+#include <OpenHome/Net/Private/CpiDeviceCacheUpnp.h>
+#include <OpenHome/Private/Env.h>
+#include <OpenHome/Private/Timer.h>
+#include <OpenHome/Private/File.h>
+#include <OpenHome/Private/Stream.h>
+#include <OpenHome/Private/Debug.h>
+#include <OpenHome/Private/md5.h>
+
+#include <cstdio>
+
+using namespace OpenHome;
+using namespace OpenHome::Net;
+
+/* File format (all integers big endian)...
+     4 bytes   magic ("ohDC")
+     4 bytes   version
+     4 bytes   entry count
+   ...followed by, for each entry...
+     2 bytes   udn length, followed by udn
+     2 bytes   location length, followed by location
+     2 bytes   ETag length, followed by ETag (length 0 if the device didn't supply one)
+     16 bytes  md5 of device xml
+     4 bytes   device xml length, followed by device xml */
+
+// CpiDeviceCacheUpnp::Entry
+
+CpiDeviceCacheUpnp::Entry::Entry(const Brx& aUdn, const Brx& aLocation, const Brx& aXml, const Brx& aETag, const Brx& aChecksum)
+    : iUdn(aUdn)
+    , iLocation(aLocation)
+    , iXml(aXml)
+    , iETag(aETag)
+    , iChecksum(aChecksum)
+{
+}
+
+const Brx& CpiDeviceCacheUpnp::Entry::Udn() const
+{
+    return iUdn;
+}
+
+const Brx& CpiDeviceCacheUpnp::Entry::Location() const
+{
+    return iLocation;
+}
+
+const Brx& CpiDeviceCacheUpnp::Entry::Xml() const
+{
+    return iXml;
+}
+
+const Brx& CpiDeviceCacheUpnp::Entry::ETag() const
+{
+    return iETag;
+}
+
+const Brx& CpiDeviceCacheUpnp::Entry::Checksum() const
+{
+    return iChecksum;
+}
+
+
+// CpiDeviceCacheUpnp
+
+const Brn CpiDeviceCacheUpnp::kMagic("ohDC");
+const Brn CpiDeviceCacheUpnp::kTempSuffix(".tmp");
+
+CpiDeviceCacheUpnp::CpiDeviceCacheUpnp(Environment& aEnv, const TChar* aFilename)
+    : iLock("DCUP")
+    , iFilename(aFilename)
+    , iDirty(false)
+{
+    Bwh tempFilename(iFilename.Bytes() + kTempSuffix.Bytes());
+    tempFilename.Append(iFilename);
+    tempFilename.Append(kTempSuffix);
+    iTempFilename.Set(tempFilename);
+    iSaveTimer = new Timer(aEnv, MakeFunctor(*this, &CpiDeviceCacheUpnp::SaveTimerExpired), "CpiDeviceCacheUpnp");
+    Load();
+}
+
+CpiDeviceCacheUpnp::~CpiDeviceCacheUpnp()
+{
+    delete iSaveTimer;
+    Save();
+    EntryMap::iterator it = iMap.begin();
+    while (it != iMap.end()) {
+        delete it->second;
+        it++;
+    }
+}
+
+void CpiDeviceCacheUpnp::Add(const Brx& aUdn, const Brx& aLocation, const Brx& aXml, const Brx& aETag)
+{
+    Bws<kChecksumBytes> checksum;
+    Checksum(aXml, checksum);
+    AutoMutex a(iLock);
+    Brn udn(aUdn);
+    EntryMap::iterator it = iMap.find(udn);
+    if (it != iMap.end()) {
+        Entry* existing = it->second;
+        if (existing->Location() == aLocation && existing->ETag() == aETag && existing->Checksum() == checksum) {
+            return;
+        }
+        iMap.erase(it);
+        delete existing;
+    }
+    Entry* entry = new Entry(aUdn, aLocation, aXml, aETag, checksum);
+    udn.Set(entry->Udn());
+    iMap.insert(std::pair<Brn,Entry*>(udn, entry));
+    ScheduleSaveLocked();
+}
+
+void CpiDeviceCacheUpnp::Remove(const Brx& aUdn)
+{
+    AutoMutex a(iLock);
+    Brn udn(aUdn);
+    EntryMap::iterator it = iMap.find(udn);
+    if (it == iMap.end()) {
+        return;
+    }
+    Entry* entry = it->second;
+    iMap.erase(it);
+    delete entry;
+    ScheduleSaveLocked();
+}
+
+void CpiDeviceCacheUpnp::Snapshot(std::vector<Entry*>& aEntries) const
+{
+    AutoMutex a(iLock);
+    EntryMap::const_iterator it = iMap.begin();
+    while (it != iMap.end()) {
+        const Entry* entry = it->second;
+        aEntries.push_back(new Entry(entry->Udn(), entry->Location(), entry->Xml(), entry->ETag(), entry->Checksum()));
+        it++;
+    }
+}
+
+TBool CpiDeviceCacheUpnp::Matches(const Brx& aUdn, const Brx& aChecksum) const
+{
+    AutoMutex a(iLock);
+    Brn udn(aUdn);
+    EntryMap::const_iterator it = iMap.find(udn);
+    if (it == iMap.end()) {
+        return false;
+    }
+    return (it->second->Checksum() == aChecksum);
+}
+
+void CpiDeviceCacheUpnp::Checksum(const Brx& aXml, Bwx& aChecksum)
+{
+    ASSERT(aChecksum.MaxBytes() >= kChecksumBytes);
+    md5_state_t state;
+    md5_byte_t digest[kChecksumBytes];
+    md5_init(&state);
+    md5_append(&state, (const md5_byte_t*)aXml.Ptr(), aXml.Bytes());
+    md5_finish(&state, digest);
+    aChecksum.Replace(digest, kChecksumBytes);
+}
+
+static Brn ReadExactly(ReaderBuffer& aReader, TUint aBytes)
+{
+    if (aReader.Bytes() < aBytes) {
+        THROW(ReaderError);
+    }
+    return aReader.ReadPartial(aBytes);
+}
+
+void CpiDeviceCacheUpnp::Load()
+{
+    IFile* file = NULL;
+    try {
+        file = IFile::Open(iFilename.CString(), eFileReadOnly);
+    }
+    catch (FileOpenError&) {
+        LOG(kDevice, "CpiDeviceCacheUpnp - no cache found at %s\n", iFilename.CString());
+        return;
+    }
+    Bwh content(file->Bytes());
+    try {
+        if (content.MaxBytes() > 0) {
+            file->Read(content);
+        }
+    }
+    catch (FileReadError&) {
+        content.SetBytes(0);
+    }
+    delete file;
+
+    ReaderBuffer reader(content);
+    ReaderBinary readerBinary(reader);
+    TUint count = 0;
+    try {
+        if (ReadExactly(reader, kMagic.Bytes()) != kMagic || readerBinary.ReadUintBe(4) != kVersion) {
+            THROW(ReaderError);
+        }
+        const TUint entries = readerBinary.ReadUintBe(4);
+        for (TUint i=0; i<entries; i++) {
+            Brn udn = ReadExactly(reader, readerBinary.ReadUintBe(2));
+            Brn location = ReadExactly(reader, readerBinary.ReadUintBe(2));
+            Brn etag = ReadExactly(reader, readerBinary.ReadUintBe(2));
+            Brn checksum = ReadExactly(reader, kChecksumBytes);
+            Brn xml = ReadExactly(reader, readerBinary.ReadUintBe(4));
+            Bws<kChecksumBytes> actual;
+            Checksum(xml, actual);
+            if (actual != checksum) {
+                LOG2(kDevice, kError, "CpiDeviceCacheUpnp - discarding corrupt entry for %.*s\n", PBUF(udn));
+                continue;
+            }
+            EntryMap::iterator it = iMap.find(udn);
+            if (it != iMap.end()) { // later entries for a udn replace earlier ones, as for Add()
+                Entry* existing = it->second;
+                iMap.erase(it);
+                delete existing;
+                count--;
+            }
+            Entry* entry = new Entry(udn, location, xml, etag, checksum);
+            iMap.insert(std::pair<Brn,Entry*>(Brn(entry->Udn()), entry));
+            count++;
+        }
+    }
+    catch (ReaderError&) {
+        LOG2(kDevice, kError, "CpiDeviceCacheUpnp - %s is truncated or invalid\n", iFilename.CString());
+    }
+    LOG(kDevice, "CpiDeviceCacheUpnp - loaded %u devices from %s\n", count, iFilename.CString());
+}
+
+void CpiDeviceCacheUpnp::SaveTimerExpired()
+{
+    Save();
+}
+
+void CpiDeviceCacheUpnp::Save()
+{
+    WriterBwh writer(1024);
+    WriterBinary writerBinary(writer);
+    iLock.Wait();
+    if (!iDirty) {
+        iLock.Signal();
+        return;
+    }
+    iDirty = false;
+    writer.Write(kMagic);
+    writerBinary.WriteUint32Be(kVersion);
+    writerBinary.WriteUint32Be((TUint)iMap.size());
+    EntryMap::iterator it = iMap.begin();
+    while (it != iMap.end()) {
+        const Entry* entry = it->second;
+        writerBinary.WriteUint16Be(entry->Udn().Bytes());
+        writer.Write(entry->Udn());
+        writerBinary.WriteUint16Be(entry->Location().Bytes());
+        writer.Write(entry->Location());
+        writerBinary.WriteUint16Be(entry->ETag().Bytes());
+        writer.Write(entry->ETag());
+        writer.Write(entry->Checksum());
+        writerBinary.WriteUint32Be(entry->Xml().Bytes());
+        writer.Write(entry->Xml());
+        it++;
+    }
+    iLock.Signal();
+
+    // write a complete new file alongside the old one then rename it into place
+    // ...so a failure part way through never leaves a truncated or mixed cache behind
+    TBool written = false;
+    try {
+        IFile* file = IFile::Open(iTempFilename.CString(), eFileWriteOnly);
+        try {
+            file->Write(writer.Buffer());
+            file->Flush();
+            written = true;
+        }
+        catch (FileWriteError&) {
+            LOG2(kDevice, kError, "CpiDeviceCacheUpnp - error writing to %s\n", iTempFilename.CString());
+        }
+        delete file;
+    }
+    catch (FileOpenError&) {
+        LOG2(kDevice, kError, "CpiDeviceCacheUpnp - unable to open %s for writing\n", iTempFilename.CString());
+    }
+    if (!written) {
+        (void)remove(iTempFilename.CString());
+        return;
+    }
+    if (rename(iTempFilename.CString(), iFilename.CString()) != 0) {
+        // Windows won't rename over an existing file
+        (void)remove(iFilename.CString());
+        if (rename(iTempFilename.CString(), iFilename.CString()) != 0) {
+            LOG2(kDevice, kError, "CpiDeviceCacheUpnp - unable to replace %s\n", iFilename.CString());
+            (void)remove(iTempFilename.CString());
+        }
+    }
+}
+
+void CpiDeviceCacheUpnp::ScheduleSaveLocked()
+{
+    if (!iDirty) {
+        iDirty = true;
+        iSaveTimer->FireIn(kSaveDelayMs);
+    }
+}
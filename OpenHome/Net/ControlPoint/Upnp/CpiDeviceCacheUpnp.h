@@ -0,0 +1,95 @@
+/**
+ * Persistent cache of UPnP devices discovered by control points
+ *
+ * Allows device lists to report previously seen devices immediately on startup,
+ * revalidating them in the background, rather than waiting for msearch responses
+ * and device xml fetches to complete.
+ *
+ * This class is not intended for use outside this module.
+ */
+
+#ifndef HEADER_CPI_DEVICE_CACHE_UPNP
+#define HEADER_CPI_DEVICE_CACHE_UPNP
+
+#include <OpenHome/Types.h>
+#include <OpenHome/Buffer.h>
+#include <OpenHome/Private/Thread.h>
+#include <OpenHome/Private/Standard.h>
+
+#include <map>
+#include <vector>
+
+namespace OpenHome {
+class Environment;
+class Timer;
+namespace Net {
+
+class CpiDeviceCacheUpnp : private INonCopyable
+{
+public:
+    static const TUint kChecksumBytes = 16;
+    class Entry : private INonCopyable
+    {
+    public:
+        Entry(const Brx& aUdn, const Brx& aLocation, const Brx& aXml, const Brx& aETag, const Brx& aChecksum);
+        const Brx& Udn() const;
+        const Brx& Location() const;
+        const Brx& Xml() const;
+        const Brx& ETag() const;
+        const Brx& Checksum() const;
+    private:
+        Brh iUdn;
+        Brh iLocation;
+        Brh iXml;
+        Brh iETag;
+        Bws<kChecksumBytes> iChecksum;
+    };
+public:
+    /**
+     * Load any existing cache from aFilename.  A missing or corrupt file results
+     * in an empty cache; it is not an error.
+     */
+    CpiDeviceCacheUpnp(Environment& aEnv, const TChar* aFilename);
+    /**
+     * Writes any outstanding changes back to disk
+     */
+    ~CpiDeviceCacheUpnp();
+    /**
+     * Record (or update) the location, device xml and xml's ETag (which may be empty) for aUdn.
+     * Changes are written to disk shortly afterwards.
+     */
+    void Add(const Brx& aUdn, const Brx& aLocation, const Brx& aXml, const Brx& aETag);
+    void Remove(const Brx& aUdn);
+    /**
+     * Append copies of all cached entries to aEntries.
+     * The caller is responsible for deleting them.
+     */
+    void Snapshot(std::vector<Entry*>& aEntries) const;
+    /**
+     * Returns true if the cached xml for aUdn has checksum aChecksum
+     */
+    TBool Matches(const Brx& aUdn, const Brx& aChecksum) const;
+    static void Checksum(const Brx& aXml, Bwx& aChecksum);
+private:
+    typedef std::map<Brn,Entry*,BufferCmp> EntryMap;
+    void Load();
+    void SaveTimerExpired();
+    void Save();
+    void ScheduleSaveLocked();
+private:
+    static const TUint kVersion = 2;
+    static const TUint kSaveDelayMs = 5 * 1000;
+    static const Brn kMagic;
+    static const Brn kTempSuffix;
+    mutable Mutex iLock;
+    Brhz iFilename;
+    Brhz iTempFilename;
+    EntryMap iMap;
+    Timer* iSaveTimer;
+    TBool iDirty;
+};
+
+} // namespace Net
+} // namespace OpenHome
+
+#endif // HEADER_CPI_DEVICE_CACHE_UPNP
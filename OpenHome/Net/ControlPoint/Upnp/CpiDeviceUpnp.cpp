@@ -19,6 +19,7 @@
 #include <OpenHome/Private/NetworkAdapterList.h>
 #include <OpenHome/OsWrapper.h>
 #include <OpenHome/Net/Private/Globals.h>
+#include <OpenHome/Net/Private/CpiDeviceCacheUpnp.h>
 
 #include <string.h>
 
@@ -41,6 +42,7 @@ CpiDeviceUpnp::CpiDeviceUpnp(CpStack& aCpStack, const Brx& aUdn, const Brx& aLoc
     , iRemoved(false)
     , iNewLocation(NULL)
     , iXmlCheck(NULL)
+    , iRevalidate(false)
 {
     Environment& env = aCpStack.Env();
     iHostUdpIsLowQuality = env.InitParams()->IsHostUdpLowQuality();
@@ -78,6 +80,39 @@ void CpiDeviceUpnp::UpdateMaxAge(TUint aSeconds)
     }
 }
 
+TUint CpiDeviceUpnp::MaxAgeRemainingSecs() const
+{
+    OsContext* osCtx = iDevice->GetCpStack().Env().OsCtx();
+    TUint now = Os::TimeInMs(osCtx);
+    if (iExpiryTime <= now) {
+        return 0;
+    }
+    return (iExpiryTime - now) / 1000;
+}
+
+void CpiDeviceUpnp::SetXml(const Brx& aXml, const Brx& aETag, TBool aRevalidate)
+{
+    iXml.Set(aXml);
+    iETag.Set(aETag);
+    ParseXml();
+    iRevalidate = aRevalidate;
+}
+
+TBool CpiDeviceUpnp::HasXml() const
+{
+    return (iDeviceXml != NULL);
+}
+
+const Brx& CpiDeviceUpnp::Xml() const
+{
+    return iXml;
+}
+
+const Brx& CpiDeviceUpnp::ETag() const
+{
+    return iETag;
+}
+
 void CpiDeviceUpnp::FetchXml()
 {
     AutoMutex a(iLock);
@@ -90,6 +125,25 @@ void CpiDeviceUpnp::FetchXml()
     xmlFetchManager.Fetch(iXmlFetch);
 }
 
+void CpiDeviceUpnp::RevalidateXml()
+{
+    AutoMutex a(iLock);
+    if (!iRevalidate) {
+        return;
+    }
+    iRevalidate = false;
+    XmlFetchManager& xmlFetchManager = iDevice->GetCpStack().XmlFetchManager();
+    iXmlFetch = xmlFetchManager.Fetch();
+    Uri* uri = new Uri(iLocation);
+    iDevice->AddRef();
+    FunctorAsync functor = MakeFunctorAsync(*this, &CpiDeviceUpnp::XmlRevalidateCompleted);
+    iXmlFetch->Set(uri, functor);
+    if (iETag.Bytes() > 0) {
+        iXmlFetch->SetIfNoneMatch(iETag);
+    }
+    xmlFetchManager.Fetch(iXmlFetch);
+}
+
 void CpiDeviceUpnp::InterruptXmlFetch()
 {
     AutoMutex a(iLock);
@@ -394,6 +448,7 @@ void CpiDeviceUpnp::XmlFetchCompleted(IAsync& aAsync)
     if (!err) {
         try {
             XmlFetch::Xml(aAsync).TransferTo(iXml);
+            iETag.Set(XmlFetch::ETag(aAsync));
         }
         catch (XmlFetchError&) {
             err = true;
@@ -403,8 +458,7 @@ void CpiDeviceUpnp::XmlFetchCompleted(IAsync& aAsync)
     }
     if (!err) {
         try {
-            iDeviceXmlDocument = new DeviceXmlDocument(iXml);
-            iDeviceXml = new DeviceXml(iDeviceXmlDocument->Find(Udn()));
+            ParseXml();
         }
         catch (XmlError&) {
             err = true;
@@ -424,6 +478,43 @@ void CpiDeviceUpnp::XmlFetchCompleted(IAsync& aAsync)
     // just deleted this object!
 }
 
+void CpiDeviceUpnp::XmlRevalidateCompleted(IAsync& aAsync)
+{
+    iLock.Wait();
+    iXmlFetch = NULL;
+    iLock.Signal();
+    TBool err = false;
+    TBool notModified = false;
+    Brh xml;
+    Brh etag;
+    try {
+        notModified = XmlFetch::NotModified(aAsync);
+        if (!notModified) {
+            XmlFetch::Xml(aAsync).TransferTo(xml);
+            etag.Set(XmlFetch::ETag(aAsync));
+        }
+    }
+    catch (XmlFetchError&) {
+        err = true;
+        const Brx& udn = Udn();
+        LOG2(kDevice, kError, "Error revalidating xml for %.*s from %.*s\n", PBUF(udn), PBUF(iLocation));
+    }
+    iLock.Wait();
+    if (iList != NULL && !notModified) {
+        iList->XmlRevalidated(*this, err, xml, etag);
+    }
+    iLock.Signal();
+    iDevice->RemoveRef();
+    // Don't add code after the RemoveRef(), we might have
+    // just deleted this object!
+}
+
+void CpiDeviceUpnp::ParseXml()
+{
+    iDeviceXmlDocument = new DeviceXmlDocument(iXml);
+    iDeviceXml = new DeviceXml(iDeviceXmlDocument->Find(Udn()));
+}
+
 void CpiDeviceUpnp::XmlCheckCompleted(IAsync& aAsync)
 {
     iLock.Wait();
@@ -476,10 +567,12 @@ void CpiDeviceUpnp::Invocable::InvokeAction(Invocation& aInvocation)
 
 // CpiDeviceListUpnp
 
-CpiDeviceListUpnp::CpiDeviceListUpnp(CpStack& aCpStack, FunctorCpiDevice aAdded, FunctorCpiDevice aRemoved)
+CpiDeviceListUpnp::CpiDeviceListUpnp(CpStack& aCpStack, FunctorCpiDevice aAdded, FunctorCpiDevice aRemoved,
+                                     const SsdpNotifyFilter& aNotifyFilter)
     : CpiDeviceList(aCpStack, aAdded, aRemoved)
     , iSsdpLock("DLSM")
     , iEnv(aCpStack.Env())
+    , iNotifyFilter(aNotifyFilter)
     , iStarted(false)
     , iNoRemovalsFromRefresh(false)
 {
@@ -502,7 +595,7 @@ CpiDeviceListUpnp::CpiDeviceListUpnp(CpStack& aCpStack, FunctorCpiDevice aAdded,
         iInterface = current->Address();
         iUnicastListener = new SsdpListenerUnicast(iCpStack.Env(), *this, iInterface);
         iMulticastListener = &(iCpStack.Env().MulticastListenerClaim(iInterface));
-        iNotifyHandlerId = iMulticastListener->AddNotifyHandler(this);
+        iNotifyHandlerId = iMulticastListener->AddNotifyHandler(this, iNotifyFilter);
     }
     iSsdpLock.Signal();
     iCpStack.Env().AddResumeObserver(*this);
@@ -585,10 +678,13 @@ void CpiDeviceListUpnp::DoStart()
     iStarted = true;
     iLock.Signal();
     if (needsStart) {
-        AutoMutex a(iSsdpLock);
-        if (iUnicastListener != NULL) {
-            iUnicastListener->Start();
+        {
+            AutoMutex a(iSsdpLock);
+            if (iUnicastListener != NULL) {
+                iUnicastListener->Start();
+            }
         }
+        AddCachedDevices();
     }
 }
 
@@ -629,9 +725,19 @@ void CpiDeviceListUpnp::DoRefresh()
                     else remove it from iMap and report this to observer */
 }
 
+TBool CpiDeviceListUpnp::IsCachedDeviceWanted(const Brx& /*aUdn*/, const DeviceXmlDocument& /*aDocument*/, const DeviceXml& /*aDevice*/)
+{
+    return true;
+}
+
 TBool CpiDeviceListUpnp::IsDeviceReady(CpiDevice& aDevice)
 {
-    reinterpret_cast<CpiDeviceUpnp*>(aDevice.OwnerData())->FetchXml();
+    CpiDeviceUpnp* device = reinterpret_cast<CpiDeviceUpnp*>(aDevice.OwnerData());
+    if (device->HasXml()) {
+        device->RevalidateXml();
+        return true;
+    }
+    device->FetchXml();
     return false;
 }
 
@@ -724,7 +830,7 @@ void CpiDeviceListUpnp::HandleInterfaceChange()
         iUnicastListener = new SsdpListenerUnicast(iCpStack.Env(), *this, iInterface);
         iUnicastListener->Start();
         iMulticastListener = &(iCpStack.Env().MulticastListenerClaim(iInterface));
-        iNotifyHandlerId = iMulticastListener->AddNotifyHandler(this);
+        iNotifyHandlerId = iMulticastListener->AddNotifyHandler(this, iNotifyFilter);
     }
     Refresh();
 }
@@ -748,20 +854,110 @@ void CpiDeviceListUpnp::RemoveAll()
     }
 }
 
+void CpiDeviceListUpnp::AddCachedDevices()
+{
+    CpiDeviceCacheUpnp* cache = iCpStack.DeviceCacheUpnp();
+    if (cache == NULL) {
+        return;
+    }
+    std::vector<CpiDeviceCacheUpnp::Entry*> entries;
+    cache->Snapshot(entries);
+    /* Cached devices are only kept beyond the initial refresh if they respond to
+       an msearch or send an alive message */
+    const TUint maxAgeSecs = (iEnv.InitParams()->MsearchTimeSecs() + 1) * kRefreshRetries;
+    for (TUint i=0; i<(TUint)entries.size(); i++) {
+        CpiDeviceCacheUpnp::Entry* entry = entries[i];
+        if (IsLocationReachable(entry->Location())) {
+            TBool wanted = false;
+            try {
+                DeviceXmlDocument document(entry->Xml());
+                DeviceXml device(document.Find(entry->Udn()));
+                wanted = IsCachedDeviceWanted(entry->Udn(), document, device);
+            }
+            catch (XmlError&) {
+                const Brx& udn = entry->Udn();
+                LOG2(kDevice, kError, "Cached xml for %.*s is invalid\n", PBUF(udn));
+            }
+            if (wanted) {
+                CpiDeviceUpnp* device = new CpiDeviceUpnp(iCpStack, entry->Udn(), entry->Location(), maxAgeSecs, *this, *this);
+                device->SetXml(entry->Xml(), entry->ETag(), true);
+                Add(&device->Device());
+            }
+        }
+        delete entry;
+    }
+}
+
+void CpiDeviceListUpnp::ByeBye(const Brx& aUdn)
+{
+    CpiDeviceCacheUpnp* cache = iCpStack.DeviceCacheUpnp();
+    if (cache != NULL) {
+        cache->Remove(aUdn);
+    }
+    Remove(aUdn);
+}
+
 void CpiDeviceListUpnp::XmlFetchCompleted(CpiDeviceUpnp& aDevice, TBool aError)
 {
+    CpiDeviceCacheUpnp* cache = iCpStack.DeviceCacheUpnp();
     if (aError) {
         const Brx& udn = aDevice.Udn();
         const Brx& location = aDevice.Location();
         LOG2(kTrace, kError, "Device xml fetch error {udn{%.*s}, location{%.*s}}\n",
                              PBUF(udn), PBUF(location));
+        if (cache != NULL) {
+            cache->Remove(udn);
+        }
         Remove(aDevice.Udn());
     }
     else {
+        if (cache != NULL) {
+            cache->Add(aDevice.Udn(), aDevice.Location(), aDevice.Xml(), aDevice.ETag());
+        }
         SetDeviceReady(aDevice.Device());
     }
 }
 
+void CpiDeviceListUpnp::XmlRevalidated(CpiDeviceUpnp& aDevice, TBool aError, const Brx& aXml, const Brx& aETag)
+{
+    CpiDeviceCacheUpnp* cache = iCpStack.DeviceCacheUpnp();
+    const Brx& udn = aDevice.Udn();
+    if (aError) {
+        if (cache != NULL) {
+            cache->Remove(udn);
+        }
+        Remove(udn);
+        return;
+    }
+    if (aXml == aDevice.Xml()) {
+        if (cache != NULL && aETag != aDevice.ETag()) {
+            cache->Add(udn, aDevice.Location(), aXml, aETag);
+        }
+        return;
+    }
+    /* Device xml has changed since it was cached.  Clients will have already seen the
+       old version so report the device as removed then added again */
+    LOG(kDevice, "Xml for cached device %.*s has changed\n", PBUF(udn));
+    if (cache != NULL) {
+        cache->Add(udn, aDevice.Location(), aXml, aETag);
+    }
+    CpiDeviceUpnp* device = new CpiDeviceUpnp(iCpStack, udn, aDevice.Location(), aDevice.MaxAgeRemainingSecs(), *this, *this);
+    try {
+        device->SetXml(aXml, aETag, false);
+    }
+    catch (XmlError&) {
+        LOG2(kDevice, kError, "Error within xml for %.*s.  Xml is %.*s\n", PBUF(udn), PBUF(aXml));
+        device->Device().RemoveRef();
+        if (cache != NULL) {
+            cache->Remove(udn);
+        }
+        Remove(udn);
+        return;
+    }
+    Remove(udn);
+    Add(&device->Device());
+}
+
 void CpiDeviceListUpnp::DeviceLocationChanged(CpiDeviceUpnp* aOriginal, CpiDeviceUpnp* aNew)
 {
     Remove(aOriginal->Udn());
@@ -792,22 +988,22 @@ void CpiDeviceListUpnp::SsdpNotifyServiceTypeAlive(const Brx& aUuid, const Brx&
 
 void CpiDeviceListUpnp::SsdpNotifyRootByeBye(const Brx& aUuid)
 {
-    Remove(aUuid);
+    ByeBye(aUuid);
 }
 
 void CpiDeviceListUpnp::SsdpNotifyUuidByeBye(const Brx& aUuid)
 {
-    Remove(aUuid);
+    ByeBye(aUuid);
 }
 
 void CpiDeviceListUpnp::SsdpNotifyDeviceTypeByeBye(const Brx& aUuid, const Brx& /*aDomain*/, const Brx& /*aType*/, TUint /*aVersion*/)
 {
-    Remove(aUuid);
+    ByeBye(aUuid);
 }
 
 void CpiDeviceListUpnp::SsdpNotifyServiceTypeByeBye(const Brx& aUuid, const Brx& /*aDomain*/, const Brx& /*aType*/, TUint /*aVersion*/)
 {
-    Remove(aUuid);
+    ByeBye(aUuid);
 }
 
 void CpiDeviceListUpnp::NotifyResumed()
@@ -884,7 +1080,7 @@ void CpiDeviceListUpnpAll::SsdpNotification(const Brx& aUuid, const Brx& aLocati
 // CpiDeviceListUpnpRoot
 
 CpiDeviceListUpnpRoot::CpiDeviceListUpnpRoot(CpStack& aCpStack, FunctorCpiDevice aAdded, FunctorCpiDevice aRemoved)
-    : CpiDeviceListUpnp(aCpStack, aAdded, aRemoved)
+    : CpiDeviceListUpnp(aCpStack, aAdded, aRemoved, SsdpNotifyFilter::Root())
 {
 }
 
@@ -922,10 +1118,16 @@ void CpiDeviceListUpnpRoot::SsdpNotifyRootAlive(const Brx& aUuid, const Brx& aLo
 }
 
 
+TBool CpiDeviceListUpnpRoot::IsCachedDeviceWanted(const Brx& aUdn, const DeviceXmlDocument& aDocument, const DeviceXml& /*aDevice*/)
+{
+    return (aDocument.Root().Udn() == aUdn);
+}
+
+
 // CpiDeviceListUpnpUuid
 
 CpiDeviceListUpnpUuid::CpiDeviceListUpnpUuid(CpStack& aCpStack, const Brx& aUuid, FunctorCpiDevice aAdded, FunctorCpiDevice aRemoved)
-    : CpiDeviceListUpnp(aCpStack, aAdded, aRemoved)
+    : CpiDeviceListUpnp(aCpStack, aAdded, aRemoved, SsdpNotifyFilter::Uuid(aUuid))
     , iUuid(aUuid)
 {
 }
@@ -967,11 +1169,17 @@ void CpiDeviceListUpnpUuid::SsdpNotifyUuidAlive(const Brx& aUuid, const Brx& aLo
 }
 
 
+TBool CpiDeviceListUpnpUuid::IsCachedDeviceWanted(const Brx& aUdn, const DeviceXmlDocument& /*aDocument*/, const DeviceXml& /*aDevice*/)
+{
+    return (aUdn == iUuid);
+}
+
+
 // CpiDeviceListUpnpDeviceType
 
 CpiDeviceListUpnpDeviceType::CpiDeviceListUpnpDeviceType(CpStack& aCpStack, const Brx& aDomainName, const Brx& aDeviceType,
                                                          TUint aVersion, FunctorCpiDevice aAdded, FunctorCpiDevice aRemoved)
-    : CpiDeviceListUpnp(aCpStack, aAdded, aRemoved)
+    : CpiDeviceListUpnp(aCpStack, aAdded, aRemoved, SsdpNotifyFilter::DeviceType(aDomainName, aDeviceType))
     , iDomainName(aDomainName)
     , iDeviceType(aDeviceType)
     , iVersion(aVersion)
@@ -1016,11 +1224,28 @@ void CpiDeviceListUpnpDeviceType::SsdpNotifyDeviceTypeAlive(const Brx& aUuid, co
 }
 
 
+TBool CpiDeviceListUpnpDeviceType::IsCachedDeviceWanted(const Brx& /*aUdn*/, const DeviceXmlDocument& /*aDocument*/, const DeviceXml& aDevice)
+{
+    Bwh deviceType(iDomainName.Bytes() + 1 + iDeviceType.Bytes());
+    deviceType.Append(iDomainName);
+    deviceType.Append('.');
+    deviceType.Append(iDeviceType);
+    try {
+        return (Ascii::Uint(aDevice.DeviceTypeVersion(deviceType)) >= iVersion);
+    }
+    catch (XmlError&) {
+    }
+    catch (AsciiError&) {
+    }
+    return false;
+}
+
+
 // CpiDeviceListUpnpServiceType
 
 CpiDeviceListUpnpServiceType::CpiDeviceListUpnpServiceType(CpStack& aCpStack, const Brx& aDomainName, const Brx& aServiceType,
                                                            TUint aVersion, FunctorCpiDevice aAdded, FunctorCpiDevice aRemoved)
-    : CpiDeviceListUpnp(aCpStack, aAdded, aRemoved)
+    : CpiDeviceListUpnp(aCpStack, aAdded, aRemoved, SsdpNotifyFilter::ServiceType(aDomainName, aServiceType))
     , iDomainName(aDomainName)
     , iServiceType(aServiceType)
     , iVersion(aVersion)
@@ -1063,3 +1288,19 @@ void CpiDeviceListUpnpServiceType::SsdpNotifyServiceTypeAlive(const Brx& aUuid,
         Add(&device->Device());
     }
 }
+
+TBool CpiDeviceListUpnpServiceType::IsCachedDeviceWanted(const Brx& /*aUdn*/, const DeviceXmlDocument& /*aDocument*/, const DeviceXml& aDevice)
+{
+    Bwh serviceType(iDomainName.Bytes() + 1 + iServiceType.Bytes());
+    serviceType.Append(iDomainName);
+    serviceType.Append('.');
+    serviceType.Append(iServiceType);
+    try {
+        return (Ascii::Uint(aDevice.ServiceVersion(serviceType)) >= iVersion);
+    }
+    catch (XmlError&) {
+    }
+    catch (AsciiError&) {
+    }
+    return false;
+}
@@ -47,7 +47,26 @@ public:
      */
     void UpdateMaxAge(TUint aSeconds);
 
+    /**
+     * Returns the number of seconds until this device will expire unless another
+     * alive message is received.
+     */
+    TUint MaxAgeRemainingSecs() const;
+
+    /**
+     * Use device xml (plus its ETag, which may be empty) from an earlier run (or fetch)
+     * rather than downloading it.
+     * Throws XmlError if aXml doesn't describe this device.
+     * If aRevalidate is true, the xml will be re-fetched in the background once the
+     * device is added to a list and the device will be replaced if it has changed.
+     */
+    void SetXml(const Brx& aXml, const Brx& aETag, TBool aRevalidate);
+    TBool HasXml() const;
+    const Brx& Xml() const;
+    const Brx& ETag() const;
+
     void FetchXml();
+    void RevalidateXml();
     void InterruptXmlFetch();
     void CheckStillAvailable(CpiDeviceUpnp* aNewDevice);
 private: // ICpiProtocol
@@ -67,6 +86,8 @@ private:
     void GetServiceUri(Uri& aUri, const TChar* aType, const ServiceType& aServiceType);
     void XmlFetchCompleted(IAsync& aAsync);
     void XmlCheckCompleted(IAsync& aAsync);
+    void XmlRevalidateCompleted(IAsync& aAsync);
+    void ParseXml();
     static TBool UdnMatches(const Brx& aFound, const Brx& aTarget);
 private:
     class Invocable : public IInvocable, private INonCopyable
@@ -83,6 +104,7 @@ private:
     Brhz iLocation;
     XmlFetch* iXmlFetch;
     Brh iXml;
+    Brh iETag;
     DeviceXmlDocument* iDeviceXmlDocument;
     DeviceXml* iDeviceXml;
     Timer* iTimer;
@@ -95,6 +117,7 @@ private:
     TBool iHostUdpIsLowQuality;
     CpiDeviceUpnp* iNewLocation;
     XmlFetch* iXmlCheck;
+    TBool iRevalidate;
     friend class Invocable;
 };
 
@@ -107,9 +130,11 @@ class CpiDeviceListUpnp : public CpiDeviceList, public ISsdpNotifyHandler, priva
 {
 public:
     void XmlFetchCompleted(CpiDeviceUpnp& aDevice, TBool aError);
+    void XmlRevalidated(CpiDeviceUpnp& aDevice, TBool aError, const Brx& aXml, const Brx& aETag);
     void DeviceLocationChanged(CpiDeviceUpnp* aOriginal, CpiDeviceUpnp* aNew);
 protected:
-    CpiDeviceListUpnp(CpStack& aCpStack, FunctorCpiDevice aAdded, FunctorCpiDevice aRemoved);
+    CpiDeviceListUpnp(CpStack& aCpStack, FunctorCpiDevice aAdded, FunctorCpiDevice aRemoved,
+                      const SsdpNotifyFilter& aNotifyFilter = SsdpNotifyFilter());
     ~CpiDeviceListUpnp();
 
     void StopListeners();
@@ -124,6 +149,13 @@ protected:
     TBool Update(const Brx& aUdn, const Brx& aLocation, TUint aMaxAge);
     void DoStart();
     void DoRefresh();
+
+    /**
+     * Called for each device in the persistent cache when the list is started.
+     * Returns whether the device would have been added to this list had it been
+     * discovered via ssdp.  Throws XmlError if the cached xml is unusable.
+     */
+    virtual TBool IsCachedDeviceWanted(const Brx& aUdn, const DeviceXmlDocument& aDocument, const DeviceXml& aDevice);
 protected: // from CpiDeviceList
     void Start();
     void Refresh();
@@ -149,6 +181,8 @@ private:
     void SubnetListChanged();
     void HandleInterfaceChange();
     void RemoveAll();
+    void AddCachedDevices();
+    void ByeBye(const Brx& aUdn);
 protected:
     SsdpListenerUnicast* iUnicastListener;
     Mutex iSsdpLock;
@@ -159,6 +193,7 @@ private:
     Environment& iEnv;
     TIpAddress iInterface;
     SsdpListenerMulticast* iMulticastListener;
+    SsdpNotifyFilter iNotifyFilter;
     TInt iNotifyHandlerId;
     TUint iInterfaceChangeListenerId;
     TUint iSubnetListChangeListenerId;
@@ -202,6 +237,8 @@ public:
     ~CpiDeviceListUpnpRoot();
     void Start();
     void SsdpNotifyRootAlive(const Brx& aUuid, const Brx& aLocation, TUint aMaxAge);
+private:
+    TBool IsCachedDeviceWanted(const Brx& aUdn, const DeviceXmlDocument& aDocument, const DeviceXml& aDevice);
 };
 
 /**
@@ -216,6 +253,8 @@ public:
     ~CpiDeviceListUpnpUuid();
     void Start();
     void SsdpNotifyUuidAlive(const Brx& aUuid, const Brx& aLocation, TUint aMaxAge);
+private:
+    TBool IsCachedDeviceWanted(const Brx& aUdn, const DeviceXmlDocument& aDocument, const DeviceXml& aDevice);
 private:
     Brh iUuid;
 };
@@ -234,6 +273,8 @@ public:
     void Start();
     void SsdpNotifyDeviceTypeAlive(const Brx& aUuid, const Brx& aDomain, const Brx& aType, TUint aVersion,
                                    const Brx& aLocation, TUint aMaxAge);
+private:
+    TBool IsCachedDeviceWanted(const Brx& aUdn, const DeviceXmlDocument& aDocument, const DeviceXml& aDevice);
 private:
     Brh iDomainName;
     Brh iDeviceType;
@@ -254,6 +295,8 @@ public:
     void Start();
     void SsdpNotifyServiceTypeAlive(const Brx& aUuid, const Brx& aDomain, const Brx& aType, TUint aVersion,
                                     const Brx& aLocation, TUint aMaxAge);
+private:
+    TBool IsCachedDeviceWanted(const Brx& aUdn, const DeviceXmlDocument& aDocument, const DeviceXml& aDevice);
 private:
     Brh iDomainName;
     Brh iServiceType;
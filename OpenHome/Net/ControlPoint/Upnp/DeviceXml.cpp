@@ -76,6 +76,11 @@ Brn DeviceXml::Find(const Brx& aUdn)
     }
 }
 
+const Brx& DeviceXml::Udn() const
+{
+    return (iUdn);
+}
+
 void DeviceXml::GetFriendlyName(Brh& aValue) const
 {
     Bwh friendlyName(XmlParserBasic::Find("friendlyName", iXml));
@@ -92,18 +97,60 @@ void DeviceXml::GetPresentationUrl(Brh& aValue) const
 
 Brn DeviceXml::ServiceVersion(const Brx& aServiceType) const
 {
-    const TUint kMaxDomainBytes = 64;
-    const TUint kMaxTypeBytes = 64;
+    Bws<kMaxDomainBytes> upnpDomain;
+    Bws<kMaxTypeBytes> upnpType;
+    SplitCanonicalType(aServiceType, upnpDomain, upnpType);
+
+    Brn serviceList = XmlParserBasic::Find("serviceList", iXml);
     
-    Bws<kMaxDomainBytes> domain;
+    for (;;) {
+        Brn service = XmlParserBasic::Find("service", serviceList, serviceList);
+        Brn type = XmlParserBasic::Find("serviceType", service);
+
+        Parser parser2(type);
+        
+        if (parser2.Next(':') == Brn("urn")) {
+            if (parser2.Next(':') == upnpDomain) {
+                if (parser2.Next(':') == Brn("service")) {
+                    if (parser2.Next(':') == upnpType) {
+                        return (parser2.Remaining());
+                    }
+                }
+            }
+        }
+    }
+}
+
+Brn DeviceXml::DeviceTypeVersion(const Brx& aDeviceType) const
+{
+    Bws<kMaxDomainBytes> upnpDomain;
     Bws<kMaxTypeBytes> upnpType;
+    SplitCanonicalType(aDeviceType, upnpDomain, upnpType);
+
+    Brn type = XmlParserBasic::Find("deviceType", iXml);
+    Parser parser(type);
+    if (parser.Next(':') == Brn("urn")) {
+        if (parser.Next(':') == upnpDomain) {
+            if (parser.Next(':') == Brn("device")) {
+                if (parser.Next(':') == upnpType) {
+                    return (parser.Remaining());
+                }
+            }
+        }
+    }
+    THROW(XmlError);
+}
+
+void DeviceXml::SplitCanonicalType(const Brx& aCanonicalType, Bwx& aUpnpDomain, Bwx& aUpnpType)
+{
+    Bws<kMaxDomainBytes> domain;
     
-    Parser parser(aServiceType);
+    Parser parser(aCanonicalType);
     
     TUint count = 0;
     
     while (!parser.Finished()) {
-        upnpType.Replace(parser.Next('.'));
+        aUpnpType.Replace(parser.Next('.'));
         count++;
     }
 
@@ -119,26 +166,5 @@ Brn DeviceXml::ServiceVersion(const Brx& aServiceType) const
         domain.Append(element);
     }
     
-    Bws<kMaxDomainBytes> upnpDomain;
-    
-    Ssdp::CanonicalDomainToUpnp(domain, upnpDomain);
-    
-    Brn serviceList = XmlParserBasic::Find("serviceList", iXml);
-    
-    for (;;) {
-        Brn service = XmlParserBasic::Find("service", serviceList, serviceList);
-        Brn type = XmlParserBasic::Find("serviceType", service);
-
-        Parser parser2(type);
-        
-        if (parser2.Next(':') == Brn("urn")) {
-            if (parser2.Next(':') == upnpDomain) {
-                if (parser2.Next(':') == Brn("service")) {
-                    if (parser2.Next(':') == upnpType) {
-                        return (parser2.Remaining());
-                    }
-                }
-            }
-        }
-    }
+    Ssdp::CanonicalDomainToUpnp(domain, aUpnpDomain);
 }
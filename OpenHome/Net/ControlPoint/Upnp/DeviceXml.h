@@ -16,10 +16,16 @@ class DeviceXml
 public:
     DeviceXml(const Brx& aXml);
     Brn Find(const Brx& aUdn);
+    const Brx& Udn() const;
     void GetFriendlyName(Brh& aValue) const;
     void GetPresentationUrl(Brh& aValue) const;
     Brn ServiceVersion(const Brx& aService) const; // e.g "upnp.org.ContentDirectory"
+    Brn DeviceTypeVersion(const Brx& aDeviceType) const; // e.g "upnp.org.MediaRenderer"
 private:
+    static void SplitCanonicalType(const Brx& aCanonicalType, Bwx& aUpnpDomain, Bwx& aUpnpType);
+private:
+    static const TUint kMaxDomainBytes = 64;
+    static const TUint kMaxTypeBytes = 64;
     Brn iXml;
     Brn iUdn;
 };
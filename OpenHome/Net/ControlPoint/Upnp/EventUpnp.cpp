@@ -12,6 +12,8 @@
 #include <OpenHome/Net/Private/ProtocolUpnp.h>
 #include <OpenHome/Private/Parser.h>
 
+#include <string.h>
+
 using namespace OpenHome;
 using namespace OpenHome::Net;
 
@@ -19,15 +21,43 @@ const Brn EventSessionUpnp::kMethodNotify("NOTIFY");
 const Brn EventSessionUpnp::kExpectedNt("upnp:event");
 const Brn EventSessionUpnp::kExpectedNts("upnp:propchange");
 
+// EventSessionCount
+
+EventSessionCount::EventSessionCount(TUint aSessions)
+    : iLock("EVSC")
+    , iSessions(aSessions)
+    , iBusy(0)
+{
+}
+
+void EventSessionCount::Started()
+{
+    AutoMutex a(iLock);
+    iBusy++;
+}
+
+void EventSessionCount::Finished()
+{
+    AutoMutex a(iLock);
+    iBusy--;
+}
+
+TBool EventSessionCount::AllBusy() const
+{
+    AutoMutex a(iLock);
+    return (iBusy >= iSessions);
+}
+
+
 // EventSessionUpnp
 
-EventSessionUpnp::EventSessionUpnp(CpStack& aCpStack)
+EventSessionUpnp::EventSessionUpnp(CpStack& aCpStack, EventSessionCount& aSessionCount)
     : iCpStack(aCpStack)
+    , iSessionCount(aSessionCount)
     , iShutdownSem("EVSD", 1)
 {
     iReadBuffer = new Srs<1024>(*this);
     iReaderUntil = new ReaderUntilS<1024>(*iReadBuffer);
-    iDechunker = new ReaderHttpChunked(*iReaderUntil);
     iReaderRequest = new ReaderHttpRequest(aCpStack.Env(), *iReaderUntil);
 
     iReaderRequest->AddMethod(kMethodNotify);
@@ -37,6 +67,8 @@ EventSessionUpnp::EventSessionUpnp(CpStack& aCpStack)
     iReaderRequest->AddHeader(iHeaderSeq);
     iReaderRequest->AddHeader(iHeaderContentLength);
     iReaderRequest->AddHeader(iHeaderTransferEncoding);
+    iReaderRequest->AddHeader(iHeaderConnection);
+    iReadTimer = new Timer(aCpStack.Env(), MakeFunctor(*this, &EventSessionUpnp::ReadTimeout), "EventSessionUpnp");
 }
 
 EventSessionUpnp::~EventSessionUpnp()
@@ -44,7 +76,7 @@ EventSessionUpnp::~EventSessionUpnp()
     Interrupt(true);
     iShutdownSem.Wait();
 
-    delete iDechunker;
+    delete iReadTimer;
     delete iReaderUntil;
     delete iReadBuffer;
     delete iReaderRequest;
@@ -75,13 +107,24 @@ void EventSessionUpnp::LogError(CpiSubscription* aSubscription, const TChar* /*a
 void EventSessionUpnp::Run()
 {
     AutoSemaphore a(iShutdownSem);
+    iSessionCount.Started();
+    iReaderUntil->ReadFlush();
+    iReaderRequest->Flush();
+    // publishers may send further (possibly pipelined) NOTIFYs over a persistent connection
+    TBool keptAlive = false;
+    while (ProcessRequest(keptAlive)) {
+        keptAlive = true;
+    }
+    iSessionCount.Finished();
+}
+
+TBool EventSessionUpnp::ProcessRequest(TBool aKeptAlive)
+{
     CpiSubscription* subscription = NULL;
+    TBool keepAlive = false;
     iErrorStatus = &HttpStatus::kOk;
-    iDechunker->SetChunked(false);
-    iDechunker->ReadFlush();
     try {
-        iReaderRequest->Flush();
-        iReaderRequest->Read(kReadTimeoutMs);
+        iReaderRequest->Read(aKeptAlive? kKeepAliveTimeoutMs : kReadTimeoutMs);
         // check headers
         if (iReaderRequest->MethodNotAllowed()) {
             Error(HttpStatus::kBadRequest);
@@ -116,175 +159,325 @@ void EventSessionUpnp::Run()
         }
     }
     catch(HttpError&) {}
-    catch(ReaderError&) {}
+    catch(ReaderError&) {
+        if (aKeptAlive) {
+            return false; // persistent connection closed or idle for too long
+        }
+    }
 
     try {
+        /* the connection can only be reused if we'll read the whole entity and know where it ends.
+           A ContentLength of 0 is treated as unknown, meaning the entity ends when the socket closes.
+           It is closed anyway if every session is busy so that one is always free for other publishers */
+        keepAlive = (subscription != NULL && iReaderRequest->Version() == Http::eHttp11 && !iHeaderConnection.Close() &&
+                     (iHeaderTransferEncoding.IsChunked() || iHeaderContentLength.ContentLength() > 0) &&
+                     !iSessionCount.AllBusy());
+
         // write response
         Sws<128> writerBuffer(*this);
         WriterHttpResponse response(writerBuffer);
         response.WriteStatus(*iErrorStatus, Http::eHttp11);
+        if (keepAlive) {
+            Http::WriteHeaderContentLength(response, 0);
+        }
+        else {
+            Http::WriteHeaderConnectionClose(response);
+        }
         response.WriteFlush();
 
-        // read entity
+        // read and process entity
         if (subscription != NULL) {
-            Bwh entity;
-            WriterBwh writer(1024);
-            if (iHeaderTransferEncoding.IsChunked()) {
-                iDechunker->SetChunked(true);
-                for (;;) {
-                    Brn buf = iDechunker->Read(kMaxReadBytes);
-                    writer.Write(buf);
-                    if (buf.Bytes() == 0) { // end of stream
-                        break;
-                    }
-                }
-            }
-            else {
-                TUint length = iHeaderContentLength.ContentLength();
-                if (length == 0) {
-                    // no Content-Length header, so read until remote socket closed (so ReaderError is thrown)
-                    try {
-                        for (;;) {
-                            writer.Write(iReaderUntil->Read(kMaxReadBytes));
-                        }
-                    }
-                    catch (ReaderError&) {
-                    }
-                } else {
-                    TUint remaining = length;
-                    do {
-                        TUint bytes = remaining;
-                        if (bytes > kMaxReadBytes) {
-                            bytes = kMaxReadBytes;
-                        }
-                        Brn buf = iReaderUntil->Read(bytes);
-                        remaining -= buf.Bytes();
-                        writer.Write(buf);
-                    } while (remaining > 0);
-                }
-            }
-            writer.TransferTo(entity);
-
-            // process entity
             {
                 const Brx& sid = iHeaderSid.Sid();
                 LOG(kEvent, "EventSessionUpnp::Run, sid - %.*s seq - %u\n", PBUF(sid), iHeaderSeq.Seq());
             }
 
-            /* defer validating the seq number till now to avoid holding subscription's lock during
-               potentially long-running network reads */
-            if (subscription->UpdateSequenceNumber(iHeaderSeq.Seq())) {
+            /* properties are passed on as they are read, to be staged by the proxy until the
+               whole update can be committed.  No subscription lock is held during network
+               reads; StartNotification only orders this update behind any earlier ones
+               for the same subscription.  The whole entity must be read within kEntityTimeoutMs. */
+            TBool seqOk = subscription->StartNotification(iHeaderSeq.Seq());
+            if (seqOk) {
+                iReadTimer->FireIn(kEntityTimeoutMs);
                 try {
-                    ProcessNotification(*subscription, entity);
+                    if (!ProcessNotification(*subscription)) {
+                        keepAlive = false;
+                    }
                 }
                 catch (Exception& ex) {
                     Log::Print("EventSessionUpnp::Run() unexpected exception %s from %s:%u\n", ex.Message(), ex.File(), ex.Line());
                     ASSERTS(); // ProcessNotification isn't expected to throw
                 }
-                subscription->Unlock();
+                iReadTimer->Cancel();
+                subscription->EndNotification();
             }
             else {
+                keepAlive = false; // entity hasn't been read
                 subscription->SetNotificationError();
             }
         }
     }
     catch(HttpError&) {
+        keepAlive = false;
         LogError(subscription, "HttpError");
     }
     catch(ReaderError&) {
+        keepAlive = false;
         LogError(subscription, "ReaderError");
     }
     catch(WriterError&) {
+        keepAlive = false;
         LogError(subscription, "WriterError");
     }
     catch(NetworkError&) {
+        keepAlive = false;
         LogError(subscription, "NetworkError");
     }
     catch(XmlError&) {
+        keepAlive = false;
         LogError(subscription, "XmlError");
     }
     if (subscription != NULL) {
         subscription->RemoveRef();
-    }    
+    }
+    return keepAlive;
 }
 
-void EventSessionUpnp::ProcessNotification(IEventProcessor& aEventProcessor, const Brx& aEntity)
+TBool EventSessionUpnp::ProcessNotification(IEventProcessor& aEventProcessor)
 {
     aEventProcessor.EventUpdateStart();
-    OutputProcessorUpnp outputProcessor;
-    Brn propertySet = XmlParserBasic::Find("propertyset", aEntity);
-    Brn prop;
-    Brn remaining;
+    iPropertySet.Start(aEventProcessor);
     try {
+        ReadEntity();
+        iPropertySet.End();
+        aEventProcessor.EventUpdateEnd();
+        return true;
+    }
+    catch (XmlError&) {
+        aEventProcessor.EventUpdateError();
+    }
+    // failures reading the entity discard any values already staged; EventUpdateError triggers a resubscribe
+    catch (ReaderError&) {
+        LOG2(kEvent, kError, "EventSessionUpnp: ReaderError reading entity\n");
+        aEventProcessor.EventUpdateError();
+    }
+    catch (HttpError&) {
+        LOG2(kEvent, kError, "EventSessionUpnp: HttpError reading entity\n");
+        aEventProcessor.EventUpdateError();
+    }
+    return false;
+}
+
+void EventSessionUpnp::ReadEntity()
+{
+    if (iHeaderTransferEncoding.IsChunked()) {
+        /* Chunks are decoded here rather than by ReaderHttpChunked.  That buffers ahead of the
+           chunk sizes it reads so would swallow the start of any pipelined request. */
         for (;;) {
+            Parser parser(iReaderUntil->ReadUntil(Ascii::kLf));
+            Brn sizeBuf = Ascii::Trim(parser.Next(';')); // ignore any chunk extensions
+            TUint bytes;
             try {
-                prop.Set(XmlParserBasic::Find("property", propertySet, remaining));
+                bytes = Ascii::UintHex(sizeBuf);
             }
-            catch (XmlError&) {
-                // we've successfully processed all <property> tags from aEntity
-                break;
-            }
-            prop.Set(Ascii::Trim(prop));
-            if (prop.Bytes() < 8 || prop[0] != '<' || prop[1] == '/') {
-                THROW(XmlError);
-            }
-            Parser parser(prop);
-            (void)parser.Next('<');
-            Brn tagNameFull = parser.Next('>');
-            Brn tagName = tagNameFull;
-            TUint bytes = tagNameFull.Bytes();
-            TUint i;
-            for (i = 0; i < bytes; i++) {
-                if (Ascii::IsWhitespace(tagNameFull[i])) {
-                    break;
-                }
+            catch (AsciiError&) {
+                THROW(HttpError);
             }
-            if (i < bytes) {
-                tagName.Set(tagNameFull.Split(0, i));
+            if (bytes == 0) {
+                break;
             }
-            Brn val;
-            if (bytes > 0 && tagNameFull[bytes-1] == '/') {
-                // empty element tag
-                val.Set(Brx::Empty());
-                if (i == bytes) { // no white space before '/'
-                    tagName.Set(tagName.Split(0, bytes-1));
+            ReadEntityBytes(bytes);
+            (void)iReaderUntil->ReadUntil(Ascii::kLf); // CRLF following chunk data
+        }
+        // skip any trailer, up to the empty line which ends the entity
+        while (Ascii::Trim(iReaderUntil->ReadUntil(Ascii::kLf)).Bytes() > 0) {
+        }
+    }
+    else {
+        TUint length = iHeaderContentLength.ContentLength();
+        if (length == 0) {
+            // no Content-Length header, so read until remote socket closed (so ReaderError is thrown)
+            try {
+                for (;;) {
+                    iPropertySet.Parse(iReaderUntil->Read(kMaxReadBytes));
                 }
             }
-            else {
-                val.Set(parser.Next('<'));
-                Brn closingTag = parser.Next('/');
-                closingTag.Set(parser.Next('>'));
-                if (tagName != closingTag) {
-                    THROW(XmlError);
-                }
+            catch (ReaderError&) {
             }
+        } else {
+            ReadEntityBytes(length);
+        }
+    }
+}
 
-            try {
-                aEventProcessor.EventUpdate(tagName, val, outputProcessor);
-            }
-            catch(AsciiError&) {
-                THROW(XmlError);
-            }
+void EventSessionUpnp::ReadEntityBytes(TUint aBytes)
+{
+    TUint remaining = aBytes;
+    do {
+        TUint bytes = remaining;
+        if (bytes > kMaxReadBytes) {
+            bytes = kMaxReadBytes;
+        }
+        Brn buf = iReaderUntil->Read(bytes);
+        remaining -= buf.Bytes();
+        iPropertySet.Parse(buf);
+    } while (remaining > 0);
+}
+
+void EventSessionUpnp::ReadTimeout()
+{
+    LOG2(kEvent, kError, "EventSessionUpnp read timeout\n");
+    iReaderUntil->ReadInterrupt();
+}
+
+
+// EventPropertySetParser
 
-            propertySet.Set(remaining);
+EventPropertySetParser::EventPropertySetParser()
+    : iEventProcessor(NULL)
+    , iCount(0)
+{
+}
+
+void EventPropertySetParser::Start(IEventProcessor& aEventProcessor)
+{
+    iEventProcessor = &aEventProcessor;
+    iPending.SetBytes(0);
+    iCount = 0;
+}
+
+void EventPropertySetParser::Parse(const Brx& aData)
+{
+    const TUint bytes = iPending.Bytes() + aData.Bytes();
+    if (bytes > iPending.MaxBytes()) {
+        TUint maxBytes = 2 * iPending.MaxBytes();
+        if (maxBytes < bytes + kMinGrowBytes) {
+            maxBytes = bytes + kMinGrowBytes;
         }
-        aEventProcessor.EventUpdateEnd();
+        iPending.Grow(maxBytes);
     }
-    catch(XmlError&) {
-        aEventProcessor.EventUpdateError();
+    iPending.Append(aData);
+    /* values are escaped so only tags contain '>'.  A property can only have been
+       completed by data that contains one. */
+    if (Ascii::Contains(aData, '>')) {
+        ProcessProperties();
+    }
+}
+
+void EventPropertySetParser::End()
+{
+    ProcessProperties();
+    Brn remaining(Ascii::Trim(iPending));
+    if (iCount == 0) {
+        (void)XmlParserBasic::Find("propertyset", remaining); // throws XmlError if there's no (empty) propertyset
+    }
+    else if (!IsPropertySetEnd(remaining)) {
+        THROW(XmlError);
+    }
+}
+
+void EventPropertySetParser::ProcessProperties()
+{
+    TUint consumed = 0;
+    for (;;) {
+        Brn pending(iPending.Ptr() + consumed, iPending.Bytes() - consumed);
+        Brn prop;
+        Brn remaining;
+        try {
+            prop.Set(XmlParserBasic::Find("property", pending, remaining));
+        }
+        catch (XmlError&) {
+            break; // no complete property buffered yet
+        }
+        // Find trims its input so remaining may not extend to the end of pending
+        const TUint bytes = (remaining.Bytes() > 0? (TUint)(remaining.Ptr() - pending.Ptr())
+                                                  : (TUint)(Ascii::Trim(pending).Ptr() + Ascii::Trim(pending).Bytes() - pending.Ptr()));
+        if (pending[bytes-1] != '>') {
+            break; // the closing tag hasn't been fully read
+        }
+        ProcessProperty(prop);
+        iCount++;
+        consumed += bytes;
+    }
+    if (consumed > 0) {
+        const TUint bytes = iPending.Bytes() - consumed;
+        TByte* ptr = const_cast<TByte*>(iPending.Ptr());
+        (void)memmove(ptr, ptr + consumed, bytes);
+        iPending.SetBytes(bytes);
+    }
+}
+
+void EventPropertySetParser::ProcessProperty(const Brx& aProperty)
+{
+    Brn prop(Ascii::Trim(aProperty));
+    if (prop.Bytes() < 8 || prop[0] != '<' || prop[1] == '/') {
+        THROW(XmlError);
+    }
+    Parser parser(prop);
+    (void)parser.Next('<');
+    Brn tagNameFull = parser.Next('>');
+    Brn tagName = tagNameFull;
+    TUint bytes = tagNameFull.Bytes();
+    TUint i;
+    for (i = 0; i < bytes; i++) {
+        if (Ascii::IsWhitespace(tagNameFull[i])) {
+            break;
+        }
+    }
+    if (i < bytes) {
+        tagName.Set(tagNameFull.Split(0, i));
+    }
+    Brn val;
+    if (bytes > 0 && tagNameFull[bytes-1] == '/') {
+        // empty element tag
+        val.Set(Brx::Empty());
+        if (i == bytes) { // no white space before '/'
+            tagName.Set(tagName.Split(0, bytes-1));
+        }
+    }
+    else {
+        val.Set(parser.Next('<'));
+        Brn closingTag = parser.Next('/');
+        closingTag.Set(parser.Next('>'));
+        if (tagName != closingTag) {
+            THROW(XmlError);
+        }
+    }
+
+    OutputProcessorUpnp outputProcessor;
+    try {
+        iEventProcessor->EventUpdate(tagName, val, outputProcessor);
+    }
+    catch(AsciiError&) {
+        THROW(XmlError);
+    }
+}
+
+TBool EventPropertySetParser::IsPropertySetEnd(const Brx& aTag)
+{
+    const TUint bytes = aTag.Bytes();
+    if (bytes < 3 || aTag[0] != '<' || aTag[1] != '/' || aTag[bytes-1] != '>') {
+        return false;
+    }
+    Parser parser(Ascii::Trim(aTag.Split(2, bytes-3)));
+    Brn name = parser.Next(':');
+    if (parser.Remaining().Bytes() > 0) {
+        name.Set(parser.Remaining()); // skip namespace prefix
     }
+    return Ascii::CaseInsensitiveEquals(name, Brn("propertyset"));
 }
 
 // EventServerUpnp
 
 EventServerUpnp::EventServerUpnp(CpStack& aCpStack, TIpAddress aInterface)
-    : iTcpServer(aCpStack.Env(), "EventServer", aCpStack.Env().InitParams()->CpUpnpEventServerPort(), aInterface)
+    : iSessionCount(aCpStack.Env().InitParams()->NumEventSessionThreads())
+    , iTcpServer(aCpStack.Env(), "EventServer", aCpStack.Env().InitParams()->CpUpnpEventServerPort(), aInterface)
 {
     const TUint numThread = aCpStack.Env().InitParams()->NumEventSessionThreads();
     for (TUint i=0; i<numThread; i++) {
         Bws<Thread::kMaxNameBytes+1> thName;
         thName.AppendPrintf("EventSession %d", i);
         thName.PtrZ();
-        iTcpServer.Add((const TChar*)thName.Ptr(), new EventSessionUpnp(aCpStack));
+        iTcpServer.Add((const TChar*)thName.Ptr(), new EventSessionUpnp(aCpStack, iSessionCount));
     }
 }
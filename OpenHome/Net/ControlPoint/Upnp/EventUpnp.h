@@ -6,6 +6,7 @@
 #include <OpenHome/Private/Http.h>
 #include <OpenHome/Net/Private/ProtocolUpnp.h>
 #include <OpenHome/Net/Private/Subscription.h>
+#include <OpenHome/Private/Timer.h>
 
 namespace OpenHome {
 namespace Net {
@@ -13,27 +14,73 @@ namespace Net {
 class Subscription;
 class CpStack;
 
+/**
+ * Parses a GENA propertyset as it is read, passing each property to an IEventProcessor
+ * once its closing tag arrives.  Only the current (incomplete) property is buffered.
+ */
+class EventPropertySetParser : private INonCopyable
+{
+public:
+    EventPropertySetParser();
+    void Start(IEventProcessor& aEventProcessor);
+    void Parse(const Brx& aData); // throws XmlError
+    void End(); // throws XmlError
+private:
+    void ProcessProperties();
+    void ProcessProperty(const Brx& aProperty);
+    static TBool IsPropertySetEnd(const Brx& aTag);
+private:
+    static const TUint kMinGrowBytes = 1024;
+    IEventProcessor* iEventProcessor;
+    Bwh iPending;
+    TUint iCount;
+};
+
+/**
+ * Counts the EventSessionUpnp instances which are currently handling a connection.
+ */
+class EventSessionCount : private INonCopyable
+{
+public:
+    EventSessionCount(TUint aSessions);
+    void Started();
+    void Finished();
+    TBool AllBusy() const;
+private:
+    mutable Mutex iLock;
+    const TUint iSessions;
+    TUint iBusy;
+};
+
 class EventSessionUpnp : public SocketTcpSession
 {
 public:
-    EventSessionUpnp(CpStack& aCpStack);
+    EventSessionUpnp(CpStack& aCpStack, EventSessionCount& aSessionCount);
     ~EventSessionUpnp();
 private:
     void Error(const HttpStatus& aStatus);
     void LogError(CpiSubscription* aSubscription, const TChar* aErr);
     virtual void Run();
-    void ProcessNotification(IEventProcessor& aEventProcessor, const Brx& aEntity);
+    TBool ProcessRequest(TBool aKeptAlive); // returns true if the connection can be reused
+    TBool ProcessNotification(IEventProcessor& aEventProcessor); // returns false if the entity wasn't fully read
+    void ReadEntity();
+    void ReadEntityBytes(TUint aBytes);
+    void ReadTimeout();
 private:
     static const TUint kMaxReadBytes = 4 * 1024;
     static const TUint kReadTimeoutMs = 5 * 1000;
+    static const TUint kEntityTimeoutMs = 30 * 1000;
+    /* Sessions are thread per connection so idle keep-alive connections are dropped
+       quickly to leave sessions available for other publishers */
+    static const TUint kKeepAliveTimeoutMs = 2 * 1000;
     static const Brn kMethodNotify;
     static const Brn kExpectedNt;
     static const Brn kExpectedNts;
 private:
     CpStack& iCpStack;
+    EventSessionCount& iSessionCount;
     Srx* iReadBuffer;
     ReaderUntil* iReaderUntil;
-    ReaderHttpChunked* iDechunker;
     ReaderHttpRequest* iReaderRequest;
     HeaderNt iHeaderNt;
     HeaderNts iHeaderNts;
@@ -41,8 +88,11 @@ private:
     HeaderSeq iHeaderSeq;
     HttpHeaderContentLength iHeaderContentLength;
     HttpHeaderTransferEncoding iHeaderTransferEncoding;
+    HttpHeaderConnection iHeaderConnection;
     const HttpStatus* iErrorStatus;
     Semaphore iShutdownSem;
+    EventPropertySetParser iPropertySet;
+    Timer* iReadTimer;
 };
 
 class EventServerUpnp
@@ -51,6 +101,7 @@ public:
     EventServerUpnp(CpStack& aCpStack, TIpAddress aInterface);
     TUint Port() const { return iTcpServer.Port(); }
 private:
+    EventSessionCount iSessionCount;
     SocketTcpServer iTcpServer;
 };
 
@@ -4,6 +4,7 @@
 #include <OpenHome/Private/Parser.h>
 #include <OpenHome/Net/Private/Error.h>
 #include <OpenHome/Private/Converter.h>
+#include <OpenHome/Private/Compression.h>
 #include <OpenHome/Private/Env.h>
 #include <OpenHome/Net/Private/CpiStack.h>
 #include <OpenHome/Net/Private/CpiSubscription.h>
@@ -86,10 +87,12 @@ void InvocationUpnp::ReadResponse()
     OutputProcessorUpnp outputProcessor;
     HttpHeaderContentLength headerContentLength;
     HttpHeaderTransferEncoding headerTransferEncoding;
+    HttpHeaderContentEncoding headerContentEncoding;
     Bwh entity;
 
     iReaderResponse.AddHeader(headerContentLength);
     iReaderResponse.AddHeader(headerTransferEncoding);
+    iReaderResponse.AddHeader(headerContentEncoding);
     iReaderResponse.Read(kResponseTimeoutMs);
     const HttpStatus& status = iReaderResponse.Status();
     if (status != HttpStatus::kOk) {
@@ -137,7 +140,28 @@ void InvocationUpnp::ReadResponse()
             }
         }
     }
-    writer.TransferTo(entity);
+    const Brx& encoding = headerContentEncoding.Encoding();
+    if (!headerContentEncoding.Received() || Ascii::CaseInsensitiveEquals(encoding, Http::kTransferEncodingIdentity)) {
+        writer.TransferTo(entity);
+    }
+    else {
+        try {
+            if (Ascii::CaseInsensitiveEquals(encoding, Http::kContentCodingGzip)) {
+                Compression::Decompress(writer.Buffer(), entity, Compression::eGzip);
+            }
+            else if (Ascii::CaseInsensitiveEquals(encoding, Http::kContentCodingDeflate)) {
+                Compression::Decompress(writer.Buffer(), entity, Compression::eDeflate);
+            }
+            else {
+                THROW(CompressionError);
+            }
+        }
+        catch (CompressionError&) {
+            LOG2(kService, kError, "InvocationUpnp::ReadResponse, unable to decode %.*s content\n", PBUF(encoding));
+            iInvocation.SetError(Error::eHttp, Error::kCodeUnknown, Error::kDescriptionUnknown);
+            THROW(HttpError);
+        }
+    }
 
     if (status == HttpStatus::kInternalServerError) {
         Brn envelope = XmlParserBasic::Find("Envelope", entity);
@@ -180,6 +204,9 @@ void InvocationUpnp::WriteHeaders(WriterHttpRequest& aWriterRequest, const Uri&
     Http::WriteHeaderContentLength(aWriterRequest, aBodyBytes);
     Http::WriteHeaderContentType(aWriterRequest, kContentType);
     Http::WriteHeaderUserAgent(aWriterRequest, aEnv);
+    if (Compression::Available()) {
+        aWriterRequest.WriteHeader(Http::kHeaderAcceptEncoding, Http::kAcceptEncodingGzipDeflate);
+    }
 
     IWriterAscii& writerField = aWriterRequest.WriteHeaderField(kSoapAction);
     writerField.Write('\"');
@@ -3,6 +3,7 @@
 #include <OpenHome/Net/Private/CpiStack.h>
 #include <OpenHome/Private/Stream.h>
 #include <OpenHome/Private/Http.h>
+#include <OpenHome/Private/Compression.h>
 #include <OpenHome/Exception.h>
 #include <OpenHome/Private/Debug.h>
 #include <OpenHome/Net/Core/OhNet.h>
@@ -27,6 +28,11 @@ void XmlFetch::CheckContactable(OpenHome::Uri* aUri, FunctorAsync& aFunctor)
     iCheckContactable = true;
 }
 
+void XmlFetch::SetIfNoneMatch(const Brx& aETag)
+{
+    iIfNoneMatch.Set(aETag);
+}
+
 XmlFetch::~XmlFetch()
 {
     delete iUri;
@@ -150,10 +156,31 @@ TBool XmlFetch::WasContactable(IAsync& aAsync)
     return self.iContactable;
 }
 
+TBool XmlFetch::NotModified(IAsync& aAsync)
+{ // static
+    ASSERT(((Async&)aAsync).Type() == Async::eXmlFetch);
+    XmlFetch& self = (XmlFetch&)aAsync;
+    if (self.Error()) {
+        THROW(XmlFetchError);
+    }
+    return self.iNotModified;
+}
+
+const Brx& XmlFetch::ETag(IAsync& aAsync)
+{ // static
+    ASSERT(((Async&)aAsync).Type() == Async::eXmlFetch);
+    XmlFetch& self = (XmlFetch&)aAsync;
+    if (self.Error()) {
+        THROW(XmlFetchError);
+    }
+    return self.iETag;
+}
+
 XmlFetch::XmlFetch(CpStack& aCpStack)
     : iCpStack(aCpStack)
     , iUri(NULL)
     , iSequenceNumber(0)
+    , iNotModified(false)
     , iLock("XMLM")
     , iInterrupted(false)
     , iCheckContactable(false)
@@ -173,6 +200,14 @@ void XmlFetch::WriteRequest()
     const TUint port = (iUri->Port()==Uri::kPortNotSpecified? 80 : iUri->Port());
     Http::WriteHeaderHostAndPort(writerRequest, iUri->Host(), port);
     Http::WriteHeaderContentLength(writerRequest, 0);
+    if (!iCheckContactable) {
+        if (Compression::Available()) {
+            writerRequest.WriteHeader(Http::kHeaderAcceptEncoding, Http::kAcceptEncodingGzipDeflate);
+        }
+        if (iIfNoneMatch.Bytes() > 0) {
+            writerRequest.WriteHeader(Http::kHeaderIfNoneMatch, iIfNoneMatch);
+        }
+    }
     Http::WriteHeaderConnectionClose(writerRequest);
     writerRequest.WriteFlush();
 }
@@ -183,11 +218,22 @@ void XmlFetch::Read()
     ReaderHttpResponse readerResponse(iCpStack.Env(), iReaderUntil);
     HttpHeaderContentLength headerContentLength;
     HttpHeaderTransferEncoding headerTransferEncoding;
+    HttpHeaderETag headerETag;
+    HttpHeaderContentEncoding headerContentEncoding;
 
     readerResponse.AddHeader(headerContentLength);
     readerResponse.AddHeader(headerTransferEncoding);
+    readerResponse.AddHeader(headerETag);
+    readerResponse.AddHeader(headerContentEncoding);
     readerResponse.Read(kResponseTimeoutMs);
     const HttpStatus& status = readerResponse.Status();
+    if (headerETag.Received()) {
+        iETag.Replace(headerETag.ETag());
+    }
+    if (status == HttpStatus::kNotModified && iIfNoneMatch.Bytes() > 0) {
+        iNotModified = true;
+        return;
+    }
     if (status != HttpStatus::kOk) {
         const Brx& reason = status.Reason();
         LOG2(kXmlFetch, kError, "XmlFetch::Read, http error %u %.*s\n", status.Code(), PBUF(reason));
@@ -230,7 +276,29 @@ void XmlFetch::Read()
             } while (remaining > 0);
         }
     }
-    writer.TransferTo(iXml);
+    const Brx& encoding = headerContentEncoding.Encoding();
+    if (!headerContentEncoding.Received() || Ascii::CaseInsensitiveEquals(encoding, Http::kTransferEncodingIdentity)) {
+        writer.TransferTo(iXml);
+        return;
+    }
+    Bwh xml;
+    try {
+        if (Ascii::CaseInsensitiveEquals(encoding, Http::kContentCodingGzip)) {
+            Compression::Decompress(writer.Buffer(), xml, Compression::eGzip);
+        }
+        else if (Ascii::CaseInsensitiveEquals(encoding, Http::kContentCodingDeflate)) {
+            Compression::Decompress(writer.Buffer(), xml, Compression::eDeflate);
+        }
+        else {
+            LOG2(kXmlFetch, kError, "XmlFetch::Read, unsupported content encoding %.*s\n", PBUF(encoding));
+            THROW(HttpError);
+        }
+    }
+    catch (CompressionError&) {
+        LOG2(kXmlFetch, kError, "XmlFetch::Read, invalid %.*s content\n", PBUF(encoding));
+        THROW(HttpError);
+    }
+    xml.TransferTo(iXml);
 }
 
 void XmlFetch::Output(IAsyncOutput& aConsole)
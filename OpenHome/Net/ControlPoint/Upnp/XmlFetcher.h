@@ -31,12 +31,19 @@ class XmlFetch : public Async
 public:
     void Set(OpenHome::Uri* aUri, FunctorAsync& aFunctor);
     void CheckContactable(OpenHome::Uri* aUri, FunctorAsync& aFunctor);
+    /**
+     * Request the xml only if it no longer matches aETag (from an earlier fetch).
+     * Must be called after Set().  NotModified() reports whether the server skipped the body.
+     */
+    void SetIfNoneMatch(const Brx& aETag);
     ~XmlFetch();
     const OpenHome::Uri& Uri() const;
     void SignalCompleted();
     void SetError(Error::ELevel aLevel, TUint aCode, const Brx& aDescription);
     static Bwh& Xml(IAsync& aAsync);
     static TBool WasContactable(IAsync& aAsync);
+    static TBool NotModified(IAsync& aAsync);
+    static const Brx& ETag(IAsync& aAsync); // empty if the server didn't supply one
     void Fetch();
     void Interrupt();
     TBool Interrupted() const;
@@ -55,6 +62,9 @@ private:
     FunctorAsync iFunctor;
     TUint iSequenceNumber;
     Bwh iXml;
+    Brh iIfNoneMatch;
+    Bws<HttpHeaderETag::kMaxETagBytes> iETag;
+    TBool iNotModified;
     OpenHome::Net::Error iError;
     mutable OpenHome::Mutex iLock;
     TBool iInterrupted;
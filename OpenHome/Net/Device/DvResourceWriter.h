@@ -16,6 +16,10 @@ public:
     /**
      * Must be called before writing any file data
      *
+     * Files whose size isn't known in advance (e.g. generated content) can pass 0 for
+     * aTotalBytes.  These are streamed to the client using chunked transfer encoding
+     * (or by closing the connection for HTTP/1.0 clients) so need not be buffered first.
+     *
      * @param[in] aTotalBytes  Size in bytes of the file.  Can be 0 if size is unknown.
      * @param[in] aMimeType    MIME type of the file.  May be NULL if this is unknown.
      */
@@ -25,6 +29,10 @@ public:
      *
      * Will be called 0..n times after WriteResourceBegin and before WriteResourceEnd
      *
+     * May block until the client has read earlier data so memory use doesn't depend on
+     * the size of the file.  Throws WriterError if the client has gone away; no further
+     * data should be written in this case.
+     *
      * @param[in] aData        File data to write
      * @param[in] aBytes       Size in bytes of aData
      */
@@ -38,6 +46,31 @@ public:
      * values in the WriteResource callbacks does not match aTotalBytes.
      */
     virtual void WriteResourceEnd() = 0;
+    /**
+     * Optionally called before WriteResourceBegin to supply validators for the file
+     *
+     * Writers which support conditional requests may use these to tell a client that
+     * its copy of the file is still current.  Any data subsequently passed to
+     * WriteResource is then discarded.
+     *
+     * @param[in] aETag          Entity tag, including its surrounding quotes
+     * @param[in] aLastModified  Time the file last changed, in seconds since 1970.  0 if unknown.
+     */
+    virtual void WriteResourceValidators(const char* /*aETag*/, uint32_t /*aLastModified*/) {}
+    /**
+     * Optionally called to serve a file from disk in place of WriteResourceBegin,
+     * WriteResource and WriteResourceEnd
+     *
+     * Writers may then send the file (or just the range of it a client requested)
+     * without copying its data through user space.
+     *
+     * @param[in] aPath        Full path of the file
+     * @param[in] aMimeType    MIME type of the file.  May be NULL if this is unknown.
+     *
+     * @return  true if the file was served; false if the writer doesn't support this or
+     *          couldn't open the file.  The caller should write the file itself in this case.
+     */
+    virtual bool WriteResourceFile(const char* /*aPath*/, const char* /*aMimeType*/=NULL) { return false; }
 
     virtual ~IResourceWriter() {}
 };
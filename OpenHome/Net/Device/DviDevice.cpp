@@ -350,6 +350,11 @@ TUint DviDevice::ConfigId()
     return iConfigId;
 }
 
+TUint DviDevice::ConfigGeneration() const
+{
+    return (TUint)iConfigGeneration.Value();
+}
+
 void DviDevice::CreateSid(Brh& aSid)
 {
     Bwh sid(iUdn.Bytes() + 1 + Ascii::kMaxUintStringBytes + 1);
@@ -542,6 +547,10 @@ TBool DviDevice::ChildHasService(const OpenHome::Net::ServiceType& aServiceType)
 
 void DviDevice::ConfigChanged()
 {
+    // a device's xml includes its embedded devices so any change also moves its parents on
+    for (DviDevice* device = this; device != NULL; device = device->iParent) {
+        (void)device->iConfigGeneration.Add(1);
+    }
     if (!iConfigUpdated) {
         iConfigId++;
         iConfigUpdated = true;
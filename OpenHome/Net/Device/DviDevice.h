@@ -59,6 +59,7 @@ public:
     void WriteResource(const Brx& aUriTail, TIpAddress aInterface, std::vector<char*>& aLanguageList, IResourceWriter& aResourceWriter);
     void GetUriBase(Bwx& aUriBase, TIpAddress aInterface, TUint aPort, IDvProtocol& aProtocol);
     TUint ConfigId();
+    TUint ConfigGeneration() const; // increases each time attributes or services of this or any embedded device change
     void CreateSid(Brh& aSid);
     IResourceManager* ResourceManager();
     DvStack& GetDvStack();
@@ -97,6 +98,7 @@ private:
     EEnableState iEnabled;
     TUint iConfigId;
     TBool iConfigUpdated;
+    Atomic iConfigGeneration; // read by protocols without iLock
     DviDevice* iParent;
     std::vector<DviService*> iServices;
     std::vector<DviDevice*> iDevices;
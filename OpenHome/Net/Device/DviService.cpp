@@ -5,6 +5,7 @@
 #include <OpenHome/Private/Debug.h>
 #include <OpenHome/Private/Http.h>
 #include <OpenHome/Private/Printer.h>
+#include <OpenHome/Private/Converter.h>
 #include <OpenHome/Net/Private/DviSubscription.h>
 #include <OpenHome/Net/Private/Error.h>
 #include <OpenHome/Net/Private/DviStack.h>
@@ -73,11 +74,11 @@ DviService::DviService(DvStack& aDvStack, const TChar* aDomain, const TChar* aNa
     , iLock("DVSM")
     , iRefCount(1)
     , iPropertiesLock("SPRM")
-    , iDisabled(true)
+    , iActionMask(0)
+    , iDisabled(1)
     , iCurrentInvocationCount(0)
     , iDisabledSem("DVSS", 0)
 {
-    iDisabledSem.Signal();
     iDvStack.Env().AddObject(this);
 }
 
@@ -132,26 +133,29 @@ void DviService::RemoveRef()
 
 void DviService::Disable()
 {
-    iLock.Wait();
-    iDisabled = true;
-    iLock.Signal();
-    iDisabledSem.Wait();
-    iDisabledSem.Signal(); // allow for possible further calls to Disable()
+    (void)iDisabled.Exchange(1);
+    // wait for any invocations that started before we were disabled
+    for (;;) {
+        (void)iDisabledSem.Clear();
+        if (iCurrentInvocationCount.Value() == 0) {
+            break;
+        }
+        iDisabledSem.Wait();
+    }
 }
 
 void DviService::Enable()
 {
-    iLock.Wait();
-    iDisabled = false;
+    (void)iDisabled.Exchange(0);
     AssertPropertiesInitialised();
-    iDisabledSem.Signal();
-    iLock.Signal();
 }
 
 void DviService::AddAction(Action* aAction, FunctorDviInvocation aFunctor)
 {
     DvAction action(aAction, aFunctor);
     iDvActions.push_back(action);
+    iActionHashes.push_back(Converter::Fnv1a(aAction->Name()));
+    RebuildActionSlots();
 }
 
 const std::vector<DvAction>& DviService::DvActions() const
@@ -171,23 +175,23 @@ void DviService::InvokeDirect(IDviInvocation& aInvocation, const Brx& aActionNam
 
 void DviService::Invoke(IDviInvocation& aInvocation, const Brx& aActionName, TBool aIgnoreEnableState)
 {
-    iLock.Wait();
     LOG(kDvInvocation, "Service: %.*s, Action: %.*s\n",
                        PBUF(iServiceType.Name()), PBUF(aActionName));
-    if (!aIgnoreEnableState && iDisabled) {
-        iLock.Signal();
+    // count the invocation before checking for Disable() so that one of us is guaranteed to see the other
+    (void)iCurrentInvocationCount.Add(1);
+    if (!aIgnoreEnableState && iDisabled.Value() != 0) {
+        InvocationCompleted();
         aInvocation.InvocationReportError(502, Brn("Action not available"));
     }
-    iCurrentInvocationCount++;
-    (void)iDisabledSem.Clear();
-    iLock.Signal();
 
     {
         AutoFunctor a(MakeFunctor(*this, &DviService::InvocationCompleted));
-        for (TUint i=0; i<iDvActions.size(); i++) {
-            if (iDvActions[i].Action()->Name() == aActionName) {
+        const TUint32 hash = Converter::Fnv1a(aActionName);
+        for (TUint i = hash & iActionMask; iActionSlots.size() > 0 && iActionSlots[i] != -1; i = (i+1) & iActionMask) {
+            const TUint index = (TUint)iActionSlots[i];
+            if (iActionHashes[index] == hash && iDvActions[index].Action()->Name() == aActionName) {
                 try {
-                    iDvActions[i].Functor()(aInvocation);
+                    iDvActions[index].Functor()(aInvocation);
                 }
                 catch (InvocationError&) {
                     // avoid calls to aInvocation.InvocationReportError in other catch blocks
@@ -211,14 +215,30 @@ void DviService::Invoke(IDviInvocation& aInvocation, const Brx& aActionName, TBo
     aInvocation.InvocationReportError(501, Brn("Action not implemented"));
 }
 
+void DviService::RebuildActionSlots()
+{
+    // actions are only added while a provider is constructed; keep the table no more than half full
+    TUint slots = 4;
+    while (slots < 2 * iDvActions.size()) {
+        slots *= 2;
+    }
+    iActionSlots.assign(slots, -1);
+    iActionMask = slots - 1;
+    for (TUint i=0; i<(TUint)iDvActions.size(); i++) {
+        TUint slot = iActionHashes[i] & iActionMask;
+        while (iActionSlots[slot] != -1) {
+            slot = (slot + 1) & iActionMask;
+        }
+        iActionSlots[slot] = (TInt)i;
+    }
+}
+
 void DviService::InvocationCompleted()
 {
-    iLock.Wait();
-    iCurrentInvocationCount--;
-    if (iCurrentInvocationCount == 0) {
+    // Disable() only waits on iDisabledSem after setting iDisabled so there's no need to signal otherwise
+    if (iCurrentInvocationCount.Add(-1) == 0 && iDisabled.Value() != 0) {
         iDisabledSem.Signal();
     }
-    iLock.Signal();
 }
 
 void DviService::PropertiesLock()
@@ -100,6 +100,7 @@ public:
 private:
     ~DviService();
     void Invoke(IDviInvocation& aInvocation, const Brx& aActionName, TBool aIgnoreEnableState);
+    void RebuildActionSlots();
     void InvocationCompleted();
     TBool AssertPropertiesInitialised() const;
 private: // from IStackObject
@@ -110,10 +111,13 @@ private:
     TUint iRefCount;
     Mutex iPropertiesLock;
     std::vector<DvAction> iDvActions;
+    std::vector<TUint32> iActionHashes;
+    std::vector<TInt> iActionSlots; // open addressing table of indices into iDvActions, probed by Invoke()
+    TUint iActionMask;
     std::vector<Property*> iProperties;
     std::vector<DviSubscription*> iSubscriptions;
-    TBool iDisabled;
-    TUint iCurrentInvocationCount;
+    Atomic iDisabled;
+    Atomic iCurrentInvocationCount;
     Semaphore iDisabledSem;
 };
 
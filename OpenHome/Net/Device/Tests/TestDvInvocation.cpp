@@ -8,9 +8,23 @@
 #include <OpenHome/Net/Core/OhNet.h>
 #include <OpenHome/Net/Core/CpDevice.h>
 #include <OpenHome/Net/Core/CpDeviceUpnp.h>
+#include <OpenHome/Net/Core/CpProxy.h>
+#include <OpenHome/Net/Core/FunctorAsync.h>
+#include <OpenHome/Net/Private/CpiService.h>
+#include <OpenHome/Net/Private/Service.h>
+#include <OpenHome/Net/Private/Error.h>
 #include <OpenHome/Private/Ascii.h>
 #include <OpenHome/Private/Env.h>
 #include <OpenHome/Net/Private/DviStack.h>
+#include <OpenHome/Net/Private/DviDevice.h>
+#include <OpenHome/Net/Private/CpiStack.h>
+#include <OpenHome/Net/Private/XmlFetcher.h>
+#include <OpenHome/Private/NetworkAdapterList.h>
+#include <OpenHome/Private/Network.h>
+#include <OpenHome/Private/Uri.h>
+#include <OpenHome/Private/Parser.h>
+#include <OpenHome/Private/Http.h>
+#include <OpenHome/Private/Compression.h>
 
 #include <vector>
 
@@ -21,6 +35,8 @@ using namespace OpenHome::TestFramework;
 namespace OpenHome {
 namespace TestDvInvocation {
 
+class DeviceBlocking;
+
 class CpDevices
 {
     static const TUint kTestIterations = 10;
@@ -28,13 +44,101 @@ public:
     CpDevices(Semaphore& aAddedSem, const Brx& aTargetUdn);
     ~CpDevices();
     void Test();
+    void TestDisable(DeviceBlocking& aDevice);
     void Added(CpDevice& aDevice);
     void Removed(CpDevice& aDevice);
+private:
+    void IncrementComplete(IAsync& aAsync);
+    void Disable();
 private:
     Mutex iLock;
     std::vector<CpDevice*> iList;
     Semaphore& iAddedSem;
     const Brx& iTargetUdn;
+    DeviceBlocking* iDeviceBlocking;
+    Semaphore iInvocationSem;
+    Semaphore iDisabledSem;
+};
+
+class CpProxyUnknownAction
+{
+public:
+    CpProxyUnknownAction(CpDevice& aDevice);
+    ~CpProxyUnknownAction();
+    void SyncInvoke(Error::ELevel& aLevel, TUint& aCode);
+private:
+    void InvocationComplete(IAsync& aAsync);
+private:
+    CpProxy iCpProxy;
+    OpenHome::Net::Action* iAction;
+    Semaphore iSem;
+    Error::ELevel iLevel;
+    TUint iCode;
+};
+
+class ProviderBlocking : public DvProviderOpenhomeOrgTestBasic1
+{
+public:
+    ProviderBlocking(DvDevice& aDevice);
+    void WaitForInvocation();
+    void CompleteInvocation();
+private:
+    void Increment(IDvInvocation& aInvocation, TUint aValue, IDvInvocationResponseUint& aResult);
+private:
+    Semaphore iInvokedSem;
+    Semaphore iCompleteSem;
+};
+
+class DeviceBlocking
+{
+public:
+    DeviceBlocking(DvStack& aDvStack);
+    ~DeviceBlocking();
+    const Brx& Udn() const;
+    DvDevice& Device();
+    ProviderBlocking& Provider();
+private:
+    DvDeviceStandard* iDevice;
+    ProviderBlocking* iProvider;
+};
+
+class ProviderEmpty : public DvProvider
+{
+public:
+    ProviderEmpty(DvDevice& aDevice);
+};
+
+class DeviceResources : public IResourceManager
+{
+    static const TUint kResourceBytes = 10000;
+public:
+    DeviceResources(DvStack& aDvStack);
+    ~DeviceResources();
+    void Test();
+    void TestCompressedDescriptions();
+    void TestDescriptionUpdates();
+    void TestConditionalRequests(CpStack& aCpStack);
+private:
+    void GetUriBase(Bwh& aUri);
+    void GetDescription(const Brx& aUri, Bwh& aETag, Bwh& aBody);
+    void Disable();
+    void Fetch(CpStack& aCpStack, const Brx& aUri, const Brx& aIfNoneMatch);
+    void FetchCompleted(IAsync& aAsync);
+    void Get(const Brx& aUri, const Brx& aHeaders, TUint& aStatus, Bwh& aResponseHeaders, Bwh& aBody);
+    static Brn HeaderValue(const Brx& aHeaders, const Brx& aName);
+    void TestRange(const Brx& aUri, const Brx& aRange, TUint aFirst, TUint aBytes);
+private: // IResourceManager
+    void WriteResource(const Brx& aUriTail, TIpAddress aInterface, std::vector<char*>& aLanguageList, IResourceWriter& aResourceWriter);
+private:
+    DvStack& iDvStack;
+    DvDeviceStandard* iDevice;
+    ProviderTestBasic* iTestBasic;
+    Bwh iData;
+    Semaphore iFetchSem;
+    TBool iFetchError;
+    TBool iFetchNotModified;
+    Bwh iFetchXml;
+    Bwh iFetchETag;
 };
 
 } // namespace TestDvInvocation
@@ -46,6 +150,9 @@ CpDevices::CpDevices(Semaphore& aAddedSem, const Brx& aTargetUdn)
     : iLock("DLMX")
     , iAddedSem(aAddedSem)
     , iTargetUdn(aTargetUdn)
+    , iDeviceBlocking(NULL)
+    , iInvocationSem("DLS1", 0)
+    , iDisabledSem("DLS2", 0)
 {
 }
 
@@ -120,6 +227,16 @@ void CpDevices::Test()
         proxy->SyncEchoString(valStr, result);
         ASSERT(result == valStr);
     }
+    // requests that need the session's request buffer to grow several times
+    Bwh longStr(48 * 1024);
+    while (longStr.Bytes() < longStr.MaxBytes()) {
+        longStr.Append((TByte)('a' + (longStr.Bytes() % 26)));
+    }
+    for (i=0; i<kTestIterations; i++) {
+        Brh result;
+        proxy->SyncEchoString(longStr, result);
+        ASSERT(result == longStr);
+    }
     // Test some end-of-line conversions.
     // '\n', '\r', and '\r\n' should all be returned as a single '\n'.
     Brn valLf("<tag>some\ntext</<tag>");
@@ -193,7 +310,59 @@ void CpDevices::Test()
         ASSERT(result == valBin);
     }
 
+    Print("  Unknown action...\n");
+    CpProxyUnknownAction* unknown = new CpProxyUnknownAction(*(iList[0]));
+    Error::ELevel level;
+    TUint code;
+    unknown->SyncInvoke(level, code);
+    TEST(level == Error::eUpnp);
+    TEST(code == 501);
+    delete unknown;
+
+    delete proxy;
+}
+
+void CpDevices::TestDisable(DeviceBlocking& aDevice)
+{
+    static const TUint kDisableTimeoutMs = 500;
+    ASSERT(iList.size() != 0);
+    CpProxyOpenhomeOrgTestBasic1* proxy = new CpProxyOpenhomeOrgTestBasic1(*(iList[0]));
+    iDeviceBlocking = &aDevice;
+    FunctorAsync functor = MakeFunctorAsync(*this, &CpDevices::IncrementComplete);
+    proxy->BeginIncrement(1, functor);
+    aDevice.Provider().WaitForInvocation();
+
+    // disabling must block until the invocation that is already running has completed
+    ThreadFunctor* disabler = new ThreadFunctor("DLDS", MakeFunctor(*this, &CpDevices::Disable));
+    disabler->Start();
+    TBool disabled = true;
+    try {
+        iDisabledSem.Wait(kDisableTimeoutMs);
+    }
+    catch (Timeout&) {
+        disabled = false;
+    }
+    TEST(!disabled);
+    aDevice.Provider().CompleteInvocation();
+    iDisabledSem.Wait();
+    iInvocationSem.Wait();
+    delete disabler;
     delete proxy;
+    iDeviceBlocking = NULL;
+}
+
+void CpDevices::IncrementComplete(IAsync& /*aAsync*/)
+{
+    // the device may have been disabled before the response was read; only completion matters here
+    iInvocationSem.Signal();
+}
+
+void CpDevices::Disable()
+{
+    Semaphore sem("DLS3", 0);
+    iDeviceBlocking->Device().SetDisabled(MakeFunctor(sem, &Semaphore::Signal));
+    iDisabledSem.Signal();
+    sem.Wait();
 }
 
 void CpDevices::Added(CpDevice& aDevice)
@@ -211,6 +380,470 @@ void CpDevices::Removed(CpDevice& /*aDevice*/)
 }
 
 
+
+CpProxyUnknownAction::CpProxyUnknownAction(CpDevice& aDevice)
+    : iCpProxy("openhome-org", "TestBasic", 1, aDevice.Device())
+    , iSem("PUAS", 0)
+    , iLevel(Error::eNone)
+    , iCode(0)
+{
+    iAction = new OpenHome::Net::Action("NoSuchAction");
+}
+
+CpProxyUnknownAction::~CpProxyUnknownAction()
+{
+    delete iAction;
+}
+
+void CpProxyUnknownAction::SyncInvoke(Error::ELevel& aLevel, TUint& aCode)
+{
+    FunctorAsync functor = MakeFunctorAsync(*this, &CpProxyUnknownAction::InvocationComplete);
+    Invocation* invocation = iCpProxy.GetService().Invocation(*iAction, functor);
+    iCpProxy.GetInvocable().InvokeAction(*invocation);
+    iSem.Wait();
+    aLevel = iLevel;
+    aCode = iCode;
+}
+
+void CpProxyUnknownAction::InvocationComplete(IAsync& aAsync)
+{
+    Invocation& invocation = (Invocation&)aAsync;
+    const TChar* ignore;
+    if (!invocation.Error(iLevel, iCode, ignore)) {
+        iLevel = Error::eNone;
+    }
+    iSem.Signal();
+}
+
+
+ProviderBlocking::ProviderBlocking(DvDevice& aDevice)
+    : DvProviderOpenhomeOrgTestBasic1(aDevice)
+    , iInvokedSem("PBS1", 0)
+    , iCompleteSem("PBS2", 0)
+{
+    EnableActionIncrement();
+}
+
+void ProviderBlocking::WaitForInvocation()
+{
+    iInvokedSem.Wait();
+}
+
+void ProviderBlocking::CompleteInvocation()
+{
+    iCompleteSem.Signal();
+}
+
+void ProviderBlocking::Increment(IDvInvocation& aInvocation, TUint aValue, IDvInvocationResponseUint& aResult)
+{
+    iInvokedSem.Signal();
+    iCompleteSem.Wait();
+    aInvocation.StartResponse();
+    aResult.Write(++aValue);
+    aInvocation.EndResponse();
+}
+
+
+DeviceBlocking::DeviceBlocking(DvStack& aDvStack)
+{
+    Bwh udn("BlockingDevice");
+    RandomiseUdn(aDvStack.Env(), udn);
+    iDevice = new DvDeviceStandard(aDvStack, udn);
+    iDevice->SetAttribute("Upnp.Domain", "openhome.org");
+    iDevice->SetAttribute("Upnp.Type", "TestBlocking");
+    iDevice->SetAttribute("Upnp.Version", "1");
+    iDevice->SetAttribute("Upnp.FriendlyName", "ohNetTestBlocking");
+    iDevice->SetAttribute("Upnp.Manufacturer", "None");
+    iDevice->SetAttribute("Upnp.ModelName", "ohNet test blocking device");
+    iProvider = new ProviderBlocking(*iDevice);
+    iDevice->SetEnabled();
+}
+
+DeviceBlocking::~DeviceBlocking()
+{
+    delete iProvider;
+    delete iDevice;
+}
+
+const Brx& DeviceBlocking::Udn() const
+{
+    return iDevice->Udn();
+}
+
+DvDevice& DeviceBlocking::Device()
+{
+    return *iDevice;
+}
+
+ProviderBlocking& DeviceBlocking::Provider()
+{
+    return *iProvider;
+}
+
+
+ProviderEmpty::ProviderEmpty(DvDevice& aDevice)
+    : DvProvider(aDevice.Device(), "openhome.org", "TestEmpty", 1)
+{
+}
+
+
+DeviceResources::DeviceResources(DvStack& aDvStack)
+    : iDvStack(aDvStack)
+    , iData(kResourceBytes)
+    , iFetchSem("DRFS", 0)
+{
+    for (TUint i=0; i<kResourceBytes; i++) {
+        iData.Append((TByte)(i % 251));
+    }
+    Bwh udn("ResourceDevice");
+    RandomiseUdn(aDvStack.Env(), udn);
+    iDevice = new DvDeviceStandard(aDvStack, udn, *this);
+    iDevice->SetAttribute("Upnp.Domain", "openhome.org");
+    iDevice->SetAttribute("Upnp.Type", "TestResources");
+    iDevice->SetAttribute("Upnp.Version", "1");
+    iDevice->SetAttribute("Upnp.FriendlyName", "ohNetTestResources");
+    iDevice->SetAttribute("Upnp.Manufacturer", "None");
+    iDevice->SetAttribute("Upnp.ModelName", "ohNet test resources");
+    iTestBasic = new ProviderTestBasic(*iDevice); // gives a service description large enough to compress
+    iDevice->SetEnabled();
+}
+
+DeviceResources::~DeviceResources()
+{
+    delete iTestBasic;
+    delete iDevice;
+}
+
+void DeviceResources::Test()
+{
+    Bwh uri;
+    GetUriBase(uri);
+    uri.Grow(uri.Bytes() + 32);
+    uri.Append(DviDevice::kResourceDir);
+    uri.Append("/data.bin");
+
+    TUint status;
+    Bwh headers;
+    Bwh body;
+    Get(uri, Brx::Empty(), status, headers, body);
+    TEST(status == 200);
+    TEST(body == iData);
+
+    TestRange(uri, Brn("bytes=100-1099"), 100, 1000);
+    TestRange(uri, Brn("bytes=0-0"), 0, 1);
+    TestRange(uri, Brn("bytes=9000-"), 9000, 1000);
+    TestRange(uri, Brn("bytes=-10"), kResourceBytes - 10, 10);
+    TestRange(uri, Brn("bytes=9990-20000"), 9990, 10); // end past the resource is truncated
+
+    Get(uri, Brn("Range: bytes=10000-\r\n"), status, headers, body);
+    TEST(status == 416);
+    TEST(body.Bytes() == 0);
+    Get(uri, Brn("Range: bytes=20000-20010\r\n"), status, headers, body);
+    TEST(status == 416);
+    TEST(body.Bytes() == 0);
+}
+
+void DeviceResources::TestCompressedDescriptions()
+{
+    Bwh uri;
+    GetUriBase(uri);
+    OpenHome::Net::ServiceType serviceType(iDvStack.Env(), "openhome.org", "TestBasic", 1);
+    uri.Grow(uri.Bytes() + serviceType.PathUpnp().Bytes() + 16);
+    uri.Append(serviceType.PathUpnp());
+    uri.Append("/service.xml");
+
+    TUint status;
+    Bwh headers;
+    Bwh plain;
+    Get(uri, Brx::Empty(), status, headers, plain);
+    TEST(status == 200);
+    TEST(HeaderValue(headers, Http::kHeaderContentEncoding).Bytes() == 0);
+    TEST(plain.Bytes() > 1024); // large enough to be worth compressing
+
+    Bwh body;
+    Get(uri, Brn("Accept-Encoding: gzip\r\n"), status, headers, body);
+    TEST(status == 200);
+    if (!Compression::Available()) {
+        // built without zlib so the request's Accept-Encoding is ignored
+        TEST(HeaderValue(headers, Http::kHeaderContentEncoding).Bytes() == 0);
+        TEST(body == plain);
+        return;
+    }
+    TEST(HeaderValue(headers, Http::kHeaderContentEncoding) == Http::kContentCodingGzip);
+    TEST(body.Bytes() < plain.Bytes());
+    Bwh inflated;
+    Compression::Decompress(body, inflated, Compression::eGzip);
+    TEST(inflated == plain);
+}
+
+void DeviceResources::TestDescriptionUpdates()
+{
+    Bwh base;
+    GetUriBase(base);
+    Bwh deviceUri(base.Bytes() + 16);
+    deviceUri.Append(base);
+    deviceUri.Append("device.xml");
+    OpenHome::Net::ServiceType emptyType(iDvStack.Env(), "openhome.org", "TestEmpty", 1);
+    Bwh emptyUri(base.Bytes() + emptyType.PathUpnp().Bytes() + 16);
+    emptyUri.Append(base);
+    emptyUri.Append(emptyType.PathUpnp());
+    emptyUri.Append("/service.xml");
+
+    // repeated requests are served from the cache
+    Bwh etag;
+    Bwh body;
+    GetDescription(deviceUri, etag, body);
+    Bwh etag2;
+    Bwh body2;
+    GetDescription(deviceUri, etag2, body2);
+    TEST(etag2 == etag);
+    TEST(body2 == body);
+
+    // changing an attribute of an enabled device re-renders its xml
+    iDevice->SetAttribute("Upnp.ModelName", "ohNet test resources (updated)");
+    GetDescription(deviceUri, etag2, body2);
+    TEST(etag2 != etag);
+    TEST(Ascii::Contains(body2, Brn("ohNet test resources (updated)")));
+
+    // ...as does adding a service
+    etag.Replace(etag2);
+    Disable();
+    ProviderEmpty* empty = new ProviderEmpty(*iDevice);
+    iDevice->SetEnabled();
+    GetDescription(deviceUri, etag2, body2);
+    TEST(etag2 != etag);
+    TEST(Ascii::Contains(body2, emptyType.FullNameUpnp()));
+    Bwh serviceETag;
+    GetDescription(emptyUri, serviceETag, body);
+    TEST(Ascii::Contains(body, Brn("<scpd")));
+
+    // a disable/enable cycle with a change made while disabled
+    etag.Replace(etag2);
+    Disable();
+    iDevice->SetAttribute("Upnp.ModelName", "ohNet test resources");
+    iDevice->SetEnabled();
+    GetDescription(deviceUri, etag2, body2);
+    TEST(etag2 != etag);
+    TEST(!Ascii::Contains(body2, Brn("(updated)")));
+
+    // an unchanged device keeps the same validators over a disable/enable cycle
+    etag.Replace(etag2);
+    body.Grow(body2.Bytes());
+    body.Replace(body2);
+    Disable();
+    iDevice->SetEnabled();
+    GetDescription(deviceUri, etag2, body2);
+    TEST(etag2 == etag);
+    TEST(body2 == body);
+    Bwh serviceETag2;
+    GetDescription(emptyUri, serviceETag2, body);
+    TEST(serviceETag2 == serviceETag);
+
+    Disable();
+    delete empty;
+    iDevice->SetEnabled();
+}
+
+void DeviceResources::TestConditionalRequests(CpStack& aCpStack)
+{
+    Bwh uri;
+    GetUriBase(uri);
+    uri.Grow(uri.Bytes() + 16);
+    uri.Append("device.xml");
+
+    // descriptions are served with validators
+    TUint status;
+    Bwh headers;
+    Bwh body;
+    Get(uri, Brx::Empty(), status, headers, body);
+    TEST(status == 200);
+    TEST(body.Bytes() > 0);
+    Bwh etag(HeaderValue(headers, Http::kHeaderETag));
+    TEST(etag.Bytes() > 0);
+    TEST(HeaderValue(headers, Http::kHeaderLastModified).Bytes() > 0);
+
+    // a matching If-None-Match gets 304 with no body
+    Bwh conditional(etag.Bytes() + 32);
+    conditional.Append(Http::kHeaderIfNoneMatch);
+    conditional.Append(": ");
+    conditional.Append(etag);
+    conditional.Append("\r\n");
+    Bwh body2;
+    Get(uri, conditional, status, headers, body2);
+    TEST(status == 304);
+    TEST(body2.Bytes() == 0);
+    TEST(HeaderValue(headers, Http::kHeaderETag) == etag);
+
+    // ...a different one gets the full description
+    Get(uri, Brn("If-None-Match: \"00\"\r\n"), status, headers, body2);
+    TEST(status == 200);
+    TEST(body2 == body);
+
+    // XmlFetch reports the 304 without an xml body
+    Fetch(aCpStack, uri, etag);
+    TEST(!iFetchError);
+    TEST(iFetchNotModified);
+    TEST(iFetchXml.Bytes() == 0);
+    TEST(iFetchETag == etag);
+
+    // changing the device's config gets a 200 with a new ETag
+    iDevice->SetAttribute("Upnp.FriendlyName", "ohNetTestResourcesConditional");
+    Get(uri, conditional, status, headers, body2);
+    TEST(status == 200);
+    Brn etag2 = HeaderValue(headers, Http::kHeaderETag);
+    TEST(etag2.Bytes() > 0);
+    TEST(etag2 != etag);
+    TEST(body2 != body);
+    Fetch(aCpStack, uri, etag);
+    TEST(!iFetchError);
+    TEST(!iFetchNotModified);
+    TEST(iFetchETag == etag2);
+    TEST(iFetchXml == body2);
+
+    iDevice->SetAttribute("Upnp.FriendlyName", "ohNetTestResources");
+}
+
+void DeviceResources::Fetch(CpStack& aCpStack, const Brx& aUri, const Brx& aIfNoneMatch)
+{
+    iFetchError = false;
+    iFetchNotModified = false;
+    iFetchXml.SetBytes(0);
+    iFetchETag.SetBytes(0);
+    XmlFetchManager& fetchManager = aCpStack.XmlFetchManager();
+    XmlFetch* fetch = fetchManager.Fetch();
+    FunctorAsync functor = MakeFunctorAsync(*this, &DeviceResources::FetchCompleted);
+    fetch->Set(new Uri(aUri), functor);
+    fetch->SetIfNoneMatch(aIfNoneMatch);
+    fetchManager.Fetch(fetch); // fetch is deleted once FetchCompleted returns
+    iFetchSem.Wait();
+}
+
+void DeviceResources::FetchCompleted(IAsync& aAsync)
+{
+    try {
+        iFetchNotModified = XmlFetch::NotModified(aAsync);
+        XmlFetch::Xml(aAsync).TransferTo(iFetchXml);
+        const Brx& etag = XmlFetch::ETag(aAsync);
+        iFetchETag.Grow(etag.Bytes());
+        iFetchETag.Replace(etag);
+    }
+    catch (XmlFetchError&) {
+        iFetchError = true;
+    }
+    iFetchSem.Signal();
+}
+
+void DeviceResources::GetDescription(const Brx& aUri, Bwh& aETag, Bwh& aBody)
+{
+    TUint status;
+    Bwh headers;
+    Get(aUri, Brx::Empty(), status, headers, aBody);
+    TEST(status == 200);
+    Brn etag = HeaderValue(headers, Http::kHeaderETag);
+    TEST(etag.Bytes() > 0);
+    aETag.Grow(etag.Bytes());
+    aETag.Replace(etag);
+}
+
+void DeviceResources::Disable()
+{
+    Semaphore sem("DRDS", 0);
+    iDevice->SetDisabled(MakeFunctor(sem, &Semaphore::Signal));
+    sem.Wait();
+}
+
+void DeviceResources::GetUriBase(Bwh& aUri)
+{
+    // resources are served from <base>/resource/, device and service descriptions from <base>
+    NetworkAdapter* adapter = iDvStack.Env().NetworkAdapterList().CurrentAdapter("DeviceResources");
+    ASSERT(adapter != NULL);
+    Brh root;
+    iDevice->GetResourceManagerUri(*adapter, root);
+    adapter->RemoveRef("DeviceResources");
+    const TUint bytes = root.Bytes() - DviDevice::kResourceDir.Bytes() - 1;
+    ASSERT(root.Split(bytes, DviDevice::kResourceDir.Bytes()) == DviDevice::kResourceDir);
+    aUri.Grow(bytes);
+    aUri.Replace(root.Split(0, bytes));
+}
+
+void DeviceResources::TestRange(const Brx& aUri, const Brx& aRange, TUint aFirst, TUint aBytes)
+{
+    Bws<64> header("Range: ");
+    header.Append(aRange);
+    header.Append("\r\n");
+    TUint status;
+    Bwh headers;
+    Bwh body;
+    Get(aUri, header, status, headers, body);
+    TEST(status == 206);
+    TEST(body == Brn(iData.Ptr() + aFirst, aBytes));
+}
+
+void DeviceResources::Get(const Brx& aUri, const Brx& aHeaders, TUint& aStatus, Bwh& aResponseHeaders, Bwh& aBody)
+{
+    Uri uri(aUri);
+    SocketTcpClient socket;
+    socket.Open(iDvStack.Env());
+    socket.Connect(Endpoint(uri.Port(), uri.Host()), 5000);
+    Bwh request(1024);
+    request.Append("GET ");
+    request.Append(uri.PathAndQuery());
+    request.Append(" HTTP/1.1\r\nHost: ");
+    request.Append(uri.Host());
+    request.Append("\r\nConnection: close\r\n");
+    request.Append(aHeaders);
+    request.Append("\r\n");
+    socket.Write(request);
+
+    Bwh response(kResourceBytes + 1024);
+    Bws<1024> buf;
+    try {
+        for (;;) {
+            socket.Read(buf);
+            response.Grow(response.Bytes() + buf.Bytes());
+            response.Append(buf);
+        }
+    }
+    catch (ReaderError&) {
+    }
+    socket.Close();
+
+    Parser parser(response);
+    (void)parser.Next(' '); // version
+    aStatus = Ascii::Uint(parser.Next(' '));
+    const Brn headersEnd("\r\n\r\n");
+    TUint index = 0;
+    while (response.Split(index, headersEnd.Bytes()) != headersEnd) {
+        index++;
+    }
+    aResponseHeaders.Grow(index + 2);
+    aResponseHeaders.Replace(response.Split(0, index + 2));
+    aBody.Grow(response.Bytes());
+    aBody.Replace(response.Split(index + headersEnd.Bytes()));
+}
+
+Brn DeviceResources::HeaderValue(const Brx& aHeaders, const Brx& aName)
+{ // static
+    Parser parser(aHeaders);
+    (void)parser.Next(Ascii::kLf); // status line
+    while (!parser.Finished()) {
+        Parser line(parser.Next(Ascii::kLf));
+        if (Ascii::CaseInsensitiveEquals(line.Next(':'), aName)) {
+            return Ascii::Trim(line.Remaining());
+        }
+    }
+    return Brn(Brx::Empty());
+}
+
+void DeviceResources::WriteResource(const Brx& aUriTail, TIpAddress /*aInterface*/, std::vector<char*>& /*aLanguageList*/, IResourceWriter& aResourceWriter)
+{
+    TEST(aUriTail == Brn("data.bin"));
+    aResourceWriter.WriteResourceBegin(iData.Bytes(), "application/octet-stream");
+    aResourceWriter.WriteResource(iData.Ptr(), iData.Bytes());
+    aResourceWriter.WriteResourceEnd();
+}
+
+
 void TestDvInvocation(CpStack& aCpStack, DvStack& aDvStack)
 {
     InitialisationParams* initParams = aDvStack.Env().InitParams();
@@ -245,6 +878,31 @@ void TestDvInvocation(CpStack& aCpStack, DvStack& aDvStack)
 
     delete device;
 
+    Print("  Disable waits for invocations in progress...\n");
+    DeviceBlocking* blocking = new DeviceBlocking(aDvStack);
+    sem = new Semaphore("SEM4", 0);
+    deviceList = new CpDevices(*sem, blocking->Udn());
+    added = MakeFunctorCpDevice(*deviceList, &CpDevices::Added);
+    removed = MakeFunctorCpDevice(*deviceList, &CpDevices::Removed);
+    list = new CpDeviceListUpnpServiceType(aCpStack, domainName, serviceType, ver, added, removed);
+    sem->Wait(30*1000);
+    deviceList->TestDisable(*blocking);
+    delete list;
+    delete deviceList;
+    delete sem;
+    delete blocking;
+
+    Print("  Range requests for resources...\n");
+    DeviceResources* resources = new DeviceResources(aDvStack);
+    resources->Test();
+    Print("  Compressed descriptions...\n");
+    resources->TestCompressedDescriptions();
+    Print("  Description caching...\n");
+    resources->TestDescriptionUpdates();
+    Print("  Conditional requests for descriptions...\n");
+    resources->TestConditionalRequests(aCpStack);
+    delete resources;
+
     Print("TestDvInvocation - completed\n");
     initParams->SetMsearchTime(oldMsearchTime);
 }
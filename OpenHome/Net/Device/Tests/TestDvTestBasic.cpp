@@ -71,18 +71,6 @@ void DeviceTestBasic::WriteResource(const Brx& aUriTail, TIpAddress /*aInterface
     filePath.Append(file);
     filePath.PtrZ();
 
-    IFile* filePtr = NULL;
-
-    const char* path = (const char*)filePath.Ptr();
-    try {
-        filePtr = IFile::Open(path, eFileReadOnly);
-    }
-    catch ( FileOpenError ) {
-        return;
-    }
-
-    static const TUint kMaxReadSize = 4096;
-    TUint bytes = filePtr->Bytes();
     const char* mime = NULL;
     for (TUint i=filePath.Bytes()-1; i>0; i--) {
         if (filePath[i] == '/' || filePath[i] == '\\') {
@@ -96,6 +84,21 @@ void DeviceTestBasic::WriteResource(const Brx& aUriTail, TIpAddress /*aInterface
             break;
         }
     }
+
+    const char* path = (const char*)filePath.Ptr();
+    if (aResourceWriter.WriteResourceFile(path, mime)) {
+        return;
+    }
+    IFile* filePtr = NULL;
+    try {
+        filePtr = IFile::Open(path, eFileReadOnly);
+    }
+    catch ( FileOpenError ) {
+        return;
+    }
+
+    static const TUint kMaxReadSize = 4096;
+    TUint bytes = filePtr->Bytes();
     aResourceWriter.WriteResourceBegin(bytes, mime);
     do {
         Bws<kMaxReadSize> buf;
@@ -5,6 +5,8 @@
 #include <OpenHome/Net/Private/Discovery.h>
 #include <OpenHome/Net/Private/DviDevice.h>
 #include <OpenHome/Net/Private/DviService.h>
+#include <OpenHome/Net/Private/DviSsdpNotifier.h>
+#include <OpenHome/Net/Private/DviProtocolUpnp.h>
 #include <OpenHome/Private/Env.h>
 #include <OpenHome/Net/Private/DviStack.h>
 #include <OpenHome/Private/NetworkAdapterList.h>
@@ -99,6 +101,36 @@ private:
     Semaphore iSem;
 };
 
+class SuitePacketBudget : public Suite
+{
+public:
+    SuitePacketBudget() : Suite("Announcement packet budget") {}
+    void Test();
+};
+
+class SuiteMsearchResponses : public Suite, private IUpnpAnnouncementData
+{
+public:
+    SuiteMsearchResponses(DvStack& aDvStack);
+    ~SuiteMsearchResponses();
+    void Test();
+private:
+    static TBool Contains(const Brx& aResponse, const TChar* aText);
+private: // from IUpnpAnnouncementData
+    const Brx& Udn() const { return iUdn; }
+    TBool IsRoot() const { return iIsRoot; }
+    TUint ServiceCount() const { return (TUint)iServices.size(); }
+    DviService& Service(TUint aIndex) { return *iServices[aIndex]; }
+    Brn Domain() const { return Brn("openhome.org"); }
+    Brn Type() const { return Brn("Product"); }
+    TUint Version() const { return 2; }
+private:
+    DvStack& iDvStack;
+    Brn iUdn;
+    TBool iIsRoot;
+    std::vector<DviService*> iServices;
+};
+
 class SuiteMsearch : public Suite, private INonCopyable
 {
 public:
@@ -740,17 +772,148 @@ void SuiteMsearch::TestMsearchServiceType()
 }
 
 
+// SuitePacketBudget
+
+void SuitePacketBudget::Test()
+{
+    const TUint kBurst = SsdpPacketBudget::kBurstPackets;
+    SsdpPacketBudget budget(100);
+    TUint now = 5000;
+    for (TUint i=0; i<kBurst; i++) {
+        TEST_QUIETLY(budget.TryTake(now));
+    }
+    TEST(!budget.TryTake(now));
+    TEST(budget.MsUntilAvailable(now) == 10);
+    TEST(!budget.TryTake(now + 9));
+    TEST(budget.MsUntilAvailable(now + 9) == 1);
+    TEST(budget.TryTake(now + 10));
+    TEST(!budget.TryTake(now + 10));
+
+    // a second's worth of packets is spread evenly over the second
+    TUint sent = 0;
+    for (TUint ms=11; ms<=1010; ms++) {
+        while (budget.TryTake(now + ms)) {
+            sent++;
+        }
+    }
+    TEST(sent == 100);
+
+    // an idle period only builds up a limited burst
+    now += 60 * 1000;
+    TUint burst = 0;
+    while (budget.TryTake(now)) {
+        burst++;
+    }
+    TEST(burst == kBurst);
+
+    // time wrapping
+    SsdpPacketBudget wrap(100);
+    for (TUint i=0; i<kBurst; i++) {
+        TEST_QUIETLY(wrap.TryTake(0xfffffff0));
+    }
+    TEST(!wrap.TryTake(0xfffffff0));
+    TEST(wrap.TryTake(0x10));
+
+    SsdpPacketBudget unlimited(0);
+    for (TUint i=0; i<10*kBurst; i++) {
+        TEST_QUIETLY(unlimited.TryTake(now));
+    }
+    TEST(unlimited.MsUntilAvailable(now) == 0);
+}
+
+
+// SuiteMsearchResponses
+
+SuiteMsearchResponses::SuiteMsearchResponses(DvStack& aDvStack)
+    : Suite("Pre-rendered msearch responses")
+    , iDvStack(aDvStack)
+    , iUdn("TestDviDiscoveryResponses")
+    , iIsRoot(true)
+{
+    iServices.push_back(new DviService(iDvStack, "openhome.org", "Volume", 1));
+    iServices.push_back(new DviService(iDvStack, "upnp.org", "ContentDirectory", 3));
+}
+
+SuiteMsearchResponses::~SuiteMsearchResponses()
+{
+    for (TUint i=0; i<iServices.size(); i++) {
+        iServices[i]->RemoveRef();
+    }
+}
+
+TBool SuiteMsearchResponses::Contains(const Brx& aResponse, const TChar* aText)
+{
+    Brn text(aText);
+    if (aResponse.Bytes() < text.Bytes()) {
+        return false;
+    }
+    for (TUint i=0; i<=aResponse.Bytes()-text.Bytes(); i++) {
+        if (Brn(aResponse.Ptr()+i, text.Bytes()) == text) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SuiteMsearchResponses::Test()
+{
+    const Brn uri("http://10.0.0.1:55178/TestDviDiscoveryResponses/Upnp/device.xml");
+    const TUint bootId = iDvStack.BootId();
+    DviProtocolUpnpMsearchResponses* responses = new DviProtocolUpnpMsearchResponses(iDvStack, *this, uri, 7, 3);
+    TEST(responses->IsCurrent(3, 7, bootId));
+    TEST(!responses->IsCurrent(4, 7, bootId));
+    TEST(!responses->IsCurrent(3, 8, bootId));
+    TEST(!responses->IsCurrent(3, 7, bootId+1));
+
+    for (TUint i=0; i<3+iServices.size(); i++) {
+        const Brx& response = responses->Response(i);
+        TEST(Contains(response, "HTTP/1.1 200 OK\r\n"));
+        TEST(Contains(response, "LOCATION: http://10.0.0.1:55178/TestDviDiscoveryResponses/Upnp/device.xml\r\n"));
+        TEST(Contains(response, "CONFIGID.UPNP.ORG: 7\r\n"));
+        TEST(Contains(response, "\r\n\r\n"));
+    }
+    const Brx& root = responses->Response(DviProtocolUpnpMsearchResponses::kIndexRoot);
+    TEST(Contains(root, "ST: upnp:rootdevice\r\n"));
+    TEST(Contains(root, "USN: uuid:TestDviDiscoveryResponses::upnp:rootdevice\r\n"));
+    const Brx& uuid = responses->Response(DviProtocolUpnpMsearchResponses::kIndexUuid);
+    TEST(Contains(uuid, "ST: uuid:TestDviDiscoveryResponses\r\n"));
+    const Brx& device = responses->Response(DviProtocolUpnpMsearchResponses::kIndexDeviceType);
+    TEST(Contains(device, "ST: urn:openhome-org:device:Product:2\r\n"));
+    const Brx& service1 = responses->Response(DviProtocolUpnpMsearchResponses::kIndexServiceType);
+    TEST(Contains(service1, "ST: urn:openhome-org:service:Volume:1\r\n"));
+    const Brx& service2 = responses->Response(DviProtocolUpnpMsearchResponses::kIndexServiceType + 1);
+    TEST(Contains(service2, "ST: urn:schemas-upnp-org:service:ContentDirectory:3\r\n"));
+
+    // responses stay valid for as long as a reference is held
+    responses->AddRef();
+    responses->RemoveRef();
+    TEST(Contains(root, "upnp:rootdevice"));
+    responses->RemoveRef();
+
+    iIsRoot = false;
+    responses = new DviProtocolUpnpMsearchResponses(iDvStack, *this, uri, 7, 3);
+    TEST(responses->Response(DviProtocolUpnpMsearchResponses::kIndexRoot).Bytes() == 0);
+    TEST(Contains(responses->Response(DviProtocolUpnpMsearchResponses::kIndexUuid), "ST: uuid:TestDviDiscoveryResponses\r\n"));
+    responses->RemoveRef();
+}
+
+
 void TestDviDiscovery(DvStack& aDvStack)
 {
     InitialisationParams* initParams = aDvStack.Env().InitParams();
     TUint oldMsearchTime = initParams->MsearchTimeSecs();
     initParams->SetMsearchTime(3); // higher time to give valgrind tests a hope of completing
+    TUint oldDuplicateWindow = initParams->SsdpDuplicateWindowMs();
+    initParams->SetSsdpDuplicateWindow(0); // suites below count every message a device sends
 
     //Debug::SetLevel(Debug::kSsdpUnicast);
     Runner runner("SSDP discovery\n");
     runner.Add(new SuiteAlive(aDvStack));
+    runner.Add(new SuitePacketBudget());
+    runner.Add(new SuiteMsearchResponses(aDvStack));
     runner.Add(new SuiteMsearch(aDvStack));
     runner.Run();
 
     initParams->SetMsearchTime(oldMsearchTime);
+    initParams->SetSsdpDuplicateWindow(oldDuplicateWindow);
 }
@@ -15,10 +15,139 @@
 #include <OpenHome/Private/Parser.h>
 #include <OpenHome/Private/Debug.h>
 #include <OpenHome/MimeTypes.h>
+#include <OpenHome/Private/md5.h>
+
+#include <time.h>
 
 using namespace OpenHome;
 using namespace OpenHome::Net;
 
+// DviProtocolUpnpDescription
+
+DviProtocolUpnpDescription::DviProtocolUpnpDescription(Environment& aEnv, Brh& aXml, TUint aGeneration)
+    : iEnv(aEnv)
+    , iRefCount(1)
+    , iLastModified((TUint)time(NULL))
+    , iGeneration(aGeneration)
+{
+    aXml.TransferTo(iXml);
+    md5_state_t state;
+    md5_byte_t digest[16];
+    md5_init(&state);
+    md5_append(&state, (const md5_byte_t*)iXml.Ptr(), iXml.Bytes());
+    md5_finish(&state, digest);
+    iETag.Append('\"');
+    for (TUint i=0; i<sizeof(digest); i++) {
+        Ascii::AppendHex(iETag, digest[i]);
+    }
+    iETag.Append('\"');
+}
+
+TUint DviProtocolUpnpDescription::Generation() const
+{
+    return iGeneration;
+}
+
+void DviProtocolUpnpDescription::AddRef()
+{
+    Mutex& lock = iEnv.Mutex();
+    lock.Wait();
+    iRefCount++;
+    lock.Signal();
+}
+
+void DviProtocolUpnpDescription::RemoveRef()
+{
+    Mutex& lock = iEnv.Mutex();
+    lock.Wait();
+    TBool dead = (--iRefCount == 0);
+    lock.Signal();
+    if (dead) {
+        delete this;
+    }
+}
+
+void DviProtocolUpnpDescription::Write(IResourceWriter& aResourceWriter) const
+{
+    aResourceWriter.WriteResourceValidators(iETag.PtrZ(), iLastModified);
+    aResourceWriter.WriteResourceBegin(iXml.Bytes(), kOhNetMimeTypeXml);
+    aResourceWriter.WriteResource(iXml.Ptr(), iXml.Bytes());
+    aResourceWriter.WriteResourceEnd();
+}
+
+
+// DviProtocolUpnpMsearchResponses
+
+DviProtocolUpnpMsearchResponses::DviProtocolUpnpMsearchResponses(DvStack& aDvStack, IUpnpAnnouncementData& aDevice, const Brx& aUri, TUint aConfigId, TUint aGeneration)
+    : iEnv(aDvStack.Env())
+    , iRefCount(1)
+    , iGeneration(aGeneration)
+    , iConfigId(aConfigId)
+    , iBootId(aDvStack.BootId())
+{
+    WriterBwh writer(SsdpMsearchResponder::kMaxBufferBytes);
+    SsdpMsearchResponseRenderer renderer(aDvStack, writer, aConfigId);
+    const Brx& udn = aDevice.Udn();
+    if (aDevice.IsRoot()) {
+        renderer.SsdpNotifyRoot(udn, aUri);
+    }
+    Add(writer);
+    renderer.SsdpNotifyUuid(udn, aUri);
+    Add(writer);
+    renderer.SsdpNotifyDeviceType(aDevice.Domain(), aDevice.Type(), aDevice.Version(), udn, aUri);
+    Add(writer);
+    const TUint count = aDevice.ServiceCount();
+    for (TUint i=0; i<count; i++) {
+        const OpenHome::Net::ServiceType& serviceType = aDevice.Service(i).ServiceType();
+        renderer.SsdpNotifyServiceType(serviceType.Domain(), serviceType.Name(), serviceType.Version(), udn, aUri);
+        Add(writer);
+    }
+}
+
+DviProtocolUpnpMsearchResponses::~DviProtocolUpnpMsearchResponses()
+{
+    for (TUint i=0; i<iResponses.size(); i++) {
+        delete iResponses[i];
+    }
+}
+
+void DviProtocolUpnpMsearchResponses::Add(WriterBwh& aWriter)
+{
+    iResponses.push_back(new Brh(aWriter.Buffer()));
+    aWriter.Reset();
+}
+
+TBool DviProtocolUpnpMsearchResponses::IsCurrent(TUint aGeneration, TUint aConfigId, TUint aBootId) const
+{
+    return (iGeneration == aGeneration && iConfigId == aConfigId && iBootId == aBootId);
+}
+
+void DviProtocolUpnpMsearchResponses::AddRef()
+{
+    Mutex& lock = iEnv.Mutex();
+    lock.Wait();
+    iRefCount++;
+    lock.Signal();
+}
+
+void DviProtocolUpnpMsearchResponses::RemoveRef()
+{
+    Mutex& lock = iEnv.Mutex();
+    lock.Wait();
+    TBool dead = (--iRefCount == 0);
+    lock.Signal();
+    if (dead) {
+        delete this;
+    }
+}
+
+const Brx& DviProtocolUpnpMsearchResponses::Response(TUint aIndex) const
+{
+    ASSERT(aIndex < iResponses.size());
+    return *(iResponses[aIndex]);
+}
+
+
 // DviProtocolUpnp
 
 const Brn DviProtocolUpnp::kProtocolName("Upnp");
@@ -86,6 +215,11 @@ DviProtocolUpnp::~DviProtocolUpnp()
         adapters[i]->Destroy();
     }
     iDvStack.SsdpNotifierManager().Stop(iDevice.Udn());
+    DescriptionMap::iterator it = iServiceXml.begin();
+    while (it != iServiceXml.end()) {
+        it->second->RemoveRef();
+        it++;
+    }
 }
 
 const Brx& DviProtocolUpnp::Udn() const
@@ -232,32 +366,18 @@ TInt DviProtocolUpnp::FindListenerForInterface(TIpAddress aAdapter)
 void DviProtocolUpnp::WriteResource(const Brx& aUriTail, TIpAddress aAdapter, std::vector<char*>& aLanguageList, IResourceWriter& aResourceWriter)
 {
     if (aUriTail == kDeviceXmlName) {
-        Brh xml;
-        Brn xmlBuf;
-        AutoMutex _(iLock);
-        const TInt index = FindListenerForInterface(aAdapter);
-        if (index == -1) {
+        DviProtocolUpnpDescription* xml = DeviceXml(aAdapter);
+        if (xml == NULL) {
             return;
         }
-        if (iDevice.IsRoot()) {
-            const Brx& cachedXml = iAdapters[index]->DeviceXml();
-            if (cachedXml.Bytes() > 0) {
-                xmlBuf.Set(cachedXml);
-            }
+        try {
+            xml->Write(aResourceWriter);
         }
-        if (xmlBuf.Bytes() == 0) {
-            GetDeviceXml(xml, aAdapter);
-            if (iDevice.IsRoot()) {
-                iAdapters[index]->SetDeviceXml(xml);
-                xmlBuf.Set(iAdapters[index]->DeviceXml());
-            }
-            else {
-                xmlBuf.Set(xml);
-            }
+        catch (Exception&) {
+            xml->RemoveRef();
+            throw;
         }
-        aResourceWriter.WriteResourceBegin(xmlBuf.Bytes(), kOhNetMimeTypeXml);
-        aResourceWriter.WriteResource(xmlBuf.Ptr(), xmlBuf.Bytes());
-        aResourceWriter.WriteResourceEnd();
+        xml->RemoveRef();
     }
     else {
         Parser parser(aUriTail);
@@ -270,25 +390,97 @@ void DviProtocolUpnp::WriteResource(const Brx& aUriTail, TIpAddress aAdapter, st
             }
         }
         else if (rem == kServiceXmlName) {
-            iLock.Wait();
-            DviService* service = 0;
-            const TUint count = iDevice.ServiceCount();
-            for (TUint i=0; i<count; i++) {
-                DviService& s = iDevice.Service(i);
-                if (s.ServiceType().PathUpnp() == buf) {
-                    service = &s;
-                    break;
-                }
-            }
-            iLock.Signal();
-            if (service == 0) {
+            DviProtocolUpnpDescription* xml = ServiceXml(buf);
+            if (xml == NULL) {
                 THROW(ReaderError);
             }
-            DviProtocolUpnpServiceXmlWriter::Write(*service, *this, aResourceWriter);
+            try {
+                xml->Write(aResourceWriter);
+            }
+            catch (Exception&) {
+                xml->RemoveRef();
+                throw;
+            }
+            xml->RemoveRef();
         }
     }
 }
 
+DviProtocolUpnpDescription* DviProtocolUpnp::DeviceXml(TIpAddress aAdapter)
+{
+    AutoMutex _(iLock);
+    const TInt index = FindListenerForInterface(aAdapter);
+    if (index == -1) {
+        return NULL;
+    }
+    const TUint generation = iDevice.ConfigGeneration();
+    DviProtocolUpnpDescription* xml = iAdapters[index]->DeviceXml(generation);
+    if (xml == NULL) {
+        Brh buf;
+        GetDeviceXml(buf, aAdapter);
+        xml = new DviProtocolUpnpDescription(iDvStack.Env(), buf, generation);
+        iAdapters[index]->SetDeviceXml(xml);
+    }
+    xml->AddRef();
+    return xml;
+}
+
+DviProtocolUpnpDescription* DviProtocolUpnp::ServiceXml(const Brx& aServicePath)
+{
+    AutoMutex _(iLock);
+    DviService* service = NULL;
+    const TUint count = iDevice.ServiceCount();
+    for (TUint i=0; i<count; i++) {
+        DviService& s = iDevice.Service(i);
+        if (s.ServiceType().PathUpnp() == aServicePath) {
+            service = &s;
+            break;
+        }
+    }
+    if (service == NULL) {
+        return NULL;
+    }
+    const TUint generation = iDevice.ConfigGeneration();
+    Brn path(service->ServiceType().PathUpnp());
+    DescriptionMap::iterator it = iServiceXml.find(path);
+    DviProtocolUpnpDescription* xml = NULL;
+    if (it != iServiceXml.end()) {
+        if (it->second->Generation() == generation) {
+            xml = it->second;
+        }
+        else {
+            it->second->RemoveRef();
+            iServiceXml.erase(it);
+        }
+    }
+    if (xml == NULL) {
+        Brh buf;
+        DviProtocolUpnpServiceXmlWriter::Write(*service, *this, buf);
+        xml = new DviProtocolUpnpDescription(iDvStack.Env(), buf, generation);
+        iServiceXml.insert(std::pair<Brn,DviProtocolUpnpDescription*>(path, xml));
+    }
+    xml->AddRef();
+    return xml;
+}
+
+DviProtocolUpnpMsearchResponses* DviProtocolUpnp::MsearchResponses(TUint aAdapterIndex)
+{
+    // iLock must be held
+    DviProtocolUpnpAdapterSpecificData* adapter = iAdapters[aAdapterIndex];
+    const TUint generation = iDevice.ConfigGeneration();
+    const TUint configId = iDevice.ConfigId();
+    const TUint bootId = iDvStack.BootId();
+    DviProtocolUpnpMsearchResponses* responses = adapter->MsearchResponses(generation, configId, bootId);
+    if (responses == NULL) {
+        Bws<kMaxUriBytes> uri;
+        GetUriDeviceXml(uri, adapter->UriBase());
+        responses = new DviProtocolUpnpMsearchResponses(iDvStack, *this, uri, configId, generation);
+        adapter->SetMsearchResponses(responses);
+    }
+    responses->AddRef();
+    return responses;
+}
+
 const Brx& DviProtocolUpnp::ProtocolName() const
 {
     return kProtocolName;
@@ -586,9 +778,9 @@ void DviProtocolUpnp::SsdpSearchAll(const Endpoint& aEndpoint, TUint aMx, TIpAdd
         TInt index = FindListenerForInterface(aAdapter);
         if (index != -1) {
             LogUnicastNotification("all");
-            Bws<kMaxUriBytes> uri;
-            GetUriDeviceXml(uri, iAdapters[index]->UriBase());
-            iDvStack.SsdpNotifierManager().MsearchResponseAll(*this, aEndpoint, aMx, uri, iDevice.ConfigId(), aAdapter);
+            DviProtocolUpnpMsearchResponses* responses = MsearchResponses(index);
+            iDvStack.SsdpNotifierManager().MsearchResponseAll(*this, *responses, aEndpoint, aMx, aAdapter);
+            responses->RemoveRef();
         }
     }
 }
@@ -600,9 +792,9 @@ void DviProtocolUpnp::SsdpSearchRoot(const Endpoint& aEndpoint, TUint aMx, TIpAd
         TInt index = FindListenerForInterface(aAdapter);
         if (index != -1) {
             LogUnicastNotification("root");
-            Bws<kMaxUriBytes> uri;
-            GetUriDeviceXml(uri, iAdapters[index]->UriBase());
-            iDvStack.SsdpNotifierManager().MsearchResponseRoot(*this, aEndpoint, aMx, uri, iDevice.ConfigId(), aAdapter);
+            DviProtocolUpnpMsearchResponses* responses = MsearchResponses(index);
+            iDvStack.SsdpNotifierManager().MsearchResponseRoot(*this, *responses, aEndpoint, aMx, aAdapter);
+            responses->RemoveRef();
         }
     }
 }
@@ -614,9 +806,9 @@ void DviProtocolUpnp::SsdpSearchUuid(const Endpoint& aEndpoint, TUint aMx, TIpAd
         TInt index = FindListenerForInterface(aAdapter);
         if (index != -1) {
             LogUnicastNotification("uuid");
-            Bws<kMaxUriBytes> uri;
-            GetUriDeviceXml(uri, iAdapters[index]->UriBase());
-            iDvStack.SsdpNotifierManager().MsearchResponseUuid(*this, aEndpoint, aMx, uri, iDevice.ConfigId(), aAdapter);
+            DviProtocolUpnpMsearchResponses* responses = MsearchResponses(index);
+            iDvStack.SsdpNotifierManager().MsearchResponseUuid(*this, *responses, aEndpoint, aMx, aAdapter);
+            responses->RemoveRef();
         }
     }
 }
@@ -628,9 +820,9 @@ void DviProtocolUpnp::SsdpSearchDeviceType(const Endpoint& aEndpoint, TUint aMx,
         TInt index = FindListenerForInterface(aAdapter);
         if (index != -1) {
             LogUnicastNotification("device");
-            Bws<kMaxUriBytes> uri;
-            GetUriDeviceXml(uri, iAdapters[index]->UriBase());
-            iDvStack.SsdpNotifierManager().MsearchResponseDeviceType(*this, aEndpoint, aMx, uri, iDevice.ConfigId(), aAdapter);
+            DviProtocolUpnpMsearchResponses* responses = MsearchResponses(index);
+            iDvStack.SsdpNotifierManager().MsearchResponseDeviceType(*this, *responses, aEndpoint, aMx, aAdapter);
+            responses->RemoveRef();
         }
     }
 }
@@ -646,9 +838,9 @@ void DviProtocolUpnp::SsdpSearchServiceType(const Endpoint& aEndpoint, TUint aMx
                 TInt index = FindListenerForInterface(aAdapter);
                 if (index != -1) {
                     LogUnicastNotification("service");
-                    Bws<kMaxUriBytes> uri;
-                    GetUriDeviceXml(uri, iAdapters[index]->UriBase());
-                    iDvStack.SsdpNotifierManager().MsearchResponseServiceType(*this, aEndpoint, aMx, serviceType, uri, iDevice.ConfigId(), aAdapter);
+                    DviProtocolUpnpMsearchResponses* responses = MsearchResponses(index);
+                    iDvStack.SsdpNotifierManager().MsearchResponseServiceType(*this, *responses, aEndpoint, aMx, serviceType, aAdapter);
+                    responses->RemoveRef();
                 }
                 break;
             }
@@ -669,6 +861,8 @@ DviProtocolUpnpAdapterSpecificData::DviProtocolUpnpAdapterSpecificData(DvStack&
     , iMask(aAdapter.Mask())
     , iUriBase(aUriBase)
     , iServerPort(aServerPort)
+    , iDeviceXml(NULL)
+    , iMsearchResponses(NULL)
 #ifndef DEFINE_WINDOWS_UNIVERSAL
     , iBonjourWebPage(0)
 #endif
@@ -697,6 +891,8 @@ DviProtocolUpnpAdapterSpecificData::~DviProtocolUpnpAdapterSpecificData()
 #endif
     iListener->RemoveMsearchHandler(iId);
     iDvStack.Env().MulticastListenerRelease(iAdapter);
+    ClearDeviceXml();
+    ClearMsearchResponses();
 }
 
 TIpAddress DviProtocolUpnpAdapterSpecificData::Interface() const
@@ -722,7 +918,12 @@ void DviProtocolUpnpAdapterSpecificData::UpdateServerPort(DviServerUpnp& aServer
 
 void DviProtocolUpnpAdapterSpecificData::UpdateUriBase(Bwx& aUriBase)
 {
-    iUriBase.Replace(aUriBase);
+    if (iUriBase != aUriBase) {
+        // device xml and msearch responses include absolute urls so are now out of date
+        ClearDeviceXml();
+        ClearMsearchResponses();
+        iUriBase.Replace(aUriBase);
+    }
 }
 
 TUint DviProtocolUpnpAdapterSpecificData::ServerPort() const
@@ -730,20 +931,48 @@ TUint DviProtocolUpnpAdapterSpecificData::ServerPort() const
     return iServerPort;
 }
 
-const Brx& DviProtocolUpnpAdapterSpecificData::DeviceXml() const
+DviProtocolUpnpDescription* DviProtocolUpnpAdapterSpecificData::DeviceXml(TUint aGeneration) const
 {
+    if (iDeviceXml == NULL || iDeviceXml->Generation() != aGeneration) {
+        return NULL;
+    }
     return iDeviceXml;
 }
 
-void DviProtocolUpnpAdapterSpecificData::SetDeviceXml(Brh& aXml)
+void DviProtocolUpnpAdapterSpecificData::SetDeviceXml(DviProtocolUpnpDescription* aXml)
 {
-    aXml.TransferTo(iDeviceXml);
+    ClearDeviceXml();
+    iDeviceXml = aXml;
 }
 
 void DviProtocolUpnpAdapterSpecificData::ClearDeviceXml()
 {
-    Brh tmp;
-    iDeviceXml.TransferTo(tmp);
+    if (iDeviceXml != NULL) {
+        iDeviceXml->RemoveRef();
+        iDeviceXml = NULL;
+    }
+}
+
+DviProtocolUpnpMsearchResponses* DviProtocolUpnpAdapterSpecificData::MsearchResponses(TUint aGeneration, TUint aConfigId, TUint aBootId) const
+{
+    if (iMsearchResponses == NULL || !iMsearchResponses->IsCurrent(aGeneration, aConfigId, aBootId)) {
+        return NULL;
+    }
+    return iMsearchResponses;
+}
+
+void DviProtocolUpnpAdapterSpecificData::SetMsearchResponses(DviProtocolUpnpMsearchResponses* aResponses)
+{
+    ClearMsearchResponses();
+    iMsearchResponses = aResponses;
+}
+
+void DviProtocolUpnpAdapterSpecificData::ClearMsearchResponses()
+{
+    if (iMsearchResponses != NULL) {
+        iMsearchResponses->RemoveRef();
+        iMsearchResponses = NULL;
+    }
 }
 
 void DviProtocolUpnpAdapterSpecificData::SetPendingDelete()
@@ -1122,15 +1351,11 @@ void DviProtocolUpnpDeviceXmlWriter::WriteResourceEnd()
 
 // DviProtocolUpnpServiceXmlWriter
 
-void DviProtocolUpnpServiceXmlWriter::Write(const DviService& aService, const DviProtocolUpnp& aDevice, IResourceWriter& aResourceWriter)
+void DviProtocolUpnpServiceXmlWriter::Write(const DviService& aService, const DviProtocolUpnp& aDevice, Brh& aXml)
 {
     WriterBwh writer(1024);
     WriteServiceXml(writer, aService, aDevice);
-    Brh xml;
-    writer.TransferTo(xml);
-    aResourceWriter.WriteResourceBegin(xml.Bytes(), kOhNetMimeTypeXml);
-    aResourceWriter.WriteResource(xml.Ptr(), xml.Bytes());
-    aResourceWriter.WriteResourceEnd();
+    writer.TransferTo(aXml);
 }
 
 void DviProtocolUpnpServiceXmlWriter::WriteServiceXml(WriterBwh& aWriter, const DviService& aService, const DviProtocolUpnp& aDevice)
@@ -15,6 +15,7 @@
 #include <OpenHome/Net/Private/DviServerUpnp.h>
 
 #include <vector>
+#include <map>
 
 namespace OpenHome {
 namespace Net {
@@ -25,6 +26,65 @@ class BonjourWebPage;
 class DviProtocolUpnpAdapterSpecificData;
 class DvStack;
 
+/**
+ * Immutable, pre-rendered device or service description
+ *
+ * Shared between all sessions serving it; reference counted so that a description
+ * can be replaced while earlier copies are still being written.
+ */
+class DviProtocolUpnpDescription : private INonCopyable
+{
+public:
+    DviProtocolUpnpDescription(Environment& aEnv, Brh& aXml, TUint aGeneration);
+    TUint Generation() const;
+    void AddRef();
+    void RemoveRef();
+    void Write(IResourceWriter& aResourceWriter) const;
+private:
+    ~DviProtocolUpnpDescription() {}
+private:
+    static const TUint kMaxETagBytes = 2 + 32; // quoted md5 hash
+    Environment& iEnv;
+    TUint iRefCount;
+    Brh iXml;
+    Bws<kMaxETagBytes+1> iETag;
+    TUint iLastModified;
+    TUint iGeneration;
+};
+
+class IUpnpAnnouncementData;
+
+/**
+ * Immutable, pre-rendered msearch responses for a device on one adapter
+ *
+ * Indexed in the same order as announcements (root, uuid, device type then services).
+ * Reference counted so that responses already scheduled can complete after the device changes.
+ */
+class DviProtocolUpnpMsearchResponses : private INonCopyable
+{
+public:
+    static const TUint kIndexRoot        = 0;
+    static const TUint kIndexUuid        = 1;
+    static const TUint kIndexDeviceType  = 2;
+    static const TUint kIndexServiceType = 3;
+public:
+    DviProtocolUpnpMsearchResponses(DvStack& aDvStack, IUpnpAnnouncementData& aDevice, const Brx& aUri, TUint aConfigId, TUint aGeneration);
+    TBool IsCurrent(TUint aGeneration, TUint aConfigId, TUint aBootId) const;
+    void AddRef();
+    void RemoveRef();
+    const Brx& Response(TUint aIndex) const;
+private:
+    ~DviProtocolUpnpMsearchResponses();
+    void Add(WriterBwh& aWriter);
+private:
+    Environment& iEnv;
+    TUint iRefCount;
+    TUint iGeneration;
+    TUint iConfigId;
+    TUint iBootId;
+    std::vector<Brh*> iResponses;
+};
+
 class IUpnpMsearchHandler
 {
 public:
@@ -83,6 +143,9 @@ private:
     void SendUpdateNotifications();
     void GetUriDeviceXml(Bwx& aUri, const Brx& aUriBase);
     void GetDeviceXml(Brh& aXml, TIpAddress aAdapter);
+    DviProtocolUpnpDescription* DeviceXml(TIpAddress aAdapter);
+    DviProtocolUpnpDescription* ServiceXml(const Brx& aServicePath);
+    DviProtocolUpnpMsearchResponses* MsearchResponses(TUint aAdapterIndex);
     void LogMulticastNotification(const char* aType);
     void LogUnicastNotification(const char* aType);
 public: // from IDvProtocol
@@ -115,6 +178,8 @@ private:
     TUint iUpdateCount;
     TBool iSuppressScheduledEvents;
     DviServerUpnp* iServer;
+    typedef std::map<Brn,DviProtocolUpnpDescription*,BufferCmp> DescriptionMap;
+    DescriptionMap iServiceXml; // service xml doesn't vary by adapter so is shared by all of them
 };
 
 class DviProtocolUpnpAdapterSpecificData : public ISsdpMsearchHandler, public INonCopyable
@@ -129,9 +194,12 @@ public:
     void UpdateServerPort(DviServerUpnp& aServer);
     void UpdateUriBase(Bwx& aUriBase);
     TUint ServerPort() const;
-    const Brx& DeviceXml() const;
-    void SetDeviceXml(Brh& aXml);
+    DviProtocolUpnpDescription* DeviceXml(TUint aGeneration) const; // NULL if out of date
+    void SetDeviceXml(DviProtocolUpnpDescription* aXml);
     void ClearDeviceXml();
+    DviProtocolUpnpMsearchResponses* MsearchResponses(TUint aGeneration, TUint aConfigId, TUint aBootId) const; // NULL if out of date
+    void SetMsearchResponses(DviProtocolUpnpMsearchResponses* aResponses);
+    void ClearMsearchResponses();
     void SetPendingDelete();
     void BonjourRegister(const TChar* aName, const Brx& aUdn, const Brx& aProtocol, const Brx& aResourceDir);
     void BonjourDeregister();
@@ -158,7 +226,8 @@ private:
     TIpAddress iMask;
     Bws<Uri::kMaxUriBytes> iUriBase;
     TUint iServerPort;
-    Brh iDeviceXml;
+    DviProtocolUpnpDescription* iDeviceXml;
+    DviProtocolUpnpMsearchResponses* iMsearchResponses;
 #ifndef DEFINE_WINDOWS_UNIVERSAL
     BonjourWebPage* iBonjourWebPage;
 #endif
@@ -197,7 +266,7 @@ private:
 class DviProtocolUpnpServiceXmlWriter
 {
 public:
-    static void Write(const DviService& aService, const DviProtocolUpnp& aDevice, IResourceWriter& aResourceWriter);
+    static void Write(const DviService& aService, const DviProtocolUpnp& aDevice, Brh& aXml);
 private:
     static void WriteServiceXml(WriterBwh& aWriter, const DviService& aService, const DviProtocolUpnp& aDevice);
     static void WriteServiceActionParams(WriterBwh& aWriter, const Action& aAction, TBool aIn);
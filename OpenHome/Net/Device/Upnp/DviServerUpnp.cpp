@@ -12,7 +12,9 @@
 #include <OpenHome/Private/Printer.h>
 #include <OpenHome/Net/Private/XmlParser.h>
 #include <OpenHome/Private/Converter.h>
+#include <OpenHome/Private/Compression.h>
 #include <OpenHome/Private/Stream.h>
+#include <OpenHome/Private/File.h>
 #include <OpenHome/Net/Core/OhNet.h>
 #include <OpenHome/Private/Debug.h>
 #include <OpenHome/Net/Private/Error.h>
@@ -34,6 +36,24 @@ static const Brn kUpnpMethodSubscribe("SUBSCRIBE");
 static const Brn kUpnpMethodUnsubscribe("UNSUBSCRIBE");
 static const Brn kUpnpMethodNotify("NOTIFY");
 
+static TBool IsCompressible(const Brx& aMimeType)
+{
+    // most other resources (images etc) are stored in an already compressed format
+    return (aMimeType.BeginsWith(Brn("text/")) || Ascii::Contains(aMimeType, Brn("xml")) ||
+            Ascii::Contains(aMimeType, Brn("json")) || Ascii::Contains(aMimeType, Brn("javascript")));
+}
+
+static void ETagForCoding(Bwx& aETag, const Brx& aCoding)
+{
+    // give each content coding of a resource a distinct entity tag - "abc" becomes "abc-gzip"
+    if (aETag.Bytes() > 0 && aETag[aETag.Bytes()-1] == '"' && aETag.Bytes() + aCoding.Bytes() + 1 <= aETag.MaxBytes()) {
+        aETag.SetBytes(aETag.Bytes() - 1);
+        aETag.Append('-');
+        aETag.Append(aCoding);
+        aETag.Append('"');
+    }
+}
+
 
 // HeaderSoapAction
 
@@ -366,7 +386,7 @@ void PropertyWriterUpnp::WriteHeaders(TUint aContentLength)
     writer.WriteFlush();
 
     iWriterEvent->WriteHeader(Http::kHeaderConnection, Http::kConnectionClose);
-    iWriterEvent->WriteFlush();
+    iWriterEvent->WriteHeadersEnd();
 }
 
 PropertyWriterUpnp::~PropertyWriterUpnp()
@@ -390,7 +410,8 @@ void PropertyWriterUpnp::PropertyWriteEnd()
         //iSocket.LogVerbose(true);
         const Brx& body = iEventBody.Buffer();
         WriteHeaders(body.Bytes());
-        iSocket.Write(body);
+        iWriteBuffer->Write(body);
+        iWriteBuffer->WriteFlush();
     }
     catch (NetworkTimeout&) {
         LOG2(kDvEvent, kError, "PropertyWriterUpnp - NetworkTimeout eventing to %.*s\n", PBUF(subscriberAddress));
@@ -551,6 +572,103 @@ void PropertyWriterFactory::RemoveRef()
 }
 
 
+// WriterCapture
+
+WriterCapture::WriterCapture(IWriter& aWriter, IWriterCaptureOverflow& aOverflow)
+    : iWriter(aWriter)
+    , iOverflow(aOverflow)
+    , iMaxBytes(0)
+    , iCapturing(false)
+{
+}
+
+void WriterCapture::StartCapture(TUint aExpectedBytes, TUint aMaxBytes)
+{
+    iCaptured.SetBytes(0);
+    if (aExpectedBytes > 0 && (iCaptured.Ptr() == NULL || aExpectedBytes > iCaptured.MaxBytes())) {
+        iCaptured.Grow(aExpectedBytes);
+    }
+    iMaxBytes = aMaxBytes;
+    iCapturing = true;
+}
+
+void WriterCapture::StopCapture()
+{
+    iCapturing = false;
+}
+
+TBool WriterCapture::IsCapturing() const
+{
+    return iCapturing;
+}
+
+const Brx& WriterCapture::Captured() const
+{
+    return iCaptured;
+}
+
+void WriterCapture::ReleaseCaptured(TUint aMaxRetainedBytes)
+{
+    ASSERT(!iCapturing);
+    if (iCaptured.Ptr() != NULL && iCaptured.MaxBytes() > aMaxRetainedBytes) {
+        Brh discard;
+        iCaptured.TransferTo(discard);
+    }
+}
+
+void WriterCapture::Write(TByte aValue)
+{
+    Brn buf(&aValue, 1);
+    Write(buf);
+}
+
+void WriterCapture::Write(const Brx& aBuffer)
+{
+    if (!iCapturing) {
+        iWriter.Write(aBuffer);
+        return;
+    }
+    const TUint bytes = iCaptured.Bytes() + aBuffer.Bytes();
+    if (iMaxBytes > 0 && bytes > iMaxBytes) {
+        iCapturing = false;
+        iOverflow.CaptureOverflowed(iWriter);
+        iWriter.Write(iCaptured);
+        iCaptured.SetBytes(0);
+        iWriter.Write(aBuffer);
+        return;
+    }
+    if (iCaptured.Ptr() == NULL || bytes > iCaptured.MaxBytes()) {
+        TUint maxBytes = (iCaptured.Ptr() == NULL || iCaptured.MaxBytes() == 0? 1024 : iCaptured.MaxBytes());
+        while (maxBytes < bytes) {
+            maxBytes *= 2;
+        }
+        if (iMaxBytes > 0 && maxBytes > iMaxBytes) {
+            maxBytes = iMaxBytes;
+        }
+        iCaptured.Grow(maxBytes);
+    }
+    iCaptured.Append(aBuffer);
+}
+
+void WriterCapture::WriteFlush()
+{
+    if (!iCapturing) {
+        iWriter.WriteFlush();
+    }
+}
+
+void WriterCapture::WriteVector(const Brx* const aBuffers[], TUint aCount)
+{
+    if (!iCapturing) {
+        iWriter.WriteVector(aBuffers, aCount);
+        return;
+    }
+    for (TUint i=0; i<aCount; i++) {
+        Write(*aBuffers[i]);
+    }
+}
+
+
 // DviSessionUpnp
 
 DviSessionUpnp::DviSessionUpnp(DvStack& aDvStack, TIpAddress aInterface, TUint aPort,
@@ -562,6 +680,7 @@ DviSessionUpnp::DviSessionUpnp(DvStack& aDvStack, TIpAddress aInterface, TUint a
     , iPropertyWriterFactory(aPropertyWriterFactory)
     , iPathMapper(aPathMapper)
     , iRedirector(aRedirector)
+    , iNextSoapArg(0)
     , iShutdownSem("DSUS", 1)
 {
     iReadBuffer = new Srs<1024>(*this);
@@ -569,7 +688,8 @@ DviSessionUpnp::DviSessionUpnp(DvStack& aDvStack, TIpAddress aInterface, TUint a
     iReaderRequest = new ReaderHttpRequest(aDvStack.Env(), *iReaderUntil);
     iDechunker = new ReaderHttpChunked(*iReaderUntil);
     iWriterChunked = new WriterHttpChunked(*this);
-    iWriterBuffer = new Sws<kMaxResponseBytes>(*iWriterChunked);
+    iWriterCapture = new WriterCapture(*iWriterChunked, *this);
+    iWriterBuffer = new Sws<kMaxResponseBytes>(*iWriterCapture);
     iWriterResponse = new WriterHttpResponse(*iWriterBuffer);
 
     iReaderRequest->AddMethod(Http::kMethodGet);
@@ -590,6 +710,10 @@ DviSessionUpnp::DviSessionUpnp(DvStack& aDvStack, TIpAddress aInterface, TUint a
     iReaderRequest->AddHeader(iHeaderCallback);
     iReaderRequest->AddHeader(iHeaderAcceptLanguage);
     iReaderRequest->AddHeader(iHeaderUserAgent);
+    iReaderRequest->AddHeader(iHeaderIfNoneMatch);
+    iReaderRequest->AddHeader(iHeaderAcceptEncoding);
+    iReaderRequest->AddHeader(iHeaderRange);
+    iReaderRequest->AddHeader(iHeaderIfRange);
 }
 
 DviSessionUpnp::~DviSessionUpnp()
@@ -598,6 +722,7 @@ DviSessionUpnp::~DviSessionUpnp()
     iShutdownSem.Wait();
     delete iWriterResponse;
     delete iWriterBuffer;
+    delete iWriterCapture;
     delete iWriterChunked;
     delete iDechunker;
     delete iReaderRequest;
@@ -611,8 +736,21 @@ void DviSessionUpnp::Run()
     iErrorStatus = &HttpStatus::kOk;
     iReaderRequest->Flush();
     iWriterChunked->SetChunked(false);
+    iWriterCapture->StopCapture();
+    iWriterCapture->ReleaseCaptured(kMaxRetainedCaptureBytes);
     iInvocationService = NULL;
     iResourceWriterHeadersOnly = false;
+    iResourceETag.SetBytes(0);
+    iResourceLastModified = 0;
+    iResourceNotModified = false;
+    iResourceRanged = false;
+    iResourceRangeUnsatisfiable = false;
+    iResourceOffset = 0;
+    if (iSoapRequest.Ptr() != NULL && iSoapRequest.MaxBytes() > kMaxRetainedRequestBytes) {
+        // don't hold on to the memory for an occasional large request
+        Brh discard;
+        iSoapRequest.TransferTo(discard);
+    }
     iSoapRequest.SetBytes(0);
     iDechunker->SetChunked(false);
     iDechunker->ReadFlush();
@@ -740,6 +878,11 @@ void DviSessionUpnp::Post()
             }
             if (iHeaderContentLength.ContentLength() != 0) {
                 TUint remaining = iHeaderContentLength.ContentLength();
+                if (remaining > kMaxRequestBytes) {
+                    iErrorStatus = &HttpStatus::kRequestEntityTooLarge;
+                    THROW(ReaderError);
+                }
+                ReserveSoapRequest(remaining);
                 do {
                     Brn buf = iReaderUntil->Read(remaining);
                     iSoapRequest.Append(buf);
@@ -757,10 +900,11 @@ void DviSessionUpnp::Post()
                     if (buf.Bytes() == 0) { // end of stream
                         break;
                     }
-                    if (iSoapRequest.Bytes() + buf.Bytes() > iSoapRequest.MaxBytes()) {
+                    if (iSoapRequest.Bytes() + buf.Bytes() > kMaxRequestBytes) {
                         iErrorStatus = &HttpStatus::kRequestEntityTooLarge;
                         THROW(ReaderError);
                     }
+                    ReserveSoapRequest(iSoapRequest.Bytes() + buf.Bytes());
                     iSoapRequest.Append(buf);
                 }
             }
@@ -778,6 +922,36 @@ void DviSessionUpnp::Post()
     }
 }
 
+void DviSessionUpnp::ReserveSoapRequest(TUint aBytes)
+{
+    if (iSoapRequest.Ptr() != NULL && aBytes <= iSoapRequest.MaxBytes()) {
+        return;
+    }
+    TUint maxBytes = (iSoapRequest.Ptr() == NULL? kMinRequestBytes : 2 * iSoapRequest.MaxBytes());
+    if (maxBytes < aBytes) {
+        maxBytes = aBytes;
+    }
+    else if (maxBytes > kMaxRequestBytes) {
+        maxBytes = (aBytes > kMaxRequestBytes? aBytes : kMaxRequestBytes);
+    }
+    iSoapRequest.Grow(maxBytes);
+}
+
+Brn DviSessionUpnp::SoapArgument(const TChar* aName)
+{
+    // providers read arguments in the order they're declared, which is also the order they're sent in
+    const Brn name(aName);
+    const TUint count = (TUint)iSoapArgNames.size();
+    for (TUint i=0; i<count; i++) {
+        const TUint index = (iNextSoapArg + i) % count;
+        if (Ascii::CaseInsensitiveEquals(iSoapArgNames[index], name)) {
+            iNextSoapArg = index + 1;
+            return iSoapArgValues[index];
+        }
+    }
+    THROW(XmlError);
+}
+
 void DviSessionUpnp::Subscribe()
 {
     {
@@ -986,24 +1160,41 @@ void DviSessionUpnp::WriteResourceBegin(TUint aTotalBytes, const TChar* aMimeTyp
         iWriterResponse->WriteStatus(HttpStatus::kContinue, Http::eHttp11);
         iWriterResponse->WriteFlush();
     }
-    iWriterResponse->WriteStatus(HttpStatus::kOk, Http::eHttp11);
-    if (aTotalBytes > 0) {
-        Http::WriteHeaderContentLength(*iWriterResponse, aTotalBytes);
+    if (iResourceNotModified) {
+        iWriterResponse->WriteStatus(HttpStatus::kNotModified, Http::eHttp11);
+        iWriterResponse->WriteHeader(Http::kHeaderETag, iResourceETag);
+        if (iResourceLastModified != 0) {
+            Http::WriteHeaderLastModified(*iWriterResponse, iResourceLastModified);
+        }
+        Http::WriteHeaderConnectionClose(*iWriterResponse);
+        iWriterResponse->WriteFlush();
+        iResponseStarted = true;
+        return;
     }
-    else {
-        if (iReaderRequest->Version() == Http::eHttp11) { 
-            iWriterResponse->WriteHeader(Http::kHeaderTransferEncoding, Http::kTransferEncodingChunked);
+    const Brn mimeType(aMimeType == NULL? "" : aMimeType);
+    const TBool compressible = (aTotalBytes >= kMinCompressBytes && aTotalBytes <= kMaxCompressBytes &&
+                                mimeType.Bytes() <= iResourceMimeType.MaxBytes() && IsCompressible(mimeType));
+    if (aTotalBytes > 0 && iHeaderRange.Received() &&
+        (!iHeaderIfRange.Received() || iHeaderIfRange.Matches(iResourceETag))) {
+        if (!iHeaderRange.Resolve(aTotalBytes, iResourceRangeFirst, iResourceRangeBytes)) {
+            WriteRangeNotSatisfiable(aTotalBytes);
+            return;
         }
+        iResourceRanged = true;
+        iResourceTotalBytes = aTotalBytes;
+        WriteResourceHeaders(iResourceRangeBytes, mimeType, Brx::Empty(), compressible);
+        iResponseStarted = true;
+        return;
     }
-    if (aMimeType != NULL) {
-        IWriterAscii& writer = iWriterResponse->WriteHeaderField(Http::kHeaderContentType);
-        writer.Write(Brn(aMimeType));
-        writer.Write(Brn("; charset=\"utf-8\""));
-        writer.WriteFlush();
+    if (compressible && AcceptsCompression() && !iResourceWriterHeadersOnly) {
+        // headers are written by WriteResourceEnd, once the compressed size is known
+        iResourceMimeType.Replace(mimeType);
+        StartCompressedResponse(aTotalBytes, 0); // no need to limit the capture; we already know the size is acceptable
+        return;
     }
-    Http::WriteHeaderConnectionClose(*iWriterResponse);
-    iWriterResponse->WriteFlush();
-    if (aTotalBytes == 0) {
+    WriteResourceHeaders(aTotalBytes, mimeType, Brx::Empty(), compressible);
+    if (aTotalBytes == 0 && !iResourceWriterHeadersOnly) {
+        // size unknown; stream the body rather than buffering it all
         if (iReaderRequest->Version() == Http::eHttp11) { 
             iWriterChunked->SetChunked(true);
         }
@@ -1013,10 +1204,24 @@ void DviSessionUpnp::WriteResourceBegin(TUint aTotalBytes, const TChar* aMimeTyp
 
 void DviSessionUpnp::WriteResource(const TByte* aData, TUint aBytes)
 {
-    if (iResourceWriterHeadersOnly) {
+    if (iResourceWriterHeadersOnly || iResourceNotModified || iResourceRangeUnsatisfiable || aBytes == 0) {
         return;
     }
     Brn buf(aData, aBytes);
+    if (iResourceRanged) {
+        // only pass on the part of aData that falls within the requested range
+        const TUint64 start = iResourceOffset;
+        const TUint64 end = start + aBytes;
+        const TUint64 rangeStart = iResourceRangeFirst;
+        const TUint64 rangeEnd = rangeStart + iResourceRangeBytes;
+        iResourceOffset = end;
+        if (end <= rangeStart || start >= rangeEnd) {
+            return;
+        }
+        const TUint64 from = (start < rangeStart? rangeStart : start);
+        const TUint64 to = (end > rangeEnd? rangeEnd : end);
+        buf.Set(aData + (from - start), (TUint)(to - from));
+    }
 #if 0
     Log::Print("Writing resource...\n");
     Log::Print(buf);
@@ -1028,9 +1233,201 @@ void DviSessionUpnp::WriteResource(const TByte* aData, TUint aBytes)
 void DviSessionUpnp::WriteResourceEnd()
 {
     iResponseEnded = true;
+    if (!iWriterCapture->IsCapturing()) {
+        iWriterBuffer->WriteFlush();
+        return;
+    }
+    Bwh compressed;
+    Brn encoding;
+    const TBool isCompressed = EndCompressedResponse(compressed, encoding);
+    const Brx& body = (isCompressed? (const Brx&)compressed : iWriterCapture->Captured());
+    if (isCompressed && iResourceETag.Bytes() > 0) {
+        ETagForCoding(iResourceETag, encoding);
+    }
+    WriteResourceHeaders(body.Bytes(), iResourceMimeType, encoding, true);
+    iWriterBuffer->Write(body);
     iWriterBuffer->WriteFlush();
 }
 
+void DviSessionUpnp::WriteResourceValidators(const TChar* aETag, TUint aLastModified)
+{
+    Brn etag(aETag);
+    if (etag.Bytes() > HttpHeaderETag::kMaxETagBytes) {
+        return;
+    }
+    iResourceETag.Replace(etag);
+    iResourceLastModified = aLastModified;
+    iResourceNotModified = iHeaderIfNoneMatch.Matches(iResourceETag);
+    if (!iResourceNotModified && AcceptsCompression()) {
+        // client may hold a compressed copy, which has its own entity tag
+        const Brn codings[] = { Http::kContentCodingGzip, Http::kContentCodingDeflate };
+        for (TUint i=0; i<sizeof(codings)/sizeof(codings[0]) && !iResourceNotModified; i++) {
+            Bws<kMaxCodedETagBytes> coded(etag);
+            ETagForCoding(coded, codings[i]);
+            if (iHeaderIfNoneMatch.Matches(coded)) {
+                iResourceETag.Replace(coded);
+                iResourceNotModified = true;
+            }
+        }
+    }
+}
+
+TBool DviSessionUpnp::WriteResourceFile(const TChar* aPath, const TChar* aMimeType)
+{
+    TUint bytes;
+    try {
+        IFile* file = IFile::Open(aPath, eFileReadOnly);
+        bytes = file->Bytes();
+        delete file;
+    }
+    catch (FileOpenError&) {
+        return false;
+    }
+    WriteResourceBegin(bytes, aMimeType);
+    if (iResourceWriterHeadersOnly || iResourceNotModified || iResourceRangeUnsatisfiable) {
+    }
+    else if (iWriterCapture->IsCapturing() || bytes == 0) {
+        // body has to pass through our buffers (to be compressed or chunked)
+        IFile* file = NULL;
+        try {
+            file = IFile::Open(aPath, eFileReadOnly);
+            Bws<kMaxResponseBytes> buf;
+            for (TUint remaining = bytes; remaining > 0; remaining -= buf.Bytes()) {
+                buf.SetBytes(0);
+                file->Read(buf, (remaining < buf.MaxBytes()? remaining : buf.MaxBytes()));
+                WriteResource(buf.Ptr(), buf.Bytes());
+            }
+        }
+        catch (FileOpenError&) {
+            THROW(WriterError);
+        }
+        catch (FileReadError&) {
+            delete file;
+            THROW(WriterError);
+        }
+        delete file;
+    }
+    else {
+        // flush headers to the socket then have the kernel send the body directly
+        const TUint first = (iResourceRanged? iResourceRangeFirst : 0);
+        const TUint count = (iResourceRanged? iResourceRangeBytes : bytes);
+        iWriterBuffer->WriteFlush();
+        try {
+            SendFile(aPath, first, count);
+        }
+        catch (NetworkError&) {
+            THROW(WriterError);
+        }
+    }
+    WriteResourceEnd();
+    return true;
+}
+
+void DviSessionUpnp::WriteRangeNotSatisfiable(TUint aTotalBytes)
+{
+    iResourceRangeUnsatisfiable = true;
+    iWriterResponse->WriteStatus(HttpStatus::kRequestedRangeNotSatisfiable, Http::eHttp11);
+    IWriterAscii& writer = iWriterResponse->WriteHeaderField(Http::kHeaderContentRange);
+    writer.Write(Http::kAcceptRangesBytes);
+    writer.Write(Brn(" */"));
+    writer.WriteUint(aTotalBytes);
+    writer.WriteFlush();
+    Http::WriteHeaderContentLength(*iWriterResponse, 0);
+    Http::WriteHeaderConnectionClose(*iWriterResponse);
+    iWriterResponse->WriteFlush();
+    iResponseStarted = true;
+}
+
+void DviSessionUpnp::WriteResourceHeaders(TUint aContentLength, const Brx& aMimeType, const Brx& aContentEncoding, TBool aVary)
+{
+    iWriterResponse->WriteStatus((iResourceRanged? HttpStatus::kPartialContent : HttpStatus::kOk), Http::eHttp11);
+    if (iResourceETag.Bytes() > 0) {
+        iWriterResponse->WriteHeader(Http::kHeaderETag, iResourceETag);
+    }
+    if (iResourceLastModified != 0) {
+        Http::WriteHeaderLastModified(*iWriterResponse, iResourceLastModified);
+    }
+    if (aContentLength > 0) {
+        Http::WriteHeaderContentLength(*iWriterResponse, aContentLength);
+        if (aContentEncoding.Bytes() == 0) {
+            iWriterResponse->WriteHeader(Http::kHeaderAcceptRanges, Http::kAcceptRangesBytes);
+        }
+    }
+    else {
+        if (iReaderRequest->Version() == Http::eHttp11) { 
+            iWriterResponse->WriteHeader(Http::kHeaderTransferEncoding, Http::kTransferEncodingChunked);
+        }
+    }
+    if (aMimeType.Bytes() > 0) {
+        IWriterAscii& writer = iWriterResponse->WriteHeaderField(Http::kHeaderContentType);
+        writer.Write(aMimeType);
+        writer.Write(Brn("; charset=\"utf-8\""));
+        writer.WriteFlush();
+    }
+    if (aContentEncoding.Bytes() > 0) {
+        iWriterResponse->WriteHeader(Http::kHeaderContentEncoding, aContentEncoding);
+    }
+    if (iResourceRanged) {
+        Http::WriteHeaderContentRange(*iWriterResponse, iResourceRangeFirst,
+                                      (TUint64)iResourceRangeFirst + iResourceRangeBytes - 1, iResourceTotalBytes);
+    }
+    if (aVary) {
+        iWriterResponse->WriteHeader(Http::kHeaderVary, Http::kHeaderAcceptEncoding);
+    }
+    Http::WriteHeaderConnectionClose(*iWriterResponse);
+    if (aContentLength == 0) {
+        // any chunked body must be framed separately from the headers
+        iWriterResponse->WriteFlush();
+    }
+    else {
+        iWriterResponse->WriteHeadersEnd();
+    }
+}
+
+TBool DviSessionUpnp::AcceptsCompression() const
+{
+    return (Compression::Available() && (iHeaderAcceptEncoding.Gzip() || iHeaderAcceptEncoding.Deflate()));
+}
+
+void DviSessionUpnp::StartCompressedResponse(TUint aExpectedBytes, TUint aMaxBytes)
+{
+    iWriterBuffer->WriteFlush();
+    iWriterCapture->StartCapture(aExpectedBytes, aMaxBytes);
+    iResponseStarted = true;
+}
+
+void DviSessionUpnp::CaptureOverflowed(IWriter& aWriter)
+{
+    // response is too large to be worth compressing.  Stream it uncompressed, starting with what was captured.
+    // We're called from inside iWriterBuffer so write headers through a buffer of our own.
+    Sws<kMaxResponseBytes> buffer(aWriter);
+    WriterHttpResponse response(buffer);
+    WriteInvocationHeaders(response);
+}
+
+TBool DviSessionUpnp::EndCompressedResponse(Bwh& aCompressed, Brn& aContentEncoding)
+{
+    iWriterBuffer->WriteFlush();
+    iWriterCapture->StopCapture();
+    const Brx& body = iWriterCapture->Captured();
+    if (body.Bytes() < kMinCompressBytes) {
+        return false;
+    }
+    const TBool gzip = iHeaderAcceptEncoding.Gzip();
+    try {
+        Compression::Compress(body, aCompressed, gzip? Compression::eGzip : Compression::eDeflate);
+    }
+    catch (CompressionError&) {
+        return false;
+    }
+    if (aCompressed.Bytes() >= body.Bytes()) {
+        return false;
+    }
+    aContentEncoding.Set(gzip? Http::kContentCodingGzip : Http::kContentCodingDeflate);
+    LOG(kDvDevice, "DviSessionUpnp - compressed response from %u to %u bytes\n", body.Bytes(), aCompressed.Bytes());
+    return true;
+}
+
 void DviSessionUpnp::Invoke()
 {
     try {
@@ -1087,7 +1484,16 @@ void DviSessionUpnp::InvocationReadStart()
         Brn envelope = XmlParserBasic::Find("Envelope", iSoapRequest);
         Brn body = XmlParserBasic::Find("Body", envelope);
         Brn args = XmlParserBasic::Find(iHeaderSoapAction.Action(), body);
-        iSoapRequest.Replace(args);
+        // index the arguments in one pass rather than searching the request for each in turn
+        iSoapArgNames.clear();
+        iSoapArgValues.clear();
+        iNextSoapArg = 0;
+        for (Brn remaining(Ascii::Trim(args)); remaining.Bytes() > 0; remaining.Set(Ascii::Trim(remaining))) {
+            Brn name;
+            Brn value = XmlParserBasic::Next(remaining, name, remaining);
+            iSoapArgNames.push_back(name);
+            iSoapArgValues.push_back(value);
+        }
     }
     catch (XmlError&) {
         InvocationReportError(501, Brn("Invalid XML"));
@@ -1097,7 +1503,7 @@ void DviSessionUpnp::InvocationReadStart()
 TBool DviSessionUpnp::InvocationReadBool(const TChar* aName)
 {
     try {
-        Brn value = XmlParserBasic::Find(aName, iSoapRequest);
+        Brn value = SoapArgument(aName);
         try {
             TUint num = Ascii::Uint(value);
             return (num != 0);
@@ -1121,7 +1527,7 @@ TBool DviSessionUpnp::InvocationReadBool(const TChar* aName)
 void DviSessionUpnp::InvocationReadString(const TChar* aName, Brhz& aString)
 {
     try {
-        Brn value = XmlParserBasic::Find(aName, iSoapRequest);
+        Brn value = SoapArgument(aName);
         Bwh writable(value.Bytes()+1);
         if (value.Bytes()) {
             writable.Append(value);
@@ -1138,7 +1544,7 @@ void DviSessionUpnp::InvocationReadString(const TChar* aName, Brhz& aString)
 TInt DviSessionUpnp::InvocationReadInt(const TChar* aName)
 {
     try {
-        Brn value = XmlParserBasic::Find(aName, iSoapRequest);
+        Brn value = SoapArgument(aName);
         TInt num = Ascii::Int(value);
         return num;
     }
@@ -1154,7 +1560,7 @@ TInt DviSessionUpnp::InvocationReadInt(const TChar* aName)
 TUint DviSessionUpnp::InvocationReadUint(const TChar* aName)
 {
     try {
-        Brn value = XmlParserBasic::Find(aName, iSoapRequest);
+        Brn value = SoapArgument(aName);
         TUint num = Ascii::Uint(value);
         return num;
     }
@@ -1170,7 +1576,7 @@ TUint DviSessionUpnp::InvocationReadUint(const TChar* aName)
 void DviSessionUpnp::InvocationReadBinary(const TChar* aName, Brh& aData)
 {
     try {
-        Brn value = XmlParserBasic::Find(aName, iSoapRequest);
+        Brn value = SoapArgument(aName);
         if (value.Bytes()) {
             Bwh writable(value.Bytes()+1);
             writable.Append(value);
@@ -1185,7 +1591,9 @@ void DviSessionUpnp::InvocationReadBinary(const TChar* aName, Brh& aData)
 
 void DviSessionUpnp::InvocationReadEnd()
 {
-    iSoapRequest.Replace(Brx::Empty());
+    iSoapArgNames.clear();
+    iSoapArgValues.clear();
+    iSoapRequest.SetBytes(0);
 }
 
 void DviSessionUpnp::InvocationReportErrorNoThrow(TUint aCode, const Brx& aDescription)
@@ -1230,6 +1638,23 @@ void DviSessionUpnp::InvocationReportErrorNoThrow(TUint aCode, const Brx& aDescr
     iResponseEnded = true;
 }
 
+void DviSessionUpnp::WriteInvocationHeaders(WriterHttpResponse& aWriter)
+{
+    aWriter.WriteStatus(HttpStatus::kOk, Http::eHttp11);
+    aWriter.WriteHeader(kUpnpHeaderExt, Brx::Empty());
+    aWriter.WriteHeader(Http::kHeaderContentType, Brn("text/xml; charset=\"utf-8\""));
+    WriteServerHeader(aWriter);
+    if (iReaderRequest->Version() == Http::eHttp11) { 
+        aWriter.WriteHeader(Http::kHeaderTransferEncoding, Http::kTransferEncodingChunked);
+    }
+    aWriter.WriteHeader(Http::kHeaderConnection, Http::kConnectionClose);
+    aWriter.WriteFlush();
+
+    if (iReaderRequest->Version() == Http::eHttp11) { 
+        iWriterChunked->SetChunked(true);
+    }
+}
+
 void DviSessionUpnp::InvocationReportError(TUint aCode, const Brx& aDescription)
 {
     InvocationReportErrorNoThrow(aCode, aDescription);
@@ -1238,19 +1663,14 @@ void DviSessionUpnp::InvocationReportError(TUint aCode, const Brx& aDescription)
 
 void DviSessionUpnp::InvocationWriteStart()
 {
-    iResponseStarted = true;
-    iWriterResponse->WriteStatus(HttpStatus::kOk, Http::eHttp11);
-    iWriterResponse->WriteHeader(kUpnpHeaderExt, Brx::Empty());
-    iWriterResponse->WriteHeader(Http::kHeaderContentType, Brn("text/xml; charset=\"utf-8\""));
-    WriteServerHeader(*iWriterResponse);
-    if (iReaderRequest->Version() == Http::eHttp11) { 
-        iWriterResponse->WriteHeader(Http::kHeaderTransferEncoding, Http::kTransferEncodingChunked);
+    if (AcceptsCompression()) {
+        // response size isn't known yet; buffer it and write headers from InvocationWriteEnd
+        // (or from CaptureOverflowed if it turns out to be too large to compress)
+        StartCompressedResponse(0, kMaxCompressBytes);
     }
-    iWriterResponse->WriteHeader(Http::kHeaderConnection, Http::kConnectionClose);
-    iWriterResponse->WriteFlush();
-
-    if (iReaderRequest->Version() == Http::eHttp11) { 
-        iWriterChunked->SetChunked(true);
+    else {
+        iResponseStarted = true;
+        WriteInvocationHeaders(*iWriterResponse);
     }
 
     iWriterBuffer->Write(Brn("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<s:Envelope xmlns:s=\"http://schemas.xmlsoap.org/soap/envelope/\" s:encodingStyle=\"http://schemas.xmlsoap.org/soap/encoding/\"><s:Body><u:"));
@@ -1362,7 +1782,27 @@ void DviSessionUpnp::InvocationWriteEnd()
     iWriterBuffer->Write(Brn("</u:"));
     iWriterBuffer->Write(iHeaderSoapAction.Action());
     iWriterBuffer->Write(Brn("Response></s:Body></s:Envelope>"));
-    iWriterBuffer->WriteFlush();
+    if (!iWriterCapture->IsCapturing()) {
+        iWriterBuffer->WriteFlush();
+    }
+    else {
+        Bwh compressed;
+        Brn encoding;
+        const TBool isCompressed = EndCompressedResponse(compressed, encoding);
+        const Brx& body = (isCompressed? (const Brx&)compressed : iWriterCapture->Captured());
+        iWriterResponse->WriteStatus(HttpStatus::kOk, Http::eHttp11);
+        iWriterResponse->WriteHeader(kUpnpHeaderExt, Brx::Empty());
+        iWriterResponse->WriteHeader(Http::kHeaderContentType, Brn("text/xml; charset=\"utf-8\""));
+        WriteServerHeader(*iWriterResponse);
+        Http::WriteHeaderContentLength(*iWriterResponse, body.Bytes());
+        if (isCompressed) {
+            iWriterResponse->WriteHeader(Http::kHeaderContentEncoding, encoding);
+        }
+        iWriterResponse->WriteHeader(Http::kHeaderConnection, Http::kConnectionClose);
+        iWriterResponse->WriteHeadersEnd();
+        iWriterBuffer->Write(body);
+        iWriterBuffer->WriteFlush();
+    }
 
     const Brx& action = iHeaderSoapAction.Action();
     LOG(kDvInvocation, "Completed UPnP action: %.*s\n", PBUF(action));
@@ -1401,10 +1841,14 @@ void DviServerUpnp::Redirect(const Brx& aUriRequested, const Brx& aUriRedirected
 
 SocketTcpServer* DviServerUpnp::CreateServer(const NetworkAdapter& aNif)
 {
-    SocketTcpServer* server = new SocketTcpServer(iDvStack.Env(), "UpnpServer", iPort, aNif.Address());
+    InitialisationParams* initParams = iDvStack.Env().InitParams();
+    SocketTcpServer* server = new SocketTcpServer(iDvStack.Env(), "UpnpServer", iPort, aNif.Address(),
+                                                  kPriorityHigh, Thread::kDefaultStackBytes, 128,
+                                                  initParams->DvNumServerListeners());
     PropertyWriterFactory* pwf = new PropertyWriterFactory(iDvStack, aNif.Address(), server->Port());
     iPropertyWriterFactories.push_back(pwf);
-    const TUint numWsThreads = iDvStack.Env().InitParams()->DvNumServerThreads();
+    // sessions are shared round-robin between listeners, giving each its own group of threads
+    const TUint numWsThreads = initParams->DvNumServerThreads() * server->Listeners();
     for (TUint i=0; i<numWsThreads; i++) {
         Bws<Thread::kMaxNameBytes+1> thName;
         thName.AppendPrintf("UpnpSession %d", i);
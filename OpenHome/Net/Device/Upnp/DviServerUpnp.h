@@ -168,8 +168,43 @@ private:
     Fifo<PropertyWriterUpnp*> iFifo;
 };
 
+class IWriterCaptureOverflow
+{
+public:
+    virtual void CaptureOverflowed(IWriter& aWriter) = 0; // write anything that must precede the captured data
+    virtual ~IWriterCaptureOverflow() {}
+};
+
+/**
+ * Passes data through to another writer or, while capturing, holds it in memory.
+ * Allows a response body to be compressed before its headers are written.
+ *
+ * A capture with a size limit stops once the limit would be passed.  The overflow
+ * handler is told, then the captured data and any later writes pass straight through.
+ */
+class WriterCapture : public IWriter
+{
+public:
+    WriterCapture(IWriter& aWriter, IWriterCaptureOverflow& aOverflow);
+    void StartCapture(TUint aExpectedBytes, TUint aMaxBytes); // aMaxBytes of 0 means no limit
+    void StopCapture();
+    TBool IsCapturing() const;
+    const Brx& Captured() const; // valid until the next call to StartCapture
+    void ReleaseCaptured(TUint aMaxRetainedBytes); // frees the capture buffer if it's grown beyond aMaxRetainedBytes
+public: // from IWriter
+    void Write(TByte aValue);
+    void Write(const Brx& aBuffer);
+    void WriteFlush();
+    void WriteVector(const Brx* const aBuffers[], TUint aCount);
+private:
+    IWriter& iWriter;
+    IWriterCaptureOverflow& iOverflow;
+    Bwh iCaptured;
+    TUint iMaxBytes;
+    TBool iCapturing;
+};
 
-class DviSessionUpnp : public SocketTcpSession, private IResourceWriter, private IDviInvocation
+class DviSessionUpnp : public SocketTcpSession, private IResourceWriter, private IDviInvocation, private IWriterCaptureOverflow
 {
 public:
     DviSessionUpnp(DvStack& aDvStack, TIpAddress aInterface, TUint aPort,
@@ -187,10 +222,22 @@ private:
     void ParseRequestUri(const Brx& aUrlTail, DviDevice** aDevice, DviService** aService);
     void WriteServerHeader(IWriterHttpHeader& aWriter);
     void InvocationReportErrorNoThrow(TUint aCode, const Brx& aDescription);
+    void WriteResourceHeaders(TUint aContentLength, const Brx& aMimeType, const Brx& aContentEncoding, TBool aVary);
+    void WriteRangeNotSatisfiable(TUint aTotalBytes);
+    TBool AcceptsCompression() const;
+    void StartCompressedResponse(TUint aExpectedBytes, TUint aMaxBytes);
+    void WriteInvocationHeaders(WriterHttpResponse& aWriter);
+    TBool EndCompressedResponse(Bwh& aCompressed, Brn& aContentEncoding);
+    void ReserveSoapRequest(TUint aBytes);
+    Brn SoapArgument(const TChar* aName); // throws XmlError if aName wasn't sent
 private: // IResourceWriter
     void WriteResourceBegin(TUint aTotalBytes, const TChar* aMimeType);
     void WriteResource(const TByte* aData, TUint aBytes);
     void WriteResourceEnd();
+    void WriteResourceValidators(const TChar* aETag, TUint aLastModified);
+    TBool WriteResourceFile(const TChar* aPath, const TChar* aMimeType);
+private: // IWriterCaptureOverflow
+    void CaptureOverflowed(IWriter& aWriter);
 private: // IDviInvocation
     void Invoke();
     TUint Version() const;
@@ -221,9 +268,16 @@ private: // IDviInvocation
     void InvocationWriteEnd();
 private:
     static const TUint kMaxRequestBytes = 64*1024;
+    static const TUint kMinRequestBytes = 1024;
+    static const TUint kMaxRetainedRequestBytes = 8*1024;
     static const TUint kMaxResponseBytes = 4*1024;
     static const TUint kReadTimeoutMs = 5 * 1000;
     static const TUint kMaxRequestPathBytes = 256;
+    static const TUint kMinCompressBytes = 1024;
+    static const TUint kMaxCompressBytes = 1024 * 1024;
+    static const TUint kMaxRetainedCaptureBytes = 16 * 1024;
+    static const TUint kMaxMimeTypeBytes = 100;
+    static const TUint kMaxCodedETagBytes = HttpHeaderETag::kMaxETagBytes + 16;
 private:
     DvStack& iDvStack;
     TIpAddress iInterface;
@@ -236,6 +290,7 @@ private:
     ReaderHttpRequest* iReaderRequest;
     ReaderHttpChunked* iDechunker;
     WriterHttpChunked* iWriterChunked;
+    WriterCapture* iWriterCapture;
     Sws<kMaxResponseBytes>* iWriterBuffer;
     WriterHttpResponse* iWriterResponse;
     HttpHeaderHost iHeaderHost;
@@ -250,15 +305,32 @@ private:
     HeaderCallback iHeaderCallback;
     HeaderAcceptLanguage iHeaderAcceptLanguage;
     HttpHeaderUserAgent iHeaderUserAgent;
+    HttpHeaderIfNoneMatch iHeaderIfNoneMatch;
+    HttpHeaderAcceptEncoding iHeaderAcceptEncoding;
+    HttpHeaderRange iHeaderRange;
+    HttpHeaderIfRange iHeaderIfRange;
     const HttpStatus* iErrorStatus;
     TBool iResponseStarted;
     TBool iResponseEnded;
-    Bws<kMaxRequestBytes> iSoapRequest;
+    Bwh iSoapRequest;
+    std::vector<Brn> iSoapArgNames;
+    std::vector<Brn> iSoapArgValues;
+    TUint iNextSoapArg;
     Bws<kMaxRequestPathBytes> iMappedRequestUri;
     DviDevice* iInvocationDevice;
     DviService* iInvocationService;
     mutable Bws<128> iResourceUriPrefix;
     TBool iResourceWriterHeadersOnly;
+    Bws<kMaxCodedETagBytes> iResourceETag;
+    TUint iResourceLastModified;
+    TBool iResourceNotModified;
+    Bws<kMaxMimeTypeBytes> iResourceMimeType;
+    TBool iResourceRanged;
+    TBool iResourceRangeUnsatisfiable;
+    TUint iResourceRangeFirst;
+    TUint iResourceRangeBytes;
+    TUint iResourceTotalBytes;
+    TUint64 iResourceOffset; // bytes passed to WriteResource so far
     Semaphore iShutdownSem;
 };
 
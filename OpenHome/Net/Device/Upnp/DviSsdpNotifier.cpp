@@ -17,6 +17,59 @@ using namespace OpenHome::Net;
 
 #undef NOTIFIER_LOG_VERBOSE
 
+// SsdpPacketBudget
+
+SsdpPacketBudget::SsdpPacketBudget(TUint aPacketsPerSec)
+    : iLock("SSPB")
+    , iPacketsPerSec(aPacketsPerSec)
+    , iMilliTokens(kBurstPackets * kMilliTokensPerPacket)
+    , iLastRefillMs(0)
+{
+}
+
+TBool SsdpPacketBudget::TryTake(TUint aNowMs)
+{
+    if (iPacketsPerSec == 0) {
+        return true;
+    }
+    AutoMutex a(iLock);
+    Refill(aNowMs);
+    if (iMilliTokens < kMilliTokensPerPacket) {
+        return false;
+    }
+    iMilliTokens -= kMilliTokensPerPacket;
+    return true;
+}
+
+TUint SsdpPacketBudget::MsUntilAvailable(TUint aNowMs)
+{
+    if (iPacketsPerSec == 0) {
+        return 0;
+    }
+    AutoMutex a(iLock);
+    Refill(aNowMs);
+    if (iMilliTokens >= kMilliTokensPerPacket) {
+        return 0;
+    }
+    return (kMilliTokensPerPacket - iMilliTokens + iPacketsPerSec - 1) / iPacketsPerSec;
+}
+
+void SsdpPacketBudget::Refill(TUint aNowMs)
+{
+    static const TUint kMaxMilliTokens = kBurstPackets * kMilliTokensPerPacket;
+    TUint elapsedMs = aNowMs - iLastRefillMs;
+    iLastRefillMs = aNowMs;
+    // one packet per second accrues 1 milli-token per ms; cap elapsed time before multiplying
+    if (elapsedMs > kMaxMilliTokens) {
+        elapsedMs = kMaxMilliTokens;
+    }
+    iMilliTokens += elapsedMs * iPacketsPerSec;
+    if (iMilliTokens > kMaxMilliTokens) {
+        iMilliTokens = kMaxMilliTokens;
+    }
+}
+
+
 // SsdpNotifierScheduler
 
 SsdpNotifierScheduler::~SsdpNotifierScheduler()
@@ -24,10 +77,11 @@ SsdpNotifierScheduler::~SsdpNotifierScheduler()
     delete iTimer;
 }
 
-SsdpNotifierScheduler::SsdpNotifierScheduler(DvStack& aDvStack, ISsdpNotifyListener& aListener, const TChar* aId)
+SsdpNotifierScheduler::SsdpNotifierScheduler(DvStack& aDvStack, ISsdpNotifyListener& aListener, const TChar* aId, SsdpPacketBudget* aBudget)
     : iType(NULL)
     , iId(aId)
     , iDvStack(aDvStack)
+    , iBudget(aBudget)
     , iListener(aListener)
 {
     Functor functor = MakeFunctor(*this, &SsdpNotifierScheduler::SendNextMsg);
@@ -43,6 +97,7 @@ void SsdpNotifierScheduler::Start(TUint aDuration, TUint aMsgCount)
 {
     iStop = false;
     iEndTimeMs = Os::TimeInMs(iDvStack.Env().OsCtx()) + aDuration;
+    iUnsentMsgs = aMsgCount;
     ScheduleNextTimer(aMsgCount);
 }
 
@@ -58,10 +113,30 @@ void SsdpNotifierScheduler::NotifyComplete(TBool aCancelled)
 
 void SsdpNotifierScheduler::SendNextMsg()
 {
-    TUint remaining = 0;
     TBool stop = true;
+    TUint throttledMs = 0;
     try {
-        stop = (iStop || ((remaining = NextMsg()) == 0));
+        if (!iStop) {
+            // queue every message that's already due (that we'd otherwise reschedule
+            // the timer to send immediately) then send them all together
+            TUint queued = 0;
+            while (iUnsentMsgs > 0 && queued < kMaxMsgsPerBatch && !iStop &&
+                   (queued == 0 || MaxIntervalMs(iUnsentMsgs) < kMinTimerIntervalMs)) {
+                if (iBudget != NULL) {
+                    const TUint now = Os::TimeInMs(iDvStack.Env().OsCtx());
+                    if (!iBudget->TryTake(now)) {
+                        throttledMs = iBudget->MsUntilAvailable(now);
+                        break;
+                    }
+                }
+                iUnsentMsgs = NextMsg();
+                queued++;
+            }
+            if (queued > 0) {
+                SendQueuedMsgs();
+            }
+            stop = (iStop || iUnsentMsgs == 0);
+        }
     }
     catch (WriterError&) {
         stop = true;
@@ -72,23 +147,25 @@ void SsdpNotifierScheduler::SendNextMsg()
         LOG2(kError, kDvDevice, "NetworkError from SsdpNotifierScheduler::SendNextMsg() id=%s\n", iId);
     }
 #ifdef NOTIFIER_LOG_VERBOSE
-    LOG(kDvSsdpNotifier, "Ssdp notification sent - %s (%p) %s  %.*s remaining=%u  stop=%d\n", iType, this, iId, PBUF(iUdn), remaining, stop);
+    LOG(kDvSsdpNotifier, "Ssdp notification sent - %s (%p) %s  %.*s remaining=%u  stop=%d\n", iType, this, iId, PBUF(iUdn), iUnsentMsgs, stop);
 #endif
     if (stop) {
         NotifyComplete(iStop);
         iListener.NotifySchedulerComplete(this);
         return;
     }
+    else if (throttledMs > 0) {
+        // over the stack's packet budget; wait for it to refill rather than catch up at once
+        iTimer->FireIn(throttledMs);
+    }
     else {
-        ScheduleNextTimer(remaining);
+        ScheduleNextTimer(iUnsentMsgs);
     }
 }
 
-void SsdpNotifierScheduler::ScheduleNextTimer(TUint aRemainingMsgs) const
+TInt SsdpNotifierScheduler::MaxIntervalMs(TUint aRemainingMsgs) const
 {
-    TUint interval;
-    Environment& env = iDvStack.Env();
-    const TUint timeNow = Os::TimeInMs(env.OsCtx());
+    const TUint timeNow = Os::TimeInMs(iDvStack.Env().OsCtx());
     TInt remaining;
     if (timeNow > iEndTimeMs && timeNow-iEndTimeMs > UINT_MAX/2) {
         // clock may wrap during this series of announcements but it hasn't wrapped yet
@@ -99,7 +176,14 @@ void SsdpNotifierScheduler::ScheduleNextTimer(TUint aRemainingMsgs) const
     }
     TInt maxUpdateTimeMs = (TInt)iDvStack.Env().InitParams()->DvMaxUpdateTimeSecs() * 1000;
     ASSERT(remaining <= maxUpdateTimeMs);
-    TInt maxInterval = remaining / (TInt)aRemainingMsgs;
+    return remaining / (TInt)aRemainingMsgs;
+}
+
+void SsdpNotifierScheduler::ScheduleNextTimer(TUint aRemainingMsgs) const
+{
+    TUint interval;
+    Environment& env = iDvStack.Env();
+    const TInt maxInterval = MaxIntervalMs(aRemainingMsgs);
     if (maxInterval < kMinTimerIntervalMs) {
         // we're running behind.  Schedule another timer to run immediately
         interval = 0;
@@ -118,54 +202,49 @@ void SsdpNotifierScheduler::LogNotifierStart(const TChar* aType)
 
 // MsearchResponse
 
-#define NEXT_MSG_ROOT         (0)
-#define NEXT_MSG_UUID         (1)
-#define NEXT_MSG_DEVICE_TYPE  (2)
-#define NEXT_MSG_SERVICE_TYPE (3)
-
 MsearchResponse::MsearchResponse(DvStack& aDvStack, ISsdpNotifyListener& aListener)
     : SsdpNotifierScheduler(aDvStack, aListener, "MSearchResponse")
-    , iAnnouncementData(NULL)
+    , iResponder(aDvStack)
+    , iResponses(NULL)
 {
-    iNotifier = new SsdpMsearchResponder(aDvStack);
 }
 
 MsearchResponse::~MsearchResponse()
 {
-    delete iNotifier;
+    ReleaseResponses();
 }
 
-void MsearchResponse::StartAll(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void MsearchResponse::StartAll(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter)
 {
     LogNotifierStart("StartAll");
-    TUint nextMsgIndex = NEXT_MSG_ROOT;
+    TUint nextMsgIndex = DviProtocolUpnpMsearchResponses::kIndexRoot;
     TUint msgCount = 3 + aAnnouncementData.ServiceCount();
     if (!aAnnouncementData.IsRoot()) {
         msgCount--;
-        nextMsgIndex = NEXT_MSG_UUID;
+        nextMsgIndex = DviProtocolUpnpMsearchResponses::kIndexUuid;
     }
-    Start(aAnnouncementData, msgCount, nextMsgIndex, aRemote, aMx, aUri, aConfigId, aAdapter);
+    Start(aResponses, msgCount, nextMsgIndex, aRemote, aMx, aAdapter);
 }
 
-void MsearchResponse::StartRoot(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void MsearchResponse::StartRoot(DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter)
 {
     LogNotifierStart("StartRoot");
-    Start(aAnnouncementData, 1, NEXT_MSG_ROOT, aRemote, aMx, aUri, aConfigId, aAdapter);
+    Start(aResponses, 1, DviProtocolUpnpMsearchResponses::kIndexRoot, aRemote, aMx, aAdapter);
 }
 
-void MsearchResponse::StartUuid(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void MsearchResponse::StartUuid(DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter)
 {
     LogNotifierStart("StartUuid");
-    Start(aAnnouncementData, 1, NEXT_MSG_UUID, aRemote, aMx, aUri, aConfigId, aAdapter);
+    Start(aResponses, 1, DviProtocolUpnpMsearchResponses::kIndexUuid, aRemote, aMx, aAdapter);
 }
 
-void MsearchResponse::StartDeviceType(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void MsearchResponse::StartDeviceType(DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter)
 {
     LogNotifierStart("StartDeviceType");
-    Start(aAnnouncementData, 1, NEXT_MSG_DEVICE_TYPE, aRemote, aMx, aUri, aConfigId, aAdapter);
+    Start(aResponses, 1, DviProtocolUpnpMsearchResponses::kIndexDeviceType, aRemote, aMx, aAdapter);
 }
 
-void MsearchResponse::StartServiceType(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const OpenHome::Net::ServiceType& aServiceType, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void MsearchResponse::StartServiceType(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, const OpenHome::Net::ServiceType& aServiceType, TIpAddress aAdapter)
 {
     LogNotifierStart("StartServiceType");
     TUint index = 0;
@@ -176,7 +255,7 @@ void MsearchResponse::StartServiceType(IUpnpAnnouncementData& aAnnouncementData,
         }
         index++;
     }
-    Start(aAnnouncementData, 1, NEXT_MSG_SERVICE_TYPE + index, aRemote, aMx, aUri, aConfigId, aAdapter);
+    Start(aResponses, 1, DviProtocolUpnpMsearchResponses::kIndexServiceType + index, aRemote, aMx, aAdapter);
 }
 
 Endpoint MsearchResponse::Remote() const
@@ -184,45 +263,49 @@ Endpoint MsearchResponse::Remote() const
     return iRemote;
 }
 
-void MsearchResponse::Start(IUpnpAnnouncementData& aAnnouncementData, TUint aTotalMsgs, TUint aNextMsgIndex, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void MsearchResponse::Start(DviProtocolUpnpMsearchResponses& aResponses, TUint aTotalMsgs, TUint aNextMsgIndex, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter)
 {
-    iAnnouncementData = &aAnnouncementData;
+    ReleaseResponses();
+    aResponses.AddRef();
+    iResponses = &aResponses;
     iNextMsgIndex = aNextMsgIndex;
     iRemainingMsgs = aTotalMsgs;
-    static_cast<SsdpMsearchResponder*>(iNotifier)->SetRemote(aRemote, aConfigId, aAdapter);
+    iResponder.SetRemote(aRemote, aAdapter);
     iRemote = aRemote;
-    iUri.Replace(aUri);
     SsdpNotifierScheduler::Start(aMx * 1000, iRemainingMsgs);
 }
 
-TUint MsearchResponse::NextMsg()
+void MsearchResponse::ReleaseResponses()
 {
-    switch (iNextMsgIndex)
-    {
-    case 0:
-        iNotifier->SsdpNotifyRoot(iAnnouncementData->Udn(), iUri);
-        break;
-    case 1:
-        iNotifier->SsdpNotifyUuid(iAnnouncementData->Udn(), iUri);
-        break;
-    case 2:
-        iNotifier->SsdpNotifyDeviceType(iAnnouncementData->Domain(), iAnnouncementData->Type(), iAnnouncementData->Version(), iAnnouncementData->Udn(), iUri);
-        break;
-    default:
-        DviService& service = iAnnouncementData->Service(iNextMsgIndex - 3);
-        const OpenHome::Net::ServiceType& serviceType = service.ServiceType();
-        iNotifier->SsdpNotifyServiceType(serviceType.Domain(), serviceType.Name(), serviceType.Version(), iAnnouncementData->Udn(), iUri);
-        break;
+    if (iResponses != NULL) {
+        iResponses->RemoveRef();
+        iResponses = NULL;
     }
+}
+
+TUint MsearchResponse::NextMsg()
+{
+    iResponder.Queue(iResponses->Response(iNextMsgIndex));
     iNextMsgIndex++;
     return --iRemainingMsgs;
 }
 
+void MsearchResponse::SendQueuedMsgs()
+{
+    iResponder.SendQueued();
+}
+
+void MsearchResponse::NotifyComplete(TBool aCancelled)
+{
+    SsdpNotifierScheduler::NotifyComplete(aCancelled);
+    ReleaseResponses();
+}
+
 
 // DeviceAnnouncement
 
-DeviceAnnouncement::DeviceAnnouncement(DvStack& aDvStack, ISsdpNotifyListener& aListener)
-    : SsdpNotifierScheduler(aDvStack, aListener, "DevAnounce")
+DeviceAnnouncement::DeviceAnnouncement(DvStack& aDvStack, ISsdpNotifyListener& aListener, SsdpPacketBudget& aBudget)
+    : SsdpNotifierScheduler(aDvStack, aListener, "DevAnounce", &aBudget)
     , iSsdpNotifier(aDvStack)
     , iNotifierAlive(iSsdpNotifier)
     , iNotifierByeBye(iSsdpNotifier)
@@ -286,6 +369,11 @@ TUint DeviceAnnouncement::NextMsg()
     return (iTotalMsgs - iNextMsgIndex);
 }
 
+void DeviceAnnouncement::SendQueuedMsgs()
+{
+    iSsdpNotifier.SendQueued();
+}
+
 void DeviceAnnouncement::NotifyComplete(TBool aCancelled)
 {
     SsdpNotifierScheduler::NotifyComplete(aCancelled);
@@ -303,6 +391,7 @@ DviSsdpNotifierManager::DviSsdpNotifierManager(DvStack& aDvStack)
     : iDvStack(aDvStack)
     , iLock("DVDM")
     , iShutdownSem("DVDM", 1)
+    , iAnnouncementBudget(aDvStack.Env().InitParams()->DvSsdpPacketsPerSec())
 {
 }
 
@@ -365,52 +454,52 @@ void DviSsdpNotifierManager::AnnouncementUpdate(IUpnpAnnouncementData& aAnnounce
     }
 }
 
-void DviSsdpNotifierManager::MsearchResponseAll(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void DviSsdpNotifierManager::MsearchResponseAll(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter)
 {
     try {
         AutoMutex a(iLock);
         Responder* responder = GetResponder(aAnnouncementData, aRemote);
-        responder->Response().StartAll(aAnnouncementData, aRemote, aMx, aUri, aConfigId, aAdapter);
+        responder->Response().StartAll(aAnnouncementData, aResponses, aRemote, aMx, aAdapter);
     }
     catch (MsearchResponseLimit&) {}
 }
 
-void DviSsdpNotifierManager::MsearchResponseRoot(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void DviSsdpNotifierManager::MsearchResponseRoot(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter)
 {
     try {
         AutoMutex a(iLock);
         Responder* responder = GetResponder(aAnnouncementData, aRemote);
-        responder->Response().StartRoot(aAnnouncementData, aRemote, aMx, aUri, aConfigId, aAdapter);
+        responder->Response().StartRoot(aResponses, aRemote, aMx, aAdapter);
     }
     catch (MsearchResponseLimit&) {}
 }
 
-void DviSsdpNotifierManager::MsearchResponseUuid(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void DviSsdpNotifierManager::MsearchResponseUuid(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter)
 {
     try {
         AutoMutex a(iLock);
         Responder* responder = GetResponder(aAnnouncementData, aRemote);
-        responder->Response().StartUuid(aAnnouncementData, aRemote, aMx, aUri, aConfigId, aAdapter);
+        responder->Response().StartUuid(aResponses, aRemote, aMx, aAdapter);
     }
     catch (MsearchResponseLimit&) {}
 }
 
-void DviSsdpNotifierManager::MsearchResponseDeviceType(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void DviSsdpNotifierManager::MsearchResponseDeviceType(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter)
 {
     try {
         AutoMutex a(iLock);
         Responder* responder = GetResponder(aAnnouncementData, aRemote);
-        responder->Response().StartDeviceType(aAnnouncementData, aRemote, aMx, aUri, aConfigId, aAdapter);
+        responder->Response().StartDeviceType(aResponses, aRemote, aMx, aAdapter);
     }
     catch (MsearchResponseLimit&) {}
 }
 
-void DviSsdpNotifierManager::MsearchResponseServiceType(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const OpenHome::Net::ServiceType& aServiceType, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter)
+void DviSsdpNotifierManager::MsearchResponseServiceType(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, const OpenHome::Net::ServiceType& aServiceType, TIpAddress aAdapter)
 {
     try {
         AutoMutex a(iLock);
         Responder* responder = GetResponder(aAnnouncementData, aRemote);
-        responder->Response().StartServiceType(aAnnouncementData, aRemote, aMx, aServiceType, aUri, aConfigId, aAdapter);
+        responder->Response().StartServiceType(aAnnouncementData, aResponses, aRemote, aMx, aServiceType, aAdapter);
     }
     catch (MsearchResponseLimit&) {}
 }
@@ -479,7 +568,7 @@ DviSsdpNotifierManager::Announcer* DviSsdpNotifierManager::GetAnnouncer(IUpnpAnn
     DviSsdpNotifierManager::Announcer* announcer;
     if (iFreeAnnouncers.size() == 0) {
         try {
-            DeviceAnnouncement* da = new DeviceAnnouncement(iDvStack, *this);
+            DeviceAnnouncement* da = new DeviceAnnouncement(iDvStack, *this, iAnnouncementBudget);
             announcer = new Announcer(da);
             iActiveAnnouncers.push_back(announcer);
         }
@@ -23,20 +23,43 @@ public:
     virtual void NotifySchedulerComplete(SsdpNotifierScheduler* aScheduler) = 0;
 };
 
+// SsdpPacketBudget - token bucket shared by all announcements from a stack so that hosting
+//                    many devices doesn't produce multicast bursts
+class SsdpPacketBudget : private INonCopyable
+{
+    static const TUint kMilliTokensPerPacket = 1000;
+public:
+    static const TUint kBurstPackets = UdpBatchWriter::kMaxDatagrams;
+public:
+    SsdpPacketBudget(TUint aPacketsPerSec); // 0 => unlimited
+    TBool TryTake(TUint aNowMs);
+    TUint MsUntilAvailable(TUint aNowMs);
+private:
+    void Refill(TUint aNowMs);
+private:
+    Mutex iLock;
+    TUint iPacketsPerSec;
+    TUint iMilliTokens;
+    TUint iLastRefillMs;
+};
+
 class SsdpNotifierScheduler : private INonCopyable
 {
     static const TInt kMinTimerIntervalMs   = 10;
+    static const TUint kMaxMsgsPerBatch     = UdpBatchWriter::kMaxDatagrams;
 public:
     virtual ~SsdpNotifierScheduler();
     void Stop();
     void SetUdn(const Brx& aUdn);
 protected:
-    SsdpNotifierScheduler(DvStack& aDvStack, ISsdpNotifyListener& aListener, const TChar* aId);
+    SsdpNotifierScheduler(DvStack& aDvStack, ISsdpNotifyListener& aListener, const TChar* aId, SsdpPacketBudget* aBudget = NULL);
     void Start(TUint aDuration, TUint aMsgCount);
     virtual void NotifyComplete(TBool aCancelled);
 private:
-    virtual TUint NextMsg() = 0;
+    virtual TUint NextMsg() = 0;   // queues the next message, returning the number still to be queued
+    virtual void SendQueuedMsgs() = 0;
     void SendNextMsg();
+    TInt MaxIntervalMs(TUint aRemainingMsgs) const;
     void ScheduleNextTimer(TUint aRemainingMsgs) const;
 protected:
     void LogNotifierStart(const TChar* aType);
@@ -45,7 +68,9 @@ protected:
 private:
     Timer* iTimer;
     DvStack& iDvStack;
+    SsdpPacketBudget* iBudget;
     TUint iEndTimeMs;
+    TUint iUnsentMsgs;
     ISsdpNotifyListener& iListener;
     TBool iStop;
     Brn iUdn;
@@ -57,22 +82,23 @@ class MsearchResponse : public SsdpNotifierScheduler
 public:
     MsearchResponse(DvStack& aDvStack, ISsdpNotifyListener& aListener);
     ~MsearchResponse();
-    void StartAll(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
-    void StartRoot(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
-    void StartUuid(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
-    void StartDeviceType(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
-    void StartServiceType(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const OpenHome::Net::ServiceType& aServiceType, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
+    void StartAll(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter);
+    void StartRoot(DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter);
+    void StartUuid(DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter);
+    void StartDeviceType(DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter);
+    void StartServiceType(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, const OpenHome::Net::ServiceType& aServiceType, TIpAddress aAdapter);
     Endpoint Remote() const;
 private:
-    void Start(IUpnpAnnouncementData& aAnnouncementData, TUint aTotalMsgs, TUint aNextMsgIndex, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
+    void Start(DviProtocolUpnpMsearchResponses& aResponses, TUint aTotalMsgs, TUint aNextMsgIndex, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter);
+    void ReleaseResponses();
 private: // from DviMsg
     TUint NextMsg();
+    void SendQueuedMsgs();
+    void NotifyComplete(TBool aCancelled);
 private:
-    static const TUint kMaxUriBytes = 256;
-    IUpnpAnnouncementData* iAnnouncementData;
-    ISsdpNotify* iNotifier;
+    SsdpMsearchResponder iResponder;
+    DviProtocolUpnpMsearchResponses* iResponses;
     Endpoint iRemote;
-    Bws<kMaxUriBytes> iUri;
     TUint iRemainingMsgs;
     TUint iNextMsgIndex;
 };
@@ -83,7 +109,7 @@ class DeviceAnnouncement : public SsdpNotifierScheduler
     static const TUint kMsgIntervalMsByeBye = 10;
     static const TUint kMsgIntervalMsUpdate = 20;
 public:
-    DeviceAnnouncement(DvStack& aDvStack, ISsdpNotifyListener& aListener);
+    DeviceAnnouncement(DvStack& aDvStack, ISsdpNotifyListener& aListener, SsdpPacketBudget& aBudget);
     void StartAlive(IUpnpAnnouncementData& aAnnouncementData, TIpAddress aAdapter, const Brx& aUri, TUint aConfigId);
     void StartByeBye(IUpnpAnnouncementData& aAnnouncementData, TIpAddress aAdapter, const Brx& aUri, TUint aConfigId, FunctorGeneric<TBool>& aCompleted);
     void StartUpdate(IUpnpAnnouncementData& aAnnouncementData, TIpAddress aAdapter, const Brx& aUri, TUint aConfigId, FunctorGeneric<TBool>& aCompleted);
@@ -91,6 +117,7 @@ private:
     void Start(ISsdpNotify& aNotifier, IUpnpAnnouncementData& aAnnouncementData, TIpAddress aAdapter, const Brx& aUri, TUint aConfigId, TUint aMsgInterval);
 private: // from DviMsg
     TUint NextMsg();
+    void SendQueuedMsgs();
     void NotifyComplete(TBool aCancelled);
 private:
     static const TUint kMaxUriBytes = 256;
@@ -115,11 +142,11 @@ public:
     void AnnouncementAlive(IUpnpAnnouncementData& aAnnouncementData, TIpAddress aAdapter, const Brx& aUri, TUint aConfigId);
     void AnnouncementByeBye(IUpnpAnnouncementData& aAnnouncementData, TIpAddress aAdapter, const Brx& aUri, TUint aConfigId, FunctorGeneric<TBool>& aCompleted);
     void AnnouncementUpdate(IUpnpAnnouncementData& aAnnouncementData, TIpAddress aAdapter, const Brx& aUri, TUint aConfigId, FunctorGeneric<TBool>& aCompleted);
-    void MsearchResponseAll(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
-    void MsearchResponseRoot(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
-    void MsearchResponseUuid(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
-    void MsearchResponseDeviceType(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
-    void MsearchResponseServiceType(IUpnpAnnouncementData& aAnnouncementData, const Endpoint& aRemote, TUint aMx, const OpenHome::Net::ServiceType& aServiceType, const Brx& aUri, TUint aConfigId, TIpAddress aAdapter);
+    void MsearchResponseAll(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter);
+    void MsearchResponseRoot(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter);
+    void MsearchResponseUuid(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter);
+    void MsearchResponseDeviceType(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, TIpAddress aAdapter);
+    void MsearchResponseServiceType(IUpnpAnnouncementData& aAnnouncementData, DviProtocolUpnpMsearchResponses& aResponses, const Endpoint& aRemote, TUint aMx, const OpenHome::Net::ServiceType& aServiceType, TIpAddress aAdapter);
     void Stop(const Brx& aUdn);
 private:
     class Notifier
@@ -161,6 +188,7 @@ private:
     DvStack& iDvStack;
     Mutex iLock;
     Semaphore iShutdownSem;
+    SsdpPacketBudget iAnnouncementBudget;
     std::list<Notifier*> iFreeResponders;
     std::list<Notifier*> iActiveResponders;
     std::list<Notifier*> iFreeAnnouncers;
@@ -3,17 +3,155 @@
 #include <OpenHome/Private/Debug.h>
 #include <OpenHome/Private/Env.h>
 #include <OpenHome/Net/Core/OhNet.h>
+#include <OpenHome/OsWrapper.h>
+#include <OpenHome/Private/Converter.h>
+
+#include <algorithm>
 
 using namespace OpenHome;
 using namespace OpenHome::Net;
 
+// SsdpNotifyFilter
+
+SsdpNotifyFilter::SsdpNotifyFilter()
+    : iTarget(eSsdpAll)
+    , iKey(0)
+{
+}
+
+SsdpNotifyFilter::SsdpNotifyFilter(ESsdpTarget aTarget, const Brx& aUuidOrDomain, const Brx& aType)
+    : iTarget(aTarget)
+    , iKey(Key(aTarget, aUuidOrDomain, aType))
+{
+}
+
+SsdpNotifyFilter SsdpNotifyFilter::Root()
+{
+    return SsdpNotifyFilter(eSsdpRoot, Brx::Empty(), Brx::Empty());
+}
+
+SsdpNotifyFilter SsdpNotifyFilter::Uuid(const Brx& aUuid)
+{
+    return SsdpNotifyFilter(eSsdpUuid, aUuid, Brx::Empty());
+}
+
+SsdpNotifyFilter SsdpNotifyFilter::DeviceType(const Brx& aDomain, const Brx& aType)
+{
+    return SsdpNotifyFilter(eSsdpDeviceType, aDomain, aType);
+}
+
+SsdpNotifyFilter SsdpNotifyFilter::ServiceType(const Brx& aDomain, const Brx& aType)
+{
+    return SsdpNotifyFilter(eSsdpServiceType, aDomain, aType);
+}
+
+TBool SsdpNotifyFilter::All() const
+{
+    return (iTarget == eSsdpAll);
+}
+
+TUint32 SsdpNotifyFilter::Key() const
+{
+    return iKey;
+}
+
+TUint32 SsdpNotifyFilter::Key(ESsdpTarget aTarget, const Brx& aUuidOrDomain, const Brx& aType)
+{
+    TUint32 hash = Converter::kFnv1aOffsetBasis ^ (TUint32)aTarget;
+    hash = Converter::Fnv1a(aUuidOrDomain, hash);
+    hash = Converter::Fnv1a(Brn(":"), hash);
+    return Converter::Fnv1a(aType, hash);
+}
+
+// SsdpAliveFilter
+
+SsdpAliveFilter::SsdpAliveFilter(TUint aWindowMs)
+    : iWindowMs(aWindowMs)
+    , iPassed(0)
+    , iSuppressed(0)
+{
+}
+
+TBool SsdpAliveFilter::Alive(TUint aNowMs, const Endpoint& aSender, TUint32 aNtKey, const Brx& aUuid, const Brx& aLocation, TUint aMaxAge)
+{
+    if (iWindowMs == 0) {
+        iPassed++;
+        return true;
+    }
+    const TUint32 uuidHash = Converter::Fnv1a(aUuid);
+    const TIpAddress address = aSender.Address();
+    TUint32 key = Converter::Fnv1a(aUuid, aNtKey);
+    key = Converter::Fnv1a(Brn((const TByte*)&address, sizeof(address)), key);
+    const TUint32 locationHash = Converter::Fnv1a(aLocation);
+    // never hold back a refresh for so long that a device with a short max-age could expire
+    TUint window = iWindowMs;
+    if (aMaxAge < window / 250) {
+        window = aMaxAge * 250;
+    }
+
+    Entry* entry = NULL;
+    Entry* victim = NULL;
+    for (TUint i=0; i<kProbes; i++) {
+        Entry& e = iEntries[(key + i) % kSlots];
+        if (!e.iUsed) {
+            if (victim == NULL || victim->iUsed) {
+                victim = &e;
+            }
+        }
+        else if (e.iKey == key && e.iUuidHash == uuidHash) {
+            entry = &e;
+            break;
+        }
+        else if (victim == NULL || (victim->iUsed && aNowMs - e.iTimeMs > aNowMs - victim->iTimeMs)) {
+            victim = &e;
+        }
+    }
+    if (entry != NULL) {
+        if (entry->iLocationHash == locationHash && entry->iMaxAge == aMaxAge && aNowMs - entry->iTimeMs < window) {
+            iSuppressed++;
+            return false;
+        }
+    }
+    else {
+        entry = victim;
+        entry->iUsed = true;
+        entry->iKey = key;
+        entry->iUuidHash = uuidHash;
+    }
+    entry->iLocationHash = locationHash;
+    entry->iMaxAge = aMaxAge;
+    entry->iTimeMs = aNowMs;
+    iPassed++;
+    return true;
+}
+
+void SsdpAliveFilter::ByeBye(const Brx& aUuid)
+{
+    const TUint32 uuidHash = Converter::Fnv1a(aUuid);
+    for (TUint i=0; i<kSlots; i++) {
+        if (iEntries[i].iUsed && iEntries[i].iUuidHash == uuidHash) {
+            iEntries[i].iUsed = false;
+        }
+    }
+}
+
+TUint SsdpAliveFilter::Passed() const
+{
+    return iPassed;
+}
+
+TUint SsdpAliveFilter::Suppressed() const
+{
+    return iSuppressed;
+}
+
 // SsdpSocketReader
 
-SsdpSocketReader::SsdpSocketReader(Environment& aEnv, TIpAddress aInterface, const Endpoint& aMulticast)
+SsdpSocketReader::SsdpSocketReader(Environment& aEnv, TIpAddress aInterface, const Endpoint& aMulticast, TUint aMaxDatagramBytes)
     : SocketUdpMulticast(aEnv, aInterface, aMulticast)
 {
     SetTtl(aEnv.InitParams()->MsearchTtl()); 
-    iReader = new UdpReader(*this);
+    iReader = new UdpBatchReader(*this, aMaxDatagramBytes);
 }
 
 SsdpSocketReader::~SsdpSocketReader()
@@ -59,7 +197,8 @@ SsdpListenerMulticast::SsdpListenerMulticast(Environment& aEnv, TIpAddress aInte
     , iLock("LMCM")
     , iNextHandlerId(0)
     , iInterface(aInterface)
-    , iSocket(aEnv, aInterface, Endpoint(Ssdp::kMulticastPort, Ssdp::kMulticastAddress))
+    , iAliveFilter(aEnv.InitParams()->SsdpDuplicateWindowMs())
+    , iSocket(aEnv, aInterface, Endpoint(Ssdp::kMulticastPort, Ssdp::kMulticastAddress), kMaxBufferBytes)
     , iBuffer(iSocket)
     , iReaderUntil(iBuffer)
     , iReaderRequest(aEnv, iReaderUntil)
@@ -104,14 +243,17 @@ void SsdpListenerMulticast::Run()
                         LOG(kSsdpMulticast, "SSDP Multicast      Notify\n");
                         iLock.Wait();
                         EraseDisabled(iNotifyHandlers);
-                        VectorNotifyHandler callbacks;
-                        TUint count = (TUint)iNotifyHandlers.size();
-                        for (TUint i=0; i<count; i++) {
-                            callbacks.push_back(iNotifyHandlers[i]);
+                        if (PassNotify()) {
+                            GetNotifyHandlers();
+                        }
+                        else {
+                            iNotifyCallbacks.clear();
                         }
                         iLock.Signal();
+                        // only this thread deletes handlers so iNotifyCallbacks remains valid outside iLock
+                        const TUint count = (TUint)iNotifyCallbacks.size();
                         for (TUint i = 0; i<count; i++) {
-                            Notify(*(callbacks[i]));
+                            Notify(*(iNotifyCallbacks[i]));
                         }
                     }
                     else if (method == Ssdp::kMethodMsearch) {
@@ -207,6 +349,61 @@ void SsdpListenerMulticast::Msearch(ISsdpMsearchHandler& aMsearchHandler)
     }
 }
 
+TBool SsdpListenerMulticast::TryGetNtKey(TUint32& aKey) const
+{
+    if (!iHeaderNt.Received()) {
+        return false;
+    }
+    switch (iHeaderNt.Target())
+    {
+    case eSsdpRoot:
+        aKey = SsdpNotifyFilter::Key(eSsdpRoot, Brx::Empty(), Brx::Empty());
+        return true;
+    case eSsdpUuid:
+        aKey = SsdpNotifyFilter::Key(eSsdpUuid, iHeaderNt.Uuid(), Brx::Empty());
+        return true;
+    case eSsdpDeviceType:
+    case eSsdpServiceType:
+        aKey = SsdpNotifyFilter::Key(iHeaderNt.Target(), iHeaderNt.Domain(), iHeaderNt.Type());
+        return true;
+    default:
+        return false;
+    }
+}
+
+TBool SsdpListenerMulticast::PassNotify()
+{
+    TUint32 key;
+    if (!iHeaderNts.Received() || !iHeaderUsn.Received() || !TryGetNtKey(key)) {
+        return true; // leave Notify() to reject malformed messages
+    }
+    if (!iHeaderNts.Alive()) {
+        iAliveFilter.ByeBye(iHeaderUsn.Uuid());
+        return true;
+    }
+    if (!iHeaderLocation.Received()) {
+        return true;
+    }
+    if (iAliveFilter.Alive(Os::TimeInMs(iEnv.OsCtx()), iSocket.Sender(), key, iHeaderUsn.Uuid(), iHeaderLocation.Location(), iHeaderCacheControl.MaxAge())) {
+        return true;
+    }
+    LOG(kSsdpMulticast, "SSDP Multicast      Notify Alive suppressed - %.*s\n", PBUF(iHeaderUsn.Uuid()));
+    return false;
+}
+
+void SsdpListenerMulticast::GetNotifyHandlers()
+{
+    iNotifyCallbacks.assign(iNotifyHandlersAll.begin(), iNotifyHandlersAll.end());
+    TUint32 key;
+    if (!TryGetNtKey(key)) {
+        return;
+    }
+    MapNotifyHandler::iterator it = iNotifyHandlersIndex.find(key);
+    if (it != iNotifyHandlersIndex.end()) {
+        iNotifyCallbacks.insert(iNotifyCallbacks.end(), it->second.begin(), it->second.end());
+    }
+}
+
 void SsdpListenerMulticast::Notify(NotifyHandler& aHandler)
 {
     AutoMutex a(aHandler.Mutex());
@@ -341,13 +538,19 @@ SsdpListenerMulticast::~SsdpListenerMulticast()
     ASSERT(iMsearchHandlers.size() == 0);
 }
 
-TInt SsdpListenerMulticast::AddNotifyHandler(ISsdpNotifyHandler* aNotifyHandler)
+TInt SsdpListenerMulticast::AddNotifyHandler(ISsdpNotifyHandler* aNotifyHandler, const SsdpNotifyFilter& aFilter)
 {
     ASSERT(aNotifyHandler != NULL);
     iLock.Wait();
     TInt id = iNextHandlerId;
-    NotifyHandler* handler = new NotifyHandler(aNotifyHandler, iNextHandlerId);
+    NotifyHandler* handler = new NotifyHandler(aNotifyHandler, aFilter, iNextHandlerId);
     iNotifyHandlers.push_back(handler);
+    if (aFilter.All()) {
+        iNotifyHandlersAll.push_back(handler);
+    }
+    else {
+        iNotifyHandlersIndex[aFilter.Key()].push_back(handler);
+    }
     iNextHandlerId++;
     iLock.Signal();
     return id;
@@ -397,6 +600,13 @@ void SsdpListenerMulticast::RemoveMsearchHandler(TInt aHandlerId)
     iLock.Signal();
 }
 
+void SsdpListenerMulticast::GetAliveCounts(TUint& aPassed, TUint& aSuppressed) const
+{
+    AutoMutex a(iLock);
+    aPassed = iAliveFilter.Passed();
+    aSuppressed = iAliveFilter.Suppressed();
+}
+
 TIpAddress SsdpListenerMulticast::Interface() const
 {
     return iInterface;
@@ -410,6 +620,7 @@ void SsdpListenerMulticast::EraseDisabled(VectorNotifyHandler& aVector)
         handler->Lock();
         if (handler->IsDisabled()) {
             handler->Unlock();
+            RemoveFromIndex(*handler);
             delete handler;
             it = aVector.erase(it);
         }
@@ -420,6 +631,22 @@ void SsdpListenerMulticast::EraseDisabled(VectorNotifyHandler& aVector)
     }
 }
 
+void SsdpListenerMulticast::RemoveFromIndex(NotifyHandler& aHandler)
+{
+    const SsdpNotifyFilter& filter = aHandler.Filter();
+    VectorNotifyHandler* handlers = &iNotifyHandlersAll;
+    MapNotifyHandler::iterator it = iNotifyHandlersIndex.end();
+    if (!filter.All()) {
+        it = iNotifyHandlersIndex.find(filter.Key());
+        ASSERT(it != iNotifyHandlersIndex.end());
+        handlers = &it->second;
+    }
+    handlers->erase(std::find(handlers->begin(), handlers->end(), &aHandler));
+    if (it != iNotifyHandlersIndex.end() && handlers->size() == 0) {
+        iNotifyHandlersIndex.erase(it);
+    }
+}
+
 void SsdpListenerMulticast::EraseDisabled(VectorMsearchHandler& aVector)
 {
     VectorMsearchHandler::iterator it = aVector.begin();
@@ -459,7 +686,7 @@ SsdpListenerUnicast::SsdpListenerUnicast(Environment& aEnv, ISsdpNotifyHandler&
     , iInterface(aInterface)
     , iSocket(aEnv, 0, aInterface)
     , iSocketWriter(iSocket, Endpoint(Ssdp::kMulticastPort, Ssdp::kMulticastAddress))
-    , iSocketReader(iSocket)
+    , iSocketReader(iSocket, kMaxBufferBytes)
     , iWriteBuffer(iSocketWriter)
     , iWriter(iWriteBuffer)
     , iReadBuffer(iSocketReader)
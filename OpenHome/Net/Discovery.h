@@ -9,6 +9,7 @@
 #include <OpenHome/Private/Network.h>
 
 #include <vector>
+#include <map>
 
 namespace OpenHome {
 class Environment;
@@ -30,6 +31,60 @@ public:
     virtual ~ISsdpNotifyHandler() {}
 };
 
+// SsdpNotifyFilter - the notifications an ISsdpNotifyHandler wants to receive
+//                  - handlers must still check the uuid/domain/type/version they're passed;
+//                    filtering only avoids most calls for uninteresting notifications
+class SsdpNotifyFilter
+{
+public:
+    SsdpNotifyFilter(); // all notifications
+    static SsdpNotifyFilter Root();
+    static SsdpNotifyFilter Uuid(const Brx& aUuid);
+    static SsdpNotifyFilter DeviceType(const Brx& aDomain, const Brx& aType);  // any version
+    static SsdpNotifyFilter ServiceType(const Brx& aDomain, const Brx& aType); // any version
+    TBool All() const;
+    TUint32 Key() const;
+    static TUint32 Key(ESsdpTarget aTarget, const Brx& aUuidOrDomain, const Brx& aType);
+private:
+    SsdpNotifyFilter(ESsdpTarget aTarget, const Brx& aUuidOrDomain, const Brx& aType);
+private:
+    ESsdpTarget iTarget;
+    TUint32 iKey;
+};
+
+// SsdpAliveFilter - drops ssdp:alive notifications which repeat the location and max-age last
+//                   seen for the same sender/uuid/NT within a short window
+//                 - bounded; the oldest entries are overwritten when the table is full
+class SsdpAliveFilter
+{
+    static const TUint kSlots = 256;
+    static const TUint kProbes = 4;
+public:
+    SsdpAliveFilter(TUint aWindowMs); // aWindowMs==0 disables suppression
+    TBool Alive(TUint aNowMs, const Endpoint& aSender, TUint32 aNtKey, const Brx& aUuid, const Brx& aLocation, TUint aMaxAge); // false => drop
+    void ByeBye(const Brx& aUuid);
+    TUint Passed() const;
+    TUint Suppressed() const;
+private:
+    class Entry
+    {
+    public:
+        Entry() : iUsed(false) {}
+    public:
+        TBool iUsed;
+        TUint32 iKey;
+        TUint32 iUuidHash;
+        TUint32 iLocationHash;
+        TUint iMaxAge;
+        TUint iTimeMs;
+    };
+private:
+    TUint iWindowMs;
+    Entry iEntries[kSlots];
+    TUint iPassed;
+    TUint iSuppressed;
+};
+
 // IMsearchHandler - called by MulticastListener on receiving an m-search request
 class ISsdpMsearchHandler
 {
@@ -45,7 +100,7 @@ public:
 class SsdpSocketReader : public SocketUdpMulticast, public IReaderSource
 {
 public:
-    SsdpSocketReader(Environment& aEnv, TIpAddress aInterface, const Endpoint& aMulticast);
+    SsdpSocketReader(Environment& aEnv, TIpAddress aInterface, const Endpoint& aMulticast, TUint aMaxDatagramBytes);
     ~SsdpSocketReader();
     Endpoint Sender() const; // endpoint of the sender to the multicast address
 private: // from IReaderSource
@@ -53,7 +108,7 @@ private: // from IReaderSource
     void ReadFlush();
     void ReadInterrupt();
 private:
-    UdpReader* iReader;
+    UdpBatchReader* iReader;
 };
 
 // SsdpListener - base class for ListenerMulticast and ListenerUnicast
@@ -95,10 +150,13 @@ class SsdpListenerMulticast : public SsdpListener, private IResumeObserver
     class NotifyHandler : public Handler
     {
     public:
-        NotifyHandler(ISsdpNotifyHandler* aHandler, TInt aId) : SsdpListenerMulticast::Handler(aId), iHandler(aHandler) {}
+        NotifyHandler(ISsdpNotifyHandler* aHandler, const SsdpNotifyFilter& aFilter, TInt aId)
+            : SsdpListenerMulticast::Handler(aId), iHandler(aHandler), iFilter(aFilter) {}
         ISsdpNotifyHandler* Handler() { return iHandler; }
+        const SsdpNotifyFilter& Filter() const { return iFilter; }
     private:
         ISsdpNotifyHandler* iHandler;
+        SsdpNotifyFilter iFilter;
     };
     class MsearchHandler : public Handler
     {
@@ -110,17 +168,23 @@ class SsdpListenerMulticast : public SsdpListener, private IResumeObserver
     };
     typedef std::vector<NotifyHandler*> VectorNotifyHandler;
     typedef std::vector<MsearchHandler*> VectorMsearchHandler;
+    typedef std::map<TUint32, VectorNotifyHandler> MapNotifyHandler; // SsdpNotifyFilter::Key() -> handlers
 public:
     SsdpListenerMulticast(Environment& aEnv, TIpAddress aInterface);
     virtual ~SsdpListenerMulticast();
-    TInt AddNotifyHandler(ISsdpNotifyHandler* aNotifyHandler);
+    TInt AddNotifyHandler(ISsdpNotifyHandler* aNotifyHandler, const SsdpNotifyFilter& aFilter = SsdpNotifyFilter());
     TInt AddMsearchHandler(ISsdpMsearchHandler* aMsearchHandler);
     void RemoveNotifyHandler(TInt aHandlerId);
     void RemoveMsearchHandler(TInt aHandlerId);
     TIpAddress Interface() const;
+    void GetAliveCounts(TUint& aPassed, TUint& aSuppressed) const;
 private:
     void Run();
     void Terminated();
+    TBool TryGetNtKey(TUint32& aKey) const;
+    TBool PassNotify();
+    void GetNotifyHandlers();
+    void RemoveFromIndex(NotifyHandler& aHandler);
     void Notify(NotifyHandler& aHandler);
     void Notify(ISsdpNotifyHandler& aNotifyHandler);
     void Msearch(MsearchHandler& aHandler);
@@ -132,10 +196,14 @@ private: // from IResumeObserver
 private:
     Environment& iEnv;
     VectorNotifyHandler iNotifyHandlers;
+    VectorNotifyHandler iNotifyHandlersAll;    // handlers with unfiltered interest
+    MapNotifyHandler iNotifyHandlersIndex;     // all other handlers
+    VectorNotifyHandler iNotifyCallbacks;      // handlers for the current message; reused to avoid allocation per message
     VectorMsearchHandler iMsearchHandlers;
-    OpenHome::Mutex iLock;
+    mutable OpenHome::Mutex iLock;
     TInt iNextHandlerId;
     TIpAddress iInterface;
+    SsdpAliveFilter iAliveFilter;
     SsdpSocketReader iSocket;
     Srs<kMaxBufferBytes> iBuffer;
     ReaderUntilS<kMaxBufferBytes> iReaderUntil;
@@ -174,7 +242,7 @@ private:
     TIpAddress iInterface;
     SocketUdp iSocket;
     UdpWriter iSocketWriter;
-    UdpReader iSocketReader;
+    UdpBatchReader iSocketReader;
     Sws<kMaxBufferBytes> iWriteBuffer;
     SsdpWriterMsearchRequest iWriter;
     Srs<kMaxBufferBytes> iReadBuffer;
@@ -287,12 +287,22 @@ void InitialisationParams::SetMsearchTtl(uint32_t aTtl)
     iMsearchTtl = aTtl;
 }
 
+void InitialisationParams::SetSsdpDuplicateWindow(uint32_t aMs)
+{
+    iSsdpDuplicateWindowMs = aMs;
+}
+
 void InitialisationParams::SetNumEventSessionThreads(uint32_t aNumThreads)
 {
     ASSERT(aNumThreads > 0);
     iNumEventSessionThreads = aNumThreads;
 }
 
+void InitialisationParams::SetNumEventDispatchThreads(uint32_t aNumThreads)
+{
+    iNumEventDispatchThreads = aNumThreads;
+}
+
 void InitialisationParams::SetNumXmlFetcherThreads(uint32_t aNumThreads)
 {
     ASSERT(aNumThreads > 0);
@@ -355,6 +365,17 @@ void InitialisationParams::SetDvNumServerThreads(uint32_t aNumThreads)
     iDvNumServerThreads = aNumThreads;
 }
 
+void InitialisationParams::SetDvNumServerListeners(uint32_t aNumListeners)
+{
+    ASSERT(aNumListeners > 0);
+    iDvNumServerListeners = aNumListeners;
+}
+
+void InitialisationParams::SetDvSsdpPacketsPerSec(uint32_t aPacketsPerSec)
+{
+    iDvSsdpPacketsPerSec = aPacketsPerSec;
+}
+
 void InitialisationParams::SetDvNumPublisherThreads(uint32_t aNumThreads)
 {
     ASSERT(aNumThreads > 0);
@@ -419,6 +440,11 @@ void InitialisationParams::SetHttpUserAgent(const Brx& aUserAgent)
     iUserAgent.Set(aUserAgent);
 }
 
+void InitialisationParams::SetCpUpnpDeviceCache(const TChar* aFilename)
+{
+    iCpUpnpDeviceCache.Set(aFilename);
+}
+
 FunctorMsg& InitialisationParams::LogOutput()
 {
     return iLogOutput;
@@ -484,11 +510,21 @@ uint32_t InitialisationParams::MsearchTtl() const
     return iMsearchTtl;
 }
 
+uint32_t InitialisationParams::SsdpDuplicateWindowMs() const
+{
+    return iSsdpDuplicateWindowMs;
+}
+
 uint32_t InitialisationParams::NumEventSessionThreads() const
 {
     return iNumEventSessionThreads;
 }
 
+uint32_t InitialisationParams::NumEventDispatchThreads() const
+{
+    return iNumEventDispatchThreads;
+}
+
 uint32_t InitialisationParams::NumXmlFetcherThreads() const
 {
     return iNumXmlFetcherThreads;
@@ -539,6 +575,16 @@ uint32_t InitialisationParams::DvNumServerThreads() const
     return iDvNumServerThreads;
 }
 
+uint32_t InitialisationParams::DvNumServerListeners() const
+{
+    return iDvNumServerListeners;
+}
+
+uint32_t InitialisationParams::DvSsdpPacketsPerSec() const
+{
+    return iDvSsdpPacketsPerSec;
+}
+
 uint32_t InitialisationParams::DvNumPublisherThreads() const
 {
     return iDvNumPublisherThreads;
@@ -604,6 +650,12 @@ const Brx& InitialisationParams::HttpUserAgent() const
     return iUserAgent;
 }
 
+bool InitialisationParams::CpUpnpDeviceCacheEnabled(const TChar*& aFilename) const
+{
+    aFilename = iCpUpnpDeviceCache.CString();
+    return (iCpUpnpDeviceCache.Bytes() > 0);
+}
+
 #if defined(PLATFORM_MACOSX_GNU) || defined (PLATFORM_IOS)
 /* Assume that all Apple products have poor quality networking.
    This won't be the case for a wired Mac desktop but we'd need a way of signalling which
@@ -617,7 +669,9 @@ InitialisationParams::InitialisationParams()
     : iTcpConnectTimeoutMs(3000)
     , iMsearchTimeSecs(3)
     , iMsearchTtl(2)
+    , iSsdpDuplicateWindowMs(1000)
     , iNumEventSessionThreads(4)
+    , iNumEventDispatchThreads(0)
     , iNumXmlFetcherThreads(4)
     , iNumActionInvokerThreads(4)
     , iNumInvocations(20)
@@ -628,6 +682,8 @@ InitialisationParams::InitialisationParams()
     , iUseLoopbackNetworkAdapter(ELoopbackExclude)
     , iDvMaxUpdateTimeSecs(1800)
     , iDvNumServerThreads(4)
+    , iDvNumServerListeners(1)
+    , iDvSsdpPacketsPerSec(200)
     , iDvNumPublisherThreads(4)
     , iDvPublisherThreadPriority(kPriorityNormal)
     , iDvNumWebSocketThreads(0)
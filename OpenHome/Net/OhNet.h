@@ -228,12 +228,31 @@ public:
      * Set the time-to-live value for msearches.
      */
     void SetMsearchTtl(uint32_t aTtl);
+    /**
+     * Set the period over which repeated ssdp:alive notifications from the same
+     * sender with unchanged location and max-age are suppressed.
+     * Zero disables suppression.
+     */
+    void SetSsdpDuplicateWindow(uint32_t aMs);
     /**
      * Set the number of threads which should be dedicated to eventing (handling
      * updates to subscribed state variables)
      * Must be greater than zero.
      */
     void SetNumEventSessionThreads(uint32_t aNumThreads);
+    /**
+     * Set the number of threads which run proxy property change callbacks.
+     * Defaults to zero, where callbacks run on the event session thread that
+     * received each update, once per update.  A slow callback then holds up
+     * that session's later events.
+     * Any other value moves callbacks onto that many dispatch threads.  Event
+     * session threads then only apply updates, so a slow callback doesn't
+     * delay the processing of later events.  Callbacks then run
+     * asynchronously and changes which arrive while a callback is pending are
+     * reported together, so a callback may see values from later updates and
+     * will not run once per update.
+     */
+    void SetNumEventDispatchThreads(uint32_t aNumThreads);
     /**
      * Set the number of threads which should be dedicated to fetching
      * device/service XML.
@@ -301,6 +320,19 @@ public:
      * making concurrent requests but will also require more system resources.
      */
     void SetDvNumServerThreads(uint32_t aNumThreads);
+    /**
+     * Set the number of listening sockets each UPnP device server opens on its port.
+     * Where the platform supports SO_REUSEPORT, incoming connections are spread between
+     * listeners, each served by its own group of DvNumServerThreads threads.
+     * Other platforms always use a single listener.
+     */
+    void SetDvNumServerListeners(uint32_t aNumListeners);
+    /**
+     * Set the maximum rate at which all devices together send multicast
+     * alive/byebye/update notifications.
+     * Zero removes the limit.
+     */
+    void SetDvSsdpPacketsPerSec(uint32_t aPacketsPerSec);
     /**
      * Set the number of threads which should be dedicated to publishing
      * changes to state variables on a service + device.
@@ -376,6 +408,13 @@ public:
      * Set UserAgent header to be reported by HTTP clients
      */
     void SetHttpUserAgent(const Brx& aUserAgent);
+    /**
+     * Persist the UPnP devices found by control points to aFilename.
+     * Devices in this cache are reported by device lists immediately on startup
+     * then revalidated in the background.  Devices which can't be revalidated
+     * are reported as removed.
+     */
+    void SetCpUpnpDeviceCache(const TChar* aFilename);
 
     FunctorMsg& LogOutput();
     FunctorMsg& FatalErrorHandler();
@@ -390,7 +429,9 @@ public:
     uint32_t TcpConnectTimeoutMs() const;
     uint32_t MsearchTimeSecs() const;
     uint32_t MsearchTtl() const;
+    uint32_t SsdpDuplicateWindowMs() const;
     uint32_t NumEventSessionThreads() const;
+    uint32_t NumEventDispatchThreads() const;
     uint32_t NumXmlFetcherThreads() const;
     uint32_t NumActionInvokerThreads() const;
     uint32_t NumInvocations() const;
@@ -401,6 +442,8 @@ public:
     ELoopback LoopbackNetworkAdapter() const;
     uint32_t DvMaxUpdateTimeSecs() const;
     uint32_t DvNumServerThreads() const;
+    uint32_t DvNumServerListeners() const;
+    uint32_t DvSsdpPacketsPerSec() const;
     uint32_t DvNumPublisherThreads() const;
     uint32_t DvPublisherThreadPriority() const;
     uint32_t DvNumWebSocketThreads() const;
@@ -413,6 +456,7 @@ public:
     bool IsHostUdpLowQuality();
     uint32_t TimerManagerPriority() const;
     const Brx& HttpUserAgent() const;
+    bool CpUpnpDeviceCacheEnabled(const TChar*& aFilename) const;
 private:
     InitialisationParams();
     void FatalErrorHandlerDefault(const char* aMsg);
@@ -432,7 +476,9 @@ private:
     uint32_t iTcpConnectTimeoutMs;
     uint32_t iMsearchTimeSecs;
     uint32_t iMsearchTtl;
+    uint32_t iSsdpDuplicateWindowMs;
     uint32_t iNumEventSessionThreads;
+    uint32_t iNumEventDispatchThreads;
     uint32_t iNumXmlFetcherThreads;
     uint32_t iNumActionInvokerThreads;
     uint32_t iNumInvocations;
@@ -443,6 +489,8 @@ private:
     ELoopback iUseLoopbackNetworkAdapter;
     uint32_t iDvMaxUpdateTimeSecs;
     uint32_t iDvNumServerThreads;
+    uint32_t iDvNumServerListeners;
+    uint32_t iDvSsdpPacketsPerSec;
     uint32_t iDvNumPublisherThreads;
     uint32_t iDvPublisherThreadPriority;
     uint32_t iDvNumWebSocketThreads;
@@ -456,6 +504,7 @@ private:
     uint32_t iDvLpecServerPort;
     uint32_t iTimerManagerThreadPriority;
     Brh iUserAgent;
+    Brhz iCpUpnpDeviceCache;
 };
 
 class CpStack;
@@ -248,14 +248,39 @@ void Property::ResetSequenceNumber()
     iSequenceNumber = 0;
 }
 
-TBool Property::ReportChanged()
+TBool Property::ClearChanged()
 {
-    if (iChanged) {
-        iFunctor();
-        iChanged = false;
-        return true;
+    AutoMutex _(iLock);
+    const TBool changed = iChanged;
+    iChanged = false;
+    return changed;
+}
+
+void Property::NotifyChanged()
+{
+    iFunctor();
+}
+
+TBool Property::Staged() const
+{
+    return iStaged;
+}
+
+void Property::Commit()
+{
+    AutoMutex _(iLock);
+    if (iStaged) {
+        iStaged = false;
+        if (CommitStaged() || iSequenceNumber == 0) {
+            iChanged = true;
+            iSequenceNumber++;
+        }
     }
-    return false;
+}
+
+void Property::DiscardStaged()
+{
+    iStaged = false;
 }
 
 Property::Property(OpenHome::Net::Parameter* aParameter, Functor& aFunctor)
@@ -264,6 +289,7 @@ Property::Property(OpenHome::Net::Parameter* aParameter, Functor& aFunctor)
     , iFunctor(aFunctor)
     , iChanged(false)
     , iSequenceNumber(0)
+    , iStaged(false)
 {
     ASSERT(iParameter != NULL);
     ASSERT(iParameter->Type() != OpenHome::Net::Parameter::eTypeRelated);
@@ -274,6 +300,7 @@ Property::Property(OpenHome::Net::Parameter* aParameter)
     , iParameter(aParameter)
     , iChanged(false)
     , iSequenceNumber(0)
+    , iStaged(false)
 {
     ASSERT(iParameter != NULL);
     ASSERT(iParameter->Type() != OpenHome::Net::Parameter::eTypeRelated);
@@ -284,6 +311,7 @@ void Property::Construct(OpenHome::Net::Parameter* aParameter)
     iParameter = aParameter;
     iChanged = true;
     iSequenceNumber = 0;
+    iStaged = false;
     ASSERT(iParameter != NULL);
     ASSERT(iParameter->Type() != OpenHome::Net::Parameter::eTypeRelated);
 }
@@ -319,17 +347,20 @@ const Brx& PropertyString::Value() const
     return iValue;
 }
 
-void PropertyString::Process(IOutputProcessor& aProcessor, const Brx& aBuffer)
+void PropertyString::Stage(IOutputProcessor& aProcessor, const Brx& aBuffer)
 {
-    AutoMutex _(iLock);
-    Brhz old;
-    iValue.TransferTo(old);
-    iValue.Set(Brx::Empty());
-    aProcessor.ProcessString(aBuffer, iValue);
-    if (iSequenceNumber == 0 || old != iValue) {
-        iChanged = true;
-        iSequenceNumber++;
+    iStagedValue.Set(Brx::Empty());
+    aProcessor.ProcessString(aBuffer, iStagedValue);
+    iStaged = true;
+}
+
+TBool PropertyString::CommitStaged()
+{
+    if (iStagedValue == iValue) {
+        return false;
     }
+    iStagedValue.TransferTo(iValue);
+    return true;
 }
 
 TBool PropertyString::SetValue(const Brx& aValue)
@@ -375,15 +406,17 @@ TInt PropertyInt::Value() const
     return iValue;
 }
 
-void PropertyInt::Process(IOutputProcessor& aProcessor, const Brx& aBuffer)
+void PropertyInt::Stage(IOutputProcessor& aProcessor, const Brx& aBuffer)
 {
-    AutoMutex _(iLock);
-    TInt old = iValue;
-    aProcessor.ProcessInt(aBuffer, iValue);
-    if (iSequenceNumber == 0 || old != iValue) {
-        iChanged = true;
-        iSequenceNumber++;
-    }
+    aProcessor.ProcessInt(aBuffer, iStagedValue);
+    iStaged = true;
+}
+
+TBool PropertyInt::CommitStaged()
+{
+    const TBool changed = (iStagedValue != iValue);
+    iValue = iStagedValue;
+    return changed;
 }
 
 TBool PropertyInt::SetValue(TInt aValue)
@@ -429,15 +462,17 @@ TUint PropertyUint::Value() const
     return iValue;
 }
 
-void PropertyUint::Process(IOutputProcessor& aProcessor, const Brx& aBuffer)
+void PropertyUint::Stage(IOutputProcessor& aProcessor, const Brx& aBuffer)
 {
-    AutoMutex _(iLock);
-    TUint old = iValue;
-    aProcessor.ProcessUint(aBuffer, iValue);
-    if (iSequenceNumber == 0 || old != iValue) {
-        iChanged = true;
-        iSequenceNumber++;
-    }
+    aProcessor.ProcessUint(aBuffer, iStagedValue);
+    iStaged = true;
+}
+
+TBool PropertyUint::CommitStaged()
+{
+    const TBool changed = (iStagedValue != iValue);
+    iValue = iStagedValue;
+    return changed;
 }
 
 TBool PropertyUint::SetValue(TUint aValue)
@@ -483,15 +518,17 @@ TBool PropertyBool::Value() const
     return iValue;
 }
 
-void PropertyBool::Process(IOutputProcessor& aProcessor, const Brx& aBuffer)
+void PropertyBool::Stage(IOutputProcessor& aProcessor, const Brx& aBuffer)
 {
-    AutoMutex _(iLock);
-    TBool old = iValue;
-    aProcessor.ProcessBool(aBuffer, iValue);
-    if (iSequenceNumber == 0 || old != iValue) {
-        iChanged = true;
-        iSequenceNumber++;
-    }
+    aProcessor.ProcessBool(aBuffer, iStagedValue);
+    iStaged = true;
+}
+
+TBool PropertyBool::CommitStaged()
+{
+    const TBool changed = (iStagedValue != iValue);
+    iValue = iStagedValue;
+    return changed;
 }
 
 TBool PropertyBool::SetValue(TBool aValue)
@@ -537,16 +574,20 @@ const Brx& PropertyBinary::Value() const
     return iValue;
 }
 
-void PropertyBinary::Process(IOutputProcessor& aProcessor, const Brx& aBuffer)
+void PropertyBinary::Stage(IOutputProcessor& aProcessor, const Brx& aBuffer)
 {
-    AutoMutex _(iLock);
-    Bwh old(iValue.Ptr(), iValue.Bytes());
-    iValue.Set(Brx::Empty());
-    aProcessor.ProcessBinary(aBuffer, iValue);
-    if (iSequenceNumber == 0 || old != iValue) {
-        iChanged = true;
-        iSequenceNumber++;
+    iStagedValue.Set(Brx::Empty());
+    aProcessor.ProcessBinary(aBuffer, iStagedValue);
+    iStaged = true;
+}
+
+TBool PropertyBinary::CommitStaged()
+{
+    if (iStagedValue == iValue) {
+        return false;
     }
+    iStagedValue.TransferTo(iValue);
+    return true;
 }
 
 TBool PropertyBinary::SetValue(const Brx& aValue)
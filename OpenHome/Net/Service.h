@@ -199,13 +199,18 @@ public:
     const OpenHome::Net::Parameter& Parameter() const;
     TUint SequenceNumber() const;
     void ResetSequenceNumber();
-    TBool ReportChanged();
-    virtual void Process(IOutputProcessor& aProcessor, const Brx& aBuffer) = 0;
+    TBool ClearChanged(); // returns true if the property had changed
+    void NotifyChanged();
+    TBool Staged() const;
+    virtual void Stage(IOutputProcessor& aProcessor, const Brx& aBuffer) = 0; // converts a new value without applying it
+    void Commit(); // applies any staged value
+    void DiscardStaged();
     virtual void Write(IPropertyWriter& aWriter) = 0;
 protected:
     Property(OpenHome::Net::Parameter* aParameter, Functor& aFunctor);
     Property(OpenHome::Net::Parameter* aParameter);
     void operator=(const Property &);
+    virtual TBool CommitStaged() = 0; // returns true if the staged value differed from the current one
 private:
     void Construct(OpenHome::Net::Parameter* aParameter);
 protected:
@@ -214,6 +219,7 @@ protected:
     Functor iFunctor;
     TBool iChanged;
     TUint iSequenceNumber;
+    TBool iStaged;
 };
 
 /**
@@ -226,11 +232,14 @@ public:
     DllExport PropertyString(OpenHome::Net::Parameter* aParameter);
     DllExport ~PropertyString();
     DllExport const Brx& Value() const; // !!!! threadsafe?
-    void Process(IOutputProcessor& aProcessor, const Brx& aBuffer);
+    void Stage(IOutputProcessor& aProcessor, const Brx& aBuffer);
     TBool SetValue(const Brx& aValue);
     void Write(IPropertyWriter& aWriter);
+private:
+    TBool CommitStaged();
 private:
     Brhz iValue;
+    Brhz iStagedValue;
 };
 
 /**
@@ -243,11 +252,14 @@ public:
     DllExport PropertyInt(OpenHome::Net::Parameter* aParameter);
     DllExport ~PropertyInt();
     DllExport TInt Value() const;
-    void Process(IOutputProcessor& aProcessor, const Brx& aBuffer);
+    void Stage(IOutputProcessor& aProcessor, const Brx& aBuffer);
     TBool SetValue(TInt aValue);
     void Write(IPropertyWriter& aWriter);
+private:
+    TBool CommitStaged();
 private:
     TInt iValue;
+    TInt iStagedValue;
 };
 
 /**
@@ -260,11 +272,14 @@ public:
     DllExport PropertyUint(OpenHome::Net::Parameter* aParameter);
     DllExport ~PropertyUint();
     DllExport TUint Value() const;
-    void Process(IOutputProcessor& aProcessor, const Brx& aBuffer);
+    void Stage(IOutputProcessor& aProcessor, const Brx& aBuffer);
     TBool SetValue(TUint aValue);
     void Write(IPropertyWriter& aWriter);
+private:
+    TBool CommitStaged();
 private:
     TUint iValue;
+    TUint iStagedValue;
 };
 
 /**
@@ -277,11 +292,14 @@ public:
     DllExport PropertyBool(OpenHome::Net::Parameter* aParameter);
     DllExport ~PropertyBool();
     DllExport TBool Value() const;
-    void Process(IOutputProcessor& aProcessor, const Brx& aBuffer);
+    void Stage(IOutputProcessor& aProcessor, const Brx& aBuffer);
     TBool SetValue(TBool aValue);
     void Write(IPropertyWriter& aWriter);
+private:
+    TBool CommitStaged();
 private:
     TBool iValue;
+    TBool iStagedValue;
 };
 
 /**
@@ -294,11 +312,14 @@ public:
     DllExport PropertyBinary(OpenHome::Net::Parameter* aParameter);
     DllExport ~PropertyBinary();
     DllExport const Brx& Value() const;
-    void Process(IOutputProcessor& aProcessor, const Brx& aBuffer);
+    void Stage(IOutputProcessor& aProcessor, const Brx& aBuffer);
     TBool SetValue(const Brx& aValue);
     void Write(IPropertyWriter& aWriter);
+private:
+    TBool CommitStaged();
 private:
     Brh iValue;
+    Brh iStagedValue;
 };
 
 /**
@@ -54,8 +54,8 @@ static void RunTestDeviceList(CpStack& aCpStack, DvStack& /*aDvStack*/, const st
 extern void TestInvocation(CpStack& aCpStack);
 static void RunTestInvocation(CpStack& aCpStack, DvStack& /*aDvStack*/, const std::vector<Brn>& /*aArgs*/) { TestInvocation(aCpStack); }
 
-extern void TestSubscription(CpStack& aCpStack);
-static void RunTestSubscription(CpStack& aCpStack, DvStack& /*aDvStack*/, const std::vector<Brn>& /*aArgs*/) { TestSubscription(aCpStack); }
+extern void TestSubscription(CpStack& aCpStack, const std::vector<Brn>& aArgs);
+static void RunTestSubscription(CpStack& aCpStack, DvStack& /*aDvStack*/, const std::vector<Brn>& aArgs) { TestSubscription(aCpStack, aArgs); }
 
 extern void TestCpDeviceDv(CpStack& aCpStack, DvStack& aDvStack);
 static void RunTestCpDeviceDv(CpStack& aCpStack, DvStack& aDvStack, const std::vector<Brn>& /*aArgs*/) { TestCpDeviceDv(aCpStack, aDvStack); }
@@ -263,6 +263,7 @@ public:
 public:
     SsdpNotifier(DvStack& aDvStack);
     void Start(TIpAddress aInterface, TUint aConfigId);
+    void SendQueued(); // notifications are queued until this is called
     // ISsdpNotify-based services
     void SsdpNotifyRoot(const Brx& aUuid, const Brx& aUri, ENotificationType aNotificationType);
     void SsdpNotifyUuid(const Brx& aUuid, const Brx& aUri, ENotificationType aNotificationType);
@@ -275,8 +276,7 @@ private:
 private:
     DvStack& iDvStack;
     SocketUdp iSocket;
-    UdpWriter iSocketWriter;
-    Sws<kMaxBufferBytes> iBuffer;
+    UdpBatchWriter iQueue;
     WriterHttpRequest iWriter;
     TUint iConfigId;
 };
@@ -330,11 +330,11 @@ private:
     SsdpNotifier& iNotifier;
 };
 
-class SsdpMsearchResponder : public ISsdpNotify
+// SsdpMsearchResponseRenderer - formats msearch responses to aWriter, flushing after each one
+class SsdpMsearchResponseRenderer : public ISsdpNotify, public INonCopyable
 {
 public:
-    SsdpMsearchResponder(DvStack& aDvStack);
-    void SetRemote(const Endpoint& aEndpoint, TUint aConfigId, TIpAddress aAdapter);
+    SsdpMsearchResponseRenderer(DvStack& aDvStack, IWriter& aWriter, TUint aConfigId);
     // ISsdpNotify
     void SsdpNotifyRoot(const Brx& aUuid, const Brx& aUri);
     void SsdpNotifyUuid(const Brx& aUuid, const Brx& aUri);
@@ -342,15 +342,25 @@ public:
     void SsdpNotifyServiceType(const Brx& aDomain, const Brx& aType, TUint aVersion, const Brx& aUuid, const Brx& aUri);
 private:
     void SsdpNotify(const Brx& aUri);
-    void Flush();
-private:
-    static const TUint kMaxBufferBytes = 1024;
 private:
     DvStack& iDvStack;
-    Bws<kMaxBufferBytes> iResponse;
-    WriterBuffer iBuffer;
     WriterHttpResponse iWriter;
     TUint iConfigId;
+};
+
+// SsdpMsearchResponder - sends batches of pre-rendered msearch responses to a single remote
+class SsdpMsearchResponder : public INonCopyable
+{
+public:
+    static const TUint kMaxBufferBytes = 1024;
+public:
+    SsdpMsearchResponder(DvStack& aDvStack);
+    void SetRemote(const Endpoint& aEndpoint, TIpAddress aAdapter);
+    void Queue(const Brx& aResponse);
+    void SendQueued(); // responses are queued until this is called
+private:
+    DvStack& iDvStack;
+    UdpBatchWriter iQueue;
     Endpoint iRemote;
     TIpAddress iAdapter;
 };
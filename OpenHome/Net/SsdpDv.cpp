@@ -35,9 +35,8 @@ void Ssdp::WriteNextBootId(DvStack& aDvStack, IWriterHttpHeader& aWriter)
 SsdpNotifier::SsdpNotifier(DvStack& aDvStack)
     : iDvStack(aDvStack)
     , iSocket(aDvStack.Env())
-    , iSocketWriter(iSocket, Endpoint(Ssdp::kMulticastPort, Ssdp::kMulticastAddress))
-    , iBuffer(iSocketWriter)
-    , iWriter(iBuffer)
+    , iQueue(kMaxBufferBytes)
+    , iWriter(iQueue)
     , iConfigId(0)
 {
 }
@@ -48,6 +47,12 @@ void SsdpNotifier::Start(TIpAddress aInterface, TUint aConfigId)
     iSocket.SetMulticastIf(aInterface);
     iSocket.SetTtl(iDvStack.Env().InitParams()->MsearchTtl());
     iConfigId = aConfigId;
+    iQueue.Clear();
+}
+
+void SsdpNotifier::SendQueued()
+{
+    iQueue.Send(iSocket, Endpoint(Ssdp::kMulticastPort, Ssdp::kMulticastAddress));
 }
 
 void SsdpNotifier::SsdpNotify(const Brx& aUri, ENotificationType aNotificationType)
@@ -191,26 +196,17 @@ void SsdpNotifierUpdate::SsdpNotifyServiceType(const Brx& aDomain, const Brx& aT
 }
 
 
-// SsdpMsearchResponder
+// SsdpMsearchResponseRenderer
 
-SsdpMsearchResponder::SsdpMsearchResponder(DvStack& aDvStack)
+SsdpMsearchResponseRenderer::SsdpMsearchResponseRenderer(DvStack& aDvStack, IWriter& aWriter, TUint aConfigId)
     : iDvStack(aDvStack)
-    , iBuffer(iResponse)
-    , iWriter(iBuffer)
-    , iConfigId(0)
+    , iWriter(aWriter)
+    , iConfigId(aConfigId)
 {
 }
 
-void SsdpMsearchResponder::SetRemote(const Endpoint& aEndpoint, TUint aConfigId, TIpAddress aAdapter)
-{
-    iRemote.Replace(aEndpoint);
-    iConfigId = aConfigId;
-    iAdapter = aAdapter;
-}
-
-void SsdpMsearchResponder::SsdpNotify(const Brx& aUri)
+void SsdpMsearchResponseRenderer::SsdpNotify(const Brx& aUri)
 {
-    iBuffer.Flush(); // clear any data left over from a previous failed notification
     Ssdp::WriteStatus(iWriter);
     Ssdp::WriteServer(iDvStack.Env(), iWriter);
     Ssdp::WriteMaxAge(iDvStack.Env(), iWriter);
@@ -221,42 +217,65 @@ void SsdpMsearchResponder::SsdpNotify(const Brx& aUri)
     // !!!! Ssdp::WriteSearchPort(iWriter, ????);
 }
 
-void SsdpMsearchResponder::Flush()
-{
-    iWriter.WriteFlush();
-    SocketUdp socket(iDvStack.Env(), 0, iAdapter);
-    socket.Send(iResponse, iRemote);
-    iBuffer.Flush();
-}
-
-void SsdpMsearchResponder::SsdpNotifyRoot(const Brx& aUuid, const Brx& aUri)
+void SsdpMsearchResponseRenderer::SsdpNotifyRoot(const Brx& aUuid, const Brx& aUri)
 {
     SsdpNotify(aUri);
     Ssdp::WriteSearchTypeRoot(iWriter);
     Ssdp::WriteUsnRoot(iWriter, aUuid);
-    Flush();
+    iWriter.WriteFlush();
 }
 
-void SsdpMsearchResponder::SsdpNotifyUuid(const Brx& aUuid, const Brx& aUri)
+void SsdpMsearchResponseRenderer::SsdpNotifyUuid(const Brx& aUuid, const Brx& aUri)
 {
     SsdpNotify(aUri);
     Ssdp::WriteSearchTypeUuid(iWriter, aUuid);
     Ssdp::WriteUsnUuid(iWriter, aUuid);
-    Flush();
+    iWriter.WriteFlush();
 }
 
-void SsdpMsearchResponder::SsdpNotifyDeviceType(const Brx& aDomain, const Brx& aType, TUint aVersion, const Brx& aUuid, const Brx& aUri)
+void SsdpMsearchResponseRenderer::SsdpNotifyDeviceType(const Brx& aDomain, const Brx& aType, TUint aVersion, const Brx& aUuid, const Brx& aUri)
 {
     SsdpNotify(aUri);
     Ssdp::WriteSearchTypeDeviceType(iWriter, aDomain, aType, aVersion);
     Ssdp::WriteUsnDeviceType(iWriter, aDomain, aType, aVersion, aUuid);
-    Flush();
+    iWriter.WriteFlush();
 }
 
-void SsdpMsearchResponder::SsdpNotifyServiceType(const Brx& aDomain, const Brx& aType, TUint aVersion, const Brx& aUuid, const Brx& aUri)
+void SsdpMsearchResponseRenderer::SsdpNotifyServiceType(const Brx& aDomain, const Brx& aType, TUint aVersion, const Brx& aUuid, const Brx& aUri)
 {
     SsdpNotify(aUri);
     Ssdp::WriteSearchTypeServiceType(iWriter, aDomain, aType, aVersion);
     Ssdp::WriteUsnServiceType(iWriter, aDomain, aType, aVersion, aUuid);
-    Flush();
+    iWriter.WriteFlush();
+}
+
+
+// SsdpMsearchResponder
+
+SsdpMsearchResponder::SsdpMsearchResponder(DvStack& aDvStack)
+    : iDvStack(aDvStack)
+    , iQueue(kMaxBufferBytes)
+{
+}
+
+void SsdpMsearchResponder::SetRemote(const Endpoint& aEndpoint, TIpAddress aAdapter)
+{
+    iRemote.Replace(aEndpoint);
+    iAdapter = aAdapter;
+    iQueue.Clear(); // discard any data left over from a previous failed series of responses
+}
+
+void SsdpMsearchResponder::Queue(const Brx& aResponse)
+{
+    iQueue.Write(aResponse);
+    iQueue.WriteFlush();
+}
+
+void SsdpMsearchResponder::SendQueued()
+{
+    if (iQueue.Count() > 0) {
+        // one socket per batch of responses rather than per response
+        SocketUdp socket(iDvStack.Env(), 0, iAdapter);
+        iQueue.Send(socket, iRemote);
+    }
 }
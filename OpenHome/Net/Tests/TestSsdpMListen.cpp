@@ -17,6 +17,9 @@
 #include <OpenHome/Private/Timer.h>
 #include <OpenHome/Private/Env.h>
 #include <OpenHome/Private/NetworkAdapterList.h>
+#include <OpenHome/Private/Ascii.h>
+#include <OpenHome/Private/Network.h>
+#include <OpenHome/Net/Private/Ssdp.h>
 
 using namespace OpenHome;
 using namespace OpenHome::Net;
@@ -182,6 +185,304 @@ void MSearchLogger::SsdpSearchServiceType(const Endpoint& aEndpoint, TUint aMx,
 }
 
 
+class SuiteAliveFilter : public Suite
+{
+public:
+    SuiteAliveFilter() : Suite("Duplicate alive suppression") {}
+    void Test();
+};
+
+
+// SuiteAliveFilter
+
+void SuiteAliveFilter::Test()
+{
+    const Brn uuid1("uuid-1");
+    const Brn uuid2("uuid-2");
+    const Brn location1("http://10.0.0.1:5000/desc.xml");
+    const Brn location2("http://10.0.0.1:5001/desc.xml");
+    const Endpoint sender1(1900, MakeIpAddress(10, 0, 0, 1));
+    const Endpoint sender2(1900, MakeIpAddress(10, 0, 0, 2));
+    const TUint32 root = SsdpNotifyFilter::Root().Key();
+    const TUint32 service = SsdpNotifyFilter::ServiceType(Brn("openhome.org"), Brn("Product")).Key();
+
+    SsdpAliveFilter filter(1000);
+    TEST(filter.Alive(0, sender1, root, uuid1, location1, 1800));
+    TEST(!filter.Alive(100, sender1, root, uuid1, location1, 1800));
+    TEST(!filter.Alive(999, sender1, root, uuid1, location1, 1800));
+    // repeats are always let through once the window (measured from the last one passed) expires
+    TEST(filter.Alive(1000, sender1, root, uuid1, location1, 1800));
+    TEST(!filter.Alive(1500, sender1, root, uuid1, location1, 1800));
+    TEST(filter.Passed() == 2);
+    TEST(filter.Suppressed() == 3);
+
+    // changes to location or max-age pass immediately
+    TEST(filter.Alive(1501, sender1, root, uuid1, location2, 1800));
+    TEST(filter.Alive(1502, sender1, root, uuid1, location2, 900));
+    TEST(!filter.Alive(1503, sender1, root, uuid1, location2, 900));
+
+    // other NTs, uuids and senders are tracked separately
+    TEST(filter.Alive(1504, sender1, service, uuid1, location2, 900));
+    TEST(filter.Alive(1505, sender1, root, uuid2, location2, 900));
+    TEST(filter.Alive(1506, sender2, root, uuid1, location2, 900));
+
+    // byebye forgets all state for a uuid
+    filter.ByeBye(uuid1);
+    TEST(filter.Alive(1507, sender1, root, uuid1, location2, 900));
+    TEST(filter.Alive(1508, sender1, service, uuid1, location2, 900));
+    TEST(!filter.Alive(1509, sender1, root, uuid2, location2, 900));
+
+    // window is shortened for very small max-ages
+    TEST(filter.Alive(2000, sender1, root, uuid2, location1, 1));
+    TEST(!filter.Alive(2249, sender1, root, uuid2, location1, 1));
+    TEST(filter.Alive(2250, sender1, root, uuid2, location1, 1));
+
+    // table is bounded; once full, older entries are evicted and their next alive passes
+    SsdpAliveFilter bounded(1000);
+    Bws<16> buf;
+    for (TUint i=0; i<1000; i++) {
+        buf.Replace("uuid-");
+        Ascii::AppendDec(buf, i);
+        TEST_QUIETLY(bounded.Alive(i, sender1, root, buf, location1, 1800));
+    }
+    TEST(bounded.Passed() == 1000);
+    TEST(bounded.Alive(1000, sender1, root, Brn("uuid-0"), location1, 1800));
+
+    // entries are only matched if their uuids agree; different uuids with the same key mustn't suppress each other
+    SsdpAliveFilter collide(1000);
+    TEST(collide.Alive(0, sender1, root, Brn("uuid-1165246"), location1, 1800));
+    TEST(collide.Alive(1, sender1, root, Brn("uuid-2424780"), location1, 1800));
+    TEST(!collide.Alive(2, sender1, root, Brn("uuid-1165246"), location1, 1800));
+
+    // time wrapping
+    SsdpAliveFilter wrap(1000);
+    TEST(wrap.Alive(0xffffff00, sender1, root, uuid1, location1, 1800));
+    TEST(!wrap.Alive(0x100, sender1, root, uuid1, location1, 1800));
+    TEST(wrap.Alive(0x400, sender1, root, uuid1, location1, 1800));
+
+    // window of zero disables suppression
+    SsdpAliveFilter disabled(0);
+    TEST(disabled.Alive(0, sender1, root, uuid1, location1, 1800));
+    TEST(disabled.Alive(0, sender1, root, uuid1, location1, 1800));
+    TEST(disabled.Suppressed() == 0);
+}
+
+
+
+class RoutingListener : public ISsdpNotifyHandler
+{
+public:
+    enum ECall { eRootAlive, eUuidAlive, eDeviceAlive, eServiceAlive, eRootByeBye, eUuidByeBye, eDeviceByeBye, eServiceByeBye, eCallCount };
+public:
+    RoutingListener(const Brx& aUuid, Semaphore* aSentinelSem = NULL);
+    TUint Count(ECall aCall) const;
+    TUint Total() const;
+private:
+    void Called(const Brx& aUuid, ECall aCall);
+private: // from ISsdpNotifyHandler
+    void SsdpNotifyRootAlive(const Brx& aUuid, const Brx& aLocation, TUint aMaxAge);
+    void SsdpNotifyUuidAlive(const Brx& aUuid, const Brx& aLocation, TUint aMaxAge);
+    void SsdpNotifyDeviceTypeAlive(const Brx& aUuid, const Brx& aDomain, const Brx& aType, TUint aVersion, const Brx& aLocation, TUint aMaxAge);
+    void SsdpNotifyServiceTypeAlive(const Brx& aUuid, const Brx& aDomain, const Brx& aType, TUint aVersion, const Brx& aLocation, TUint aMaxAge);
+    void SsdpNotifyRootByeBye(const Brx& aUuid);
+    void SsdpNotifyUuidByeBye(const Brx& aUuid);
+    void SsdpNotifyDeviceTypeByeBye(const Brx& aUuid, const Brx& aDomain, const Brx& aType, TUint aVersion);
+    void SsdpNotifyServiceTypeByeBye(const Brx& aUuid, const Brx& aDomain, const Brx& aType, TUint aVersion);
+private:
+    Brn iUuid;
+    Semaphore* iSentinelSem;
+    TUint iCounts[eCallCount];
+};
+
+class SuiteNotifyFilter : public Suite
+{
+public:
+    SuiteNotifyFilter(Environment& aEnv);
+    void Test();
+private:
+    void Send(const TChar* aNt, const TChar* aUsn, TBool aAlive);
+private:
+    Environment& iEnv;
+    SocketUdp* iSocket;
+};
+
+static const Brn kFilterUuid("ssdp-filter-test-uuid");
+static const Brn kFilterUuidSentinel("ssdp-filter-test-sentinel");
+static const Brn kFilterDomain("openhome.org");
+
+
+// RoutingListener
+
+RoutingListener::RoutingListener(const Brx& aUuid, Semaphore* aSentinelSem)
+    : iUuid(aUuid)
+    , iSentinelSem(aSentinelSem)
+{
+    for (TUint i=0; i<eCallCount; i++) {
+        iCounts[i] = 0;
+    }
+}
+
+TUint RoutingListener::Count(ECall aCall) const
+{
+    return iCounts[aCall];
+}
+
+TUint RoutingListener::Total() const
+{
+    TUint total = 0;
+    for (TUint i=0; i<eCallCount; i++) {
+        total += iCounts[i];
+    }
+    return total;
+}
+
+void RoutingListener::Called(const Brx& aUuid, ECall aCall)
+{
+    // ignore any other devices that happen to be announcing themselves
+    if (aUuid == iUuid) {
+        iCounts[aCall]++;
+    }
+    else if (iSentinelSem != NULL && aUuid == kFilterUuidSentinel) {
+        iSentinelSem->Signal();
+    }
+}
+
+void RoutingListener::SsdpNotifyRootAlive(const Brx& aUuid, const Brx& /*aLocation*/, TUint /*aMaxAge*/)
+{
+    Called(aUuid, eRootAlive);
+}
+
+void RoutingListener::SsdpNotifyUuidAlive(const Brx& aUuid, const Brx& /*aLocation*/, TUint /*aMaxAge*/)
+{
+    Called(aUuid, eUuidAlive);
+}
+
+void RoutingListener::SsdpNotifyDeviceTypeAlive(const Brx& aUuid, const Brx& /*aDomain*/, const Brx& /*aType*/, TUint /*aVersion*/, const Brx& /*aLocation*/, TUint /*aMaxAge*/)
+{
+    Called(aUuid, eDeviceAlive);
+}
+
+void RoutingListener::SsdpNotifyServiceTypeAlive(const Brx& aUuid, const Brx& /*aDomain*/, const Brx& /*aType*/, TUint /*aVersion*/, const Brx& /*aLocation*/, TUint /*aMaxAge*/)
+{
+    Called(aUuid, eServiceAlive);
+}
+
+void RoutingListener::SsdpNotifyRootByeBye(const Brx& aUuid)
+{
+    Called(aUuid, eRootByeBye);
+}
+
+void RoutingListener::SsdpNotifyUuidByeBye(const Brx& aUuid)
+{
+    Called(aUuid, eUuidByeBye);
+}
+
+void RoutingListener::SsdpNotifyDeviceTypeByeBye(const Brx& aUuid, const Brx& /*aDomain*/, const Brx& /*aType*/, TUint /*aVersion*/)
+{
+    Called(aUuid, eDeviceByeBye);
+}
+
+void RoutingListener::SsdpNotifyServiceTypeByeBye(const Brx& aUuid, const Brx& /*aDomain*/, const Brx& /*aType*/, TUint /*aVersion*/)
+{
+    Called(aUuid, eServiceByeBye);
+}
+
+
+// SuiteNotifyFilter
+
+SuiteNotifyFilter::SuiteNotifyFilter(Environment& aEnv)
+    : Suite("Notify routing by NT")
+    , iEnv(aEnv)
+    , iSocket(NULL)
+{
+}
+
+void SuiteNotifyFilter::Send(const TChar* aNt, const TChar* aUsn, TBool aAlive)
+{
+    Bws<1024> msg("NOTIFY * HTTP/1.1\r\nHOST: 239.255.255.250:1900\r\n");
+    if (aAlive) {
+        msg.Append("CACHE-CONTROL: max-age=1800\r\nLOCATION: http://127.0.0.1:4321/desc.xml\r\nSERVER: Test/1.0 UPnP/1.1 ohNet/1.0\r\n");
+    }
+    msg.Append("NT: ");
+    msg.Append(aNt);
+    msg.Append("\r\nNTS: ");
+    msg.Append(aAlive? "ssdp:alive" : "ssdp:byebye");
+    msg.Append("\r\nUSN: ");
+    msg.Append(aUsn);
+    msg.Append("\r\n\r\n");
+    iSocket->Send(msg, Endpoint(Ssdp::kMulticastPort, Ssdp::kMulticastAddress));
+}
+
+void SuiteNotifyFilter::Test()
+{
+    const TIpAddress loopback = MakeIpAddress(127, 0, 0, 1);
+    Semaphore sentinel("SNFS", 0);
+    RoutingListener all(kFilterUuid, &sentinel);
+    RoutingListener root(kFilterUuid);
+    RoutingListener uuid(kFilterUuid);
+    RoutingListener device(kFilterUuid);
+    RoutingListener service(kFilterUuid);
+    SsdpListenerMulticast* listener = new SsdpListenerMulticast(iEnv, loopback);
+    const TInt idAll = listener->AddNotifyHandler(&all);
+    const TInt idRoot = listener->AddNotifyHandler(&root, SsdpNotifyFilter::Root());
+    const TInt idUuid = listener->AddNotifyHandler(&uuid, SsdpNotifyFilter::Uuid(kFilterUuid));
+    const TInt idDevice = listener->AddNotifyHandler(&device, SsdpNotifyFilter::DeviceType(kFilterDomain, Brn("FilterTestDevice")));
+    const TInt idService = listener->AddNotifyHandler(&service, SsdpNotifyFilter::ServiceType(kFilterDomain, Brn("FilterTestService")));
+    listener->Start();
+    iSocket = new SocketUdp(iEnv, 0, loopback);
+    iSocket->SetMulticastIf(loopback);
+
+    Send("upnp:rootdevice", "uuid:ssdp-filter-test-uuid::upnp:rootdevice", true);
+    Send("uuid:ssdp-filter-test-uuid", "uuid:ssdp-filter-test-uuid", true);
+    Send("urn:openhome-org:device:FilterTestDevice:1", "uuid:ssdp-filter-test-uuid::urn:openhome-org:device:FilterTestDevice:1", true);
+    Send("urn:openhome-org:service:FilterTestService:1", "uuid:ssdp-filter-test-uuid::urn:openhome-org:service:FilterTestService:1", true);
+    // same device but NTs that none of the filtered handlers asked for
+    Send("urn:openhome-org:device:OtherDevice:1", "uuid:ssdp-filter-test-uuid::urn:openhome-org:device:OtherDevice:1", true);
+    Send("urn:openhome-org:service:OtherService:1", "uuid:ssdp-filter-test-uuid::urn:openhome-org:service:OtherService:1", true);
+    Send("urn:other-org:device:FilterTestDevice:1", "uuid:ssdp-filter-test-uuid::urn:other-org:device:FilterTestDevice:1", true);
+    Send("urn:openhome-org:service:OtherService:1", "uuid:ssdp-filter-test-uuid::urn:openhome-org:service:OtherService:1", false);
+    Send("upnp:rootdevice", "uuid:ssdp-filter-test-uuid::upnp:rootdevice", false);
+    Send("urn:openhome-org:service:FilterTestService:1", "uuid:ssdp-filter-test-uuid::urn:openhome-org:service:FilterTestService:1", false);
+    // notifications are handled in order so all of the above have been dispatched once this arrives
+    Send("uuid:ssdp-filter-test-sentinel", "uuid:ssdp-filter-test-sentinel", true);
+    TBool received = true;
+    try {
+        sentinel.Wait(5000);
+    }
+    catch (Timeout&) {
+        received = false;
+    }
+    TEST(received);
+
+    TEST(all.Total() == 10);
+    TEST(all.Count(RoutingListener::eDeviceAlive) == 3);
+    TEST(all.Count(RoutingListener::eServiceAlive) == 2);
+
+    TEST(root.Total() == 2);
+    TEST(root.Count(RoutingListener::eRootAlive) == 1);
+    TEST(root.Count(RoutingListener::eRootByeBye) == 1);
+
+    TEST(uuid.Total() == 1);
+    TEST(uuid.Count(RoutingListener::eUuidAlive) == 1);
+
+    TEST(device.Total() == 1);
+    TEST(device.Count(RoutingListener::eDeviceAlive) == 1);
+
+    TEST(service.Total() == 2);
+    TEST(service.Count(RoutingListener::eServiceAlive) == 1);
+    TEST(service.Count(RoutingListener::eServiceByeBye) == 1);
+
+    listener->RemoveNotifyHandler(idService);
+    listener->RemoveNotifyHandler(idDevice);
+    listener->RemoveNotifyHandler(idUuid);
+    listener->RemoveNotifyHandler(idRoot);
+    listener->RemoveNotifyHandler(idAll);
+    delete iSocket;
+    iSocket = NULL;
+    delete listener;
+}
+
+
 class SuiteListen : public Suite
 {
 public:
@@ -260,6 +561,8 @@ void TestSsdpMListen(Environment& aEnv, const std::vector<Brn>& aArgs)
     }
 
     Runner runner("SSDP multicast listener\n");
+    runner.Add(new SuiteAliveFilter());
+    runner.Add(new SuiteNotifyFilter(aEnv));
     runner.Add(new SuiteListen(aEnv, duration.Value(), adapter.Value()));
     runner.Run();
 }
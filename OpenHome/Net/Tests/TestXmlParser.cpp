@@ -1,5 +1,9 @@
 #include <OpenHome/Private/TestFramework.h>
 #include <OpenHome/Net/Private/XmlParser.h>
+#include <OpenHome/Net/Private/EventUpnp.h>
+#include <OpenHome/Net/Core/CpProxy.h>
+
+#include <vector>
 
 using namespace OpenHome;
 using namespace OpenHome::TestFramework;
@@ -84,12 +88,147 @@ void SuiteXmlParserBasic::Test()
     TEST(XmlParserBasic::Element(Brn("thing"), xmlBuffer, remaining) == Brn("<thing>hidden goodies</thing>"));
     TEST(XmlParserBasic::Element(Brn("inner"), xmlBuffer, remaining) == innerTag);
     TEST(XmlParserBasic::Element(Brn("inner"), xmlBuffer) == innerTag);
+
+    // Iterating over sibling elements
+    Brn tag;
+    TEST(XmlParserBasic::Next(inner, tag, remaining) == Brn("<thing>hidden goodies</thing>"));
+    TEST(tag == Brn("person"));
+    TEST(XmlParserBasic::Next(remaining, tag, remaining) == Brx::Empty());
+    TEST(tag == Brn("person"));
+    TEST(remaining.Bytes() == 0);
+    Brn siblings(" <u:a>1</u:a>\n<b><b>2</b></b> <c/>");
+    TEST(XmlParserBasic::Next(siblings, tag, remaining) == Brn("1"));
+    TEST(tag == Brn("a"));
+    TEST(XmlParserBasic::Next(remaining, tag, remaining) == Brn("<b>2</b>"));
+    TEST(tag == Brn("b"));
+    TEST(XmlParserBasic::Next(remaining, tag, remaining) == Brx::Empty());
+    TEST(tag == Brn("c"));
+    TEST_THROWS(XmlParserBasic::Next(Brn("</a>"), tag, remaining), XmlError);
+    TEST_THROWS(XmlParserBasic::Next(Brn("<a>unterminated"), tag, remaining), XmlError);
+}
+
+class SuiteEventPropertySet : public Suite, private IEventProcessor
+{
+public:
+    SuiteEventPropertySet() : Suite("GENA propertyset parsing") {}
+    ~SuiteEventPropertySet();
+    void Test();
+private: // from IEventProcessor
+    void EventUpdateStart() {}
+    void EventUpdate(const Brx& aName, const Brx& aValue, IOutputProcessor& aProcessor);
+    void EventUpdateEnd() {}
+    void EventUpdateError() {}
+    void EventUpdatePrepareForDelete() {}
+private:
+    void Clear();
+    void CheckUpdates();
+private:
+    EventPropertySetParser iParser;
+    std::vector<Brh*> iUpdates; // alternating names and values
+};
+
+SuiteEventPropertySet::~SuiteEventPropertySet()
+{
+    Clear();
+}
+
+void SuiteEventPropertySet::EventUpdate(const Brx& aName, const Brx& aValue, IOutputProcessor& /*aProcessor*/)
+{
+    iUpdates.push_back(new Brh(aName));
+    iUpdates.push_back(new Brh(aValue));
+}
+
+void SuiteEventPropertySet::Clear()
+{
+    for (TUint i=0; i<(TUint)iUpdates.size(); i++) {
+        delete iUpdates[i];
+    }
+    iUpdates.clear();
+}
+
+void SuiteEventPropertySet::CheckUpdates()
+{
+    TEST_QUIETLY(iUpdates.size() == 6);
+    if (iUpdates.size() == 6) {
+        TEST_QUIETLY(*iUpdates[0] == Brn("VarUint"));
+        TEST_QUIETLY(*iUpdates[1] == Brn("42"));
+        TEST_QUIETLY(*iUpdates[2] == Brn("Metadata"));
+        TEST_QUIETLY(*iUpdates[3] == Brn("&lt;DIDL-Lite&gt;a &amp;gt; b&lt;/DIDL-Lite&gt;"));
+        TEST_QUIETLY(*iUpdates[4] == Brn("Empty"));
+        TEST_QUIETLY(*iUpdates[5] == Brx::Empty());
+    }
+    Clear();
+}
+
+void SuiteEventPropertySet::Test()
+{
+    const Brn doc("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n"
+                  "<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">\r\n"
+                  "<e:property><VarUint>42</VarUint></e:property>\r\n"
+                  "<e:property><Metadata>&lt;DIDL-Lite&gt;a &amp;gt; b&lt;/DIDL-Lite&gt;</Metadata></e:property>\r\n"
+                  "<e:property><Empty/></e:property>\r\n"
+                  "</e:propertyset>\r\n");
+
+    // whole document
+    iParser.Start(*this);
+    iParser.Parse(doc);
+    iParser.End();
+    CheckUpdates();
+
+    // document split into two reads at every possible point
+    for (TUint i=1; i<doc.Bytes(); i++) {
+        iParser.Start(*this);
+        iParser.Parse(doc.Split(0, i));
+        iParser.Parse(doc.Split(i));
+        iParser.End();
+        CheckUpdates();
+    }
+    TEST(iUpdates.size() == 0);
+
+    // one byte per read; the first property is reported as soon as its closing tag arrives
+    Brn remaining;
+    (void)XmlParserBasic::Find("property", doc, remaining);
+    const TUint firstPropertyEnd = (TUint)(remaining.Ptr() - doc.Ptr());
+    iParser.Start(*this);
+    for (TUint i=0; i<doc.Bytes(); i++) {
+        iParser.Parse(doc.Split(i, 1));
+        if (i+2 == firstPropertyEnd) {
+            TEST(iUpdates.size() == 0);
+        }
+        else if (i+1 == firstPropertyEnd) {
+            TEST(iUpdates.size() == 2);
+        }
+    }
+    iParser.End();
+    CheckUpdates();
+
+    // empty propertyset is valid
+    iParser.Start(*this);
+    iParser.Parse(Brn("<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\"></e:propertyset>"));
+    iParser.End();
+    TEST(iUpdates.size() == 0);
+
+    // malformed documents
+    iParser.Start(*this);
+    iParser.Parse(Brn("<e:property><VarUint>42</VarUint></e:property>"));
+    TEST_THROWS(iParser.End(), XmlError); // no propertyset
+    Clear();
+    iParser.Start(*this);
+    TEST_THROWS(iParser.Parse(Brn("<e:propertyset><e:property><VarUint>42</VarInt></e:property></e:propertyset>")), XmlError); // mismatched tags
+    Clear();
+    iParser.Start(*this);
+    iParser.Parse(doc.Split(0, doc.Bytes() - 20));
+    TEST_THROWS(iParser.End(), XmlError); // truncated
+    Clear();
+    iParser.Start(*this);
+    TEST_THROWS(iParser.End(), XmlError); // no entity
 }
 
 void TestXmlParser()
 {
     Runner runner("Test XmlParser");
     runner.Add(new SuiteXmlParserBasic());
+    runner.Add(new SuiteEventPropertySet());
     runner.Run();
 }
 
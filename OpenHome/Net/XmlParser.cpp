@@ -80,6 +80,27 @@ Brn XmlParserBasic::Find(const Brx& aTag, const Brx& aDocument, Brn& aRemaining)
     }
 }
 
+Brn XmlParserBasic::Next(const Brx& aDocument, Brn& aTag, Brn& aRemaining)
+{
+    Brn doc(Ascii::Trim(aDocument));
+    Brn name;
+    Brn attributes;
+    Brn ns;
+    TUint index;
+    Brn remaining;
+    ETagType tagType;
+    NextTag(doc, name, attributes, ns, index, remaining, tagType);
+    if (tagType == eTagClose) {
+        THROW(XmlError);
+    }
+    aTag.Set(name);
+    if (tagType == eTagOpenClose) {
+        aRemaining.Set(remaining);
+        return Brn(Brx::Empty());
+    }
+    return Find(name, doc, aRemaining);
+}
+
 void XmlParserBasic::NextTag(const Brx& aDocument, Brn& aName, Brn& aAttributes, Brn& aNamespace, TUint& aIndex, Brn& aRemaining, ETagType& aType)
 {
     aName.Set(Brx::Empty());
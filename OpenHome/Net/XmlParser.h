@@ -30,6 +30,7 @@ public:
     static Brn Element(const Brx& aTag, const Brx& aDocument);
     static Brn Element(const TChar* aTag, const Brx& aDocument, Brn& aRemaining);
     static Brn Element(const Brx& aTag, const Brx& aDocument, Brn& aRemaining);
+    static Brn Next(const Brx& aDocument, Brn& aTag, Brn& aRemaining); // contents of the first element in aDocument
 
 private:
     enum ETagType
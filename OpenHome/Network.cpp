@@ -6,8 +6,11 @@
 #include <OpenHome/Private/Stream.h>
 #include <OpenHome/Private/Env.h>
 #include <OpenHome/Private/Ascii.h>
+#include <OpenHome/Private/Parser.h>
 
 #include <errno.h>
+#include <string.h>
+#include <algorithm>
 
 using namespace OpenHome;
 
@@ -33,11 +36,17 @@ Endpoint::Endpoint()
 {
     iAddress = 0;
     iPort = 0;
+    iV6 = false;
+    iScopeId = 0;
+    (void)memset(iAddress6, 0, sizeof(iAddress6));
 }
 
 // Construct endpoint with supplied address and port
 Endpoint::Endpoint(TUint aPort, const Brx& aAddress)
 {
+    iV6 = false;
+    iScopeId = 0;
+    (void)memset(iAddress6, 0, sizeof(iAddress6));
     SetPort(aPort);
     SetAddress(aAddress);
 }
@@ -46,6 +55,15 @@ Endpoint::Endpoint(TUint aPort, TIpAddress aAddress)
 {
     iAddress = aAddress;
     iPort = (TUint16)aPort;
+    iV6 = false;
+    iScopeId = 0;
+    (void)memset(iAddress6, 0, sizeof(iAddress6));
+}
+
+Endpoint::Endpoint(TUint aPort, const Address6& aAddress, TUint32 aScopeId)
+{
+    iPort = (TUint16)aPort;
+    SetAddress6(aAddress, aScopeId);
 }
 
 // Replace the endpoint port with the supplied port
@@ -61,20 +79,53 @@ void Endpoint::SetPort(const Endpoint& aEndpoint)
 }
 
 // Replace the endpoint address with the supplied address string
+// Strings containing ':' are IpV6 literals, optionally [bracketed] and with a numeric %scope suffix
 void Endpoint::SetAddress(const Brx& aAddress)
 {
+    if (Ascii::Contains(aAddress, ':')) {
+        Address6 address;
+        TUint32 scopeId;
+        if (!TryParseAddress6(aAddress, address, scopeId)) {
+            THROW(NetworkError);
+        }
+        SetAddress6(address, scopeId);
+        return;
+    }
     iAddress = GetHostByName(aAddress);
+    iV6 = false;
+    iScopeId = 0;
 }
 
 void Endpoint::SetAddress(TIpAddress aAddress)
 {
     iAddress = aAddress;
+    iV6 = false;
+    iScopeId = 0;
 }
 
 // Replace the endpoint address with the address from the supplied endpoint
 void Endpoint::SetAddress(const Endpoint& aEndpoint)
 {
     iAddress = aEndpoint.iAddress;
+    iV6 = aEndpoint.iV6;
+    iScopeId = aEndpoint.iScopeId;
+    (void)memcpy(iAddress6, aEndpoint.iAddress6, sizeof(iAddress6));
+}
+
+void Endpoint::SetAddress6(const Address6& aAddress, TUint32 aScopeId)
+{
+    static const TByte kV4MappedPrefix[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff };
+    if (memcmp(aAddress, kV4MappedPrefix, sizeof(kV4MappedPrefix)) == 0) {
+        TIpAddress address;
+        (void)memcpy(&address, &aAddress[12], sizeof(address)); // TIpAddress is held in network byte order
+        SetAddress(address);
+        (void)memset(iAddress6, 0, sizeof(iAddress6));
+        return;
+    }
+    iAddress = 0;
+    iV6 = true;
+    iScopeId = aScopeId;
+    (void)memcpy(iAddress6, aAddress, sizeof(iAddress6));
 }
 
 TIpAddress Endpoint::Address() const
@@ -87,6 +138,186 @@ TUint16 Endpoint::Port() const
     return iPort;
 }
 
+TBool Endpoint::IsV6() const
+{
+    return iV6;
+}
+
+void Endpoint::GetAddress6(Address6& aAddress) const
+{
+    if (iV6) {
+        (void)memcpy(aAddress, iAddress6, sizeof(iAddress6));
+        return;
+    }
+    (void)memset(aAddress, 0, 10);
+    aAddress[10] = 0xff;
+    aAddress[11] = 0xff;
+    (void)memcpy(&aAddress[12], &iAddress, sizeof(iAddress));
+}
+
+TUint32 Endpoint::ScopeId() const
+{
+    return iScopeId;
+}
+
+static TBool ParseDecimal(const Brx& aBuffer, TUint64 aMax, TUint64& aValue)
+{
+    if (aBuffer.Bytes() == 0 || aBuffer.Bytes() > Ascii::kMaxUintStringBytes) {
+        return false;
+    }
+    aValue = 0;
+    for (TUint i=0; i<aBuffer.Bytes(); i++) {
+        if (!Ascii::IsDigit(aBuffer[i])) {
+            return false;
+        }
+        aValue = aValue * 10 + Ascii::DecValue(aBuffer[i]);
+    }
+    return (aValue <= aMax);
+}
+
+TBool Endpoint::TryParseAddress6(const Brx& aAddress, Address6& aBytes, TUint32& aScopeId)
+{
+    Brn addr(aAddress);
+    if (addr.Bytes() >= 2 && addr[0] == '[' && addr[addr.Bytes()-1] == ']') {
+        addr.Set(addr.Ptr() + 1, addr.Bytes() - 2);
+    }
+    aScopeId = 0;
+    const TUint pct = Ascii::IndexOf(addr, '%');
+    if (pct < addr.Bytes()) {
+        TUint64 scopeId;
+        if (!ParseDecimal(addr.Split(pct + 1), 0xffffffff, scopeId)) {
+            return false;
+        }
+        aScopeId = (TUint32)scopeId;
+        addr.Set(addr.Ptr(), pct);
+    }
+
+    // RFC 4291 section 2.2: up to 8 hex groups, at most one "::", optionally ending in a dotted quad
+    static const TUint kMaxGroups = kAddress6Bytes / 2;
+    TUint16 groups[kMaxGroups];
+    TUint count = 0;
+    TInt gap = -1;
+    const TUint bytes = addr.Bytes();
+    TUint i = 0;
+    if (bytes < 2) {
+        return false;
+    }
+    if (addr[0] == ':') {
+        if (addr[1] != ':') {
+            return false;
+        }
+        gap = 0;
+        i = 2;
+    }
+    while (i < bytes) {
+        TUint j = i;
+        while (j < bytes && addr[j] != ':') {
+            j++;
+        }
+        Brn group(addr.Ptr() + i, j - i);
+        if (Ascii::Contains(group, '.')) {
+            if (j != bytes || count > kMaxGroups - 2) {
+                return false;
+            }
+            TByte octets[4];
+            Parser parser(group);
+            for (TUint k=0; k<4; k++) {
+                TUint64 octet;
+                if (!ParseDecimal(parser.NextNoTrim('.'), 0xff, octet)) {
+                    return false;
+                }
+                octets[k] = (TByte)octet;
+            }
+            if (!parser.Finished()) {
+                return false;
+            }
+            groups[count++] = (TUint16)((octets[0] << 8) | octets[1]);
+            groups[count++] = (TUint16)((octets[2] << 8) | octets[3]);
+            break;
+        }
+        if (group.Bytes() == 0 || group.Bytes() > 4 || count == kMaxGroups) {
+            return false;
+        }
+        TUint value = 0;
+        for (TUint k=0; k<group.Bytes(); k++) {
+            if (!Ascii::IsHex(group[k])) {
+                return false;
+            }
+            value = (value << 4) | Ascii::HexValue(group[k]);
+        }
+        groups[count++] = (TUint16)value;
+        if (j == bytes) {
+            break;
+        }
+        if (++j < bytes && addr[j] == ':') {
+            if (gap >= 0) {
+                return false;
+            }
+            gap = (TInt)count;
+            j++;
+        }
+        else if (j == bytes) {
+            return false; // trailing single ':'
+        }
+        i = j;
+    }
+    if ((gap < 0 && count != kMaxGroups) || (gap >= 0 && count == kMaxGroups)) {
+        return false;
+    }
+
+    (void)memset(aBytes, 0, kAddress6Bytes);
+    const TUint head = (gap < 0? count : (TUint)gap);
+    const TUint tailStart = kMaxGroups - (count - head);
+    for (TUint k=0; k<count; k++) {
+        const TUint index = (k < head? k : tailStart + k - head);
+        aBytes[2*index] = (TByte)(groups[k] >> 8);
+        aBytes[2*index + 1] = (TByte)groups[k];
+    }
+    return true;
+}
+
+void Endpoint::AppendAddress6(Bwx& aAddress) const
+{
+    // RFC 5952 form: lower case, no leading zeros, first longest run (>1) of zero groups replaced by "::"
+    static const TUint kMaxGroups = kAddress6Bytes / 2;
+    TUint groups[kMaxGroups];
+    for (TUint i=0; i<kMaxGroups; i++) {
+        groups[i] = (iAddress6[2*i] << 8) | iAddress6[2*i + 1];
+    }
+    TUint gapStart = kMaxGroups;
+    TUint gapLen = 1;
+    for (TUint i=0; i<kMaxGroups; ) {
+        if (groups[i] != 0) {
+            i++;
+            continue;
+        }
+        TUint j = i;
+        while (j < kMaxGroups && groups[j] == 0) {
+            j++;
+        }
+        if (j - i > gapLen) {
+            gapStart = i;
+            gapLen = j - i;
+        }
+        i = j;
+    }
+    for (TUint i=0; i<kMaxGroups; i++) {
+        if (i == gapStart) {
+            aAddress.Append(Brn("::"));
+            i += gapLen - 1;
+            continue;
+        }
+        if (i > 0 && i != gapStart + gapLen) {
+            aAddress.Append(':');
+        }
+        (void)Ascii::AppendHexTrim(aAddress, groups[i]);
+    }
+    if (iScopeId != 0) {
+        aAddress.Append('%');
+        (void)Ascii::AppendDec(aAddress, (TUint)iScopeId);
+    }
+}
+
 void Endpoint::AppendAddress(Bwx& aAddressBuffer, TIpAddress aAddress)
 {
     ASSERT(aAddressBuffer.MaxBytes() - aAddressBuffer.Bytes() >= kMaxAddressBytes);
@@ -114,13 +345,27 @@ void Endpoint::AppendAddress(Bwx& aAddressBuffer, TIpAddress aAddress)
 
 void Endpoint::AppendAddress(Bwx& aAddress) const
 {
+    if (iV6) {
+        ASSERT(aAddress.MaxBytes() - aAddress.Bytes() >= kMaxAddress6Bytes);
+        AppendAddress6(aAddress);
+        aAddress.PtrZ();
+        return;
+    }
     AppendAddress(aAddress, iAddress);
 }
 
 void Endpoint::AppendEndpoint(Bwx& aEndpoint) const
 {
-    ASSERT(aEndpoint.MaxBytes() - aEndpoint.Bytes() >= kMaxEndpointBytes);
-    AppendAddress(aEndpoint, iAddress);
+    if (iV6) {
+        ASSERT(aEndpoint.MaxBytes() - aEndpoint.Bytes() >= kMaxEndpoint6Bytes);
+        aEndpoint.Append('[');
+        AppendAddress6(aEndpoint);
+        aEndpoint.Append(']');
+    }
+    else {
+        ASSERT(aEndpoint.MaxBytes() - aEndpoint.Bytes() >= kMaxEndpointBytes);
+        AppendAddress(aEndpoint, iAddress);
+    }
     aEndpoint.Append(':');
     (void)Ascii::AppendDec(aEndpoint, iPort);
     aEndpoint.PtrZ();
@@ -153,7 +398,13 @@ void Endpoint::Replace(const Endpoint& aEndpoint)
 // Test if this endpoint is equal to the specified endpoint
 TBool Endpoint::Equals(const Endpoint& aEndpoint) const
 {
-    return (iAddress==aEndpoint.iAddress && iPort==aEndpoint.iPort);
+    if (iPort != aEndpoint.iPort || iV6 != aEndpoint.iV6) {
+        return false;
+    }
+    if (iV6) {
+        return (iScopeId == aEndpoint.iScopeId && memcmp(iAddress6, aEndpoint.iAddress6, sizeof(iAddress6)) == 0);
+    }
+    return (iAddress == aEndpoint.iAddress);
 }
 
 // Socket
@@ -240,6 +491,39 @@ void Socket::Send(const Brx& aBuffer)
     }
 }
 
+void Socket::SendVector(const Brx* const aBuffers[], TUint aCount)
+{
+    static const TUint kMaxBuffers = 16;
+    OsNetworkBuffer buffers[kMaxBuffers];
+    TUint i = 0;
+    while (i < aCount) {
+        TUint count = 0;
+        TUint bytes = 0;
+        for (; i < aCount && count < kMaxBuffers; i++, count++) {
+            buffers[count].iPtr = aBuffers[i]->Ptr();
+            buffers[count].iBytes = aBuffers[i]->Bytes();
+            bytes += aBuffers[i]->Bytes();
+            Log("Socket::SendVector, sending\n", *aBuffers[i]);
+        }
+        LOGF(kNetwork, "Socket::SendVector  H = %d, N = %u, BC = %u\n", iHandle, count, bytes);
+        TInt sent = OpenHome::Os::NetworkSendVector(iHandle, buffers, count);
+        if (sent < 0 || (TUint)sent != bytes) {
+            LOG2F(kNetwork, kError, "Socket::SendVector H = %d, RETURN VALUE = %d\n", iHandle, sent);
+            THROW(NetworkError);
+        }
+    }
+}
+
+void Socket::SendFile(const TChar* aFilename, TUint aOffset, TUint aBytes)
+{
+    LOGF(kNetwork, "Socket::SendFile  H = %d, F = %s, O = %u, BC = %u\n", iHandle, aFilename, aOffset, aBytes);
+    TInt sent = OpenHome::Os::NetworkSendFile(iHandle, aFilename, aOffset, aBytes);
+    if(sent < 0 || (TUint)sent != aBytes) {
+        LOG2F(kNetwork, kError, "Socket::SendFile H = %d, RETURN VALUE = %d\n", iHandle, sent);
+        THROW(NetworkError);
+    }
+}
+
 void Socket::SendTo(const Brx& aBuffer, const Endpoint& aEndpoint)
 {
     LOGF(kNetwork, "Socket::SendTo  H = %d, BC = %d, E = %x:%d\n", iHandle, aBuffer.Bytes(), aEndpoint.Address(), aEndpoint.Port());
@@ -255,6 +539,29 @@ void Socket::SendTo(const Brx& aBuffer, const Endpoint& aEndpoint)
     }
 }
 
+void Socket::SendToBatch(const Brx* const aBuffers[], const Endpoint aEndpoints[], TUint aCount)
+{
+    static const TUint kMaxDatagrams = 16;
+    OsNetworkDatagram datagrams[kMaxDatagrams];
+    TUint i = 0;
+    while (i < aCount) {
+        TUint count = 0;
+        for (; i < aCount && count < kMaxDatagrams; i++, count++) {
+            datagrams[count].iPtr = const_cast<TByte*>(aBuffers[i]->Ptr());
+            datagrams[count].iBytes = aBuffers[i]->Bytes();
+            datagrams[count].iAddress = aEndpoints[i].Address();
+            datagrams[count].iPort = aEndpoints[i].Port();
+            Log("Socket::SendToBatch, sending\n", *aBuffers[i]);
+        }
+        LOGF(kNetwork, "Socket::SendToBatch  H = %d, N = %u\n", iHandle, count);
+        TInt sent = OpenHome::Os::NetworkSendToBatch(iHandle, datagrams, count);
+        if (sent < 0 || (TUint)sent != count) {
+            LOG2F(kNetwork, kError, "Socket::SendToBatch H = %d, RETURN VALUE = %d\n", iHandle, sent);
+            THROW(NetworkError);
+        }
+    }
+}
+
 void Socket::Receive(Bwx& aBuffer)
 {
     // This variant of Receive will receive any number of bytes in the
@@ -314,6 +621,33 @@ void Socket::ReceiveFrom(Bwx& aBuffer, Endpoint& aEndpoint)
     LOGF(kNetwork, "<Socket::ReceiveFrom H = %d\n", iHandle);
 }
 
+TUint Socket::ReceiveFromBatch(Bwx* const aBuffers[], Endpoint aEndpoints[], TUint aCount)
+{
+    static const TUint kMaxDatagrams = 16;
+    OsNetworkDatagram datagrams[kMaxDatagrams];
+    if (aCount > kMaxDatagrams) {
+        aCount = kMaxDatagrams;
+    }
+    for (TUint i=0; i<aCount; i++) {
+        datagrams[i].iPtr = const_cast<TByte*>(aBuffers[i]->Ptr());
+        datagrams[i].iBytes = aBuffers[i]->MaxBytes();
+    }
+    LOGF(kNetwork, "Socket::ReceiveFromBatch H = %d\n", iHandle);
+    TInt received = OpenHome::Os::NetworkReceiveFromBatch(iHandle, datagrams, aCount);
+    if (received <= 0) {
+        LOG2F(kNetwork, kError, "Socket::ReceiveFromBatch H = %d, RETURN VALUE = %d\n", iHandle, received);
+        THROW(NetworkError);
+    }
+    for (TInt i=0; i<received; i++) {
+        aBuffers[i]->SetBytes(datagrams[i].iBytes);
+        aEndpoints[i].SetAddress(datagrams[i].iAddress);
+        aEndpoints[i].SetPort(datagrams[i].iPort);
+        Log("Socket::ReceiveFromBatch, got\n", *aBuffers[i]);
+    }
+    LOGF(kNetwork, "<Socket::ReceiveFromBatch H = %d, N = %d\n", iHandle, received);
+    return (TUint)received;
+}
+
 void Socket::Bind(const Endpoint& aEndpoint)
 {
     LOGF(kNetwork, "Socket::Bind H = %d\n", iHandle);
@@ -453,6 +787,17 @@ void SocketTcp::WriteFlush()
     // all writes go directly to the socket so nothing to flush
 }
 
+void SocketTcp::WriteVector(const Brx* const aBuffers[], TUint aCount)
+{
+    LOGF(kNetwork, "SocketTcp::WriteVector\n");
+    try {
+        SendVector(aBuffers, aCount);
+    }
+    catch(NetworkError&) {
+        THROW(WriterError);
+    }
+}
+
 void SocketTcp::Read(Bwx& aBuffer)
 {
     LOGF(kNetwork, ">SocketTcp::Read\n");
@@ -525,7 +870,7 @@ void SocketTcpClient::Connect(const Endpoint& aEndpoint, TUint aTimeout)
 // Tcp Server
 
 SocketTcpServer::SocketTcpServer(Environment& aEnv, const TChar* aName, TUint aPort, TIpAddress aInterface,
-                                 TUint aSessionPriority, TUint aSessionStackBytes, TUint aSlots)
+                                 TUint aSessionPriority, TUint aSessionStackBytes, TUint aSlots, TUint aListeners)
     : iMutex(aName)
     , iSessionPriority(aSessionPriority)
     , iSessionStackBytes(aSessionStackBytes)
@@ -535,10 +880,22 @@ SocketTcpServer::SocketTcpServer(Environment& aEnv, const TChar* aName, TUint aP
     iHandle = SocketCreate(aEnv, eSocketTypeStream);
     OpenHome::Os::NetworkSocketSetReuseAddress(iHandle);
     TryNetworkTcpSetNoDelay(iHandle);
+    const TBool reusePort = (aListeners > 1 && OpenHome::Os::NetworkSocketTrySetReusePort(iHandle));
     iInterface = aInterface;
     Bind(Endpoint(aPort, aInterface));
     GetPort(iPort);
     Listen(aSlots);
+    if (reusePort) {
+        for (TUint i=1; i<aListeners; i++) {
+            try {
+                iListeners.push_back(new Listener(aEnv, *this, aName, Endpoint(iPort, aInterface), aSlots));
+            }
+            catch (NetworkError&) {
+                LOG2F(kNetwork, kError, "SocketTcpServer::SocketTcpServer - only %u of %u listeners available\n", i, aListeners);
+                break;
+            }
+        }
+    }
 }
 
 void SocketTcpServer::Add(const TChar* aName, SocketTcpSession* aSession, TInt aPriorityOffset)
@@ -547,7 +904,8 @@ void SocketTcpServer::Add(const TChar* aName, SocketTcpSession* aSession, TInt a
     iSessions.push_back(aSession);                    // Can only throw std::bad_alloc. Don't bother to cleanup as we consider this
                                                     // a fatal exception anyway.
     try {
-        aSession->Add(*this, aName, iSessionPriority + aPriorityOffset, iSessionStackBytes);
+        const TUint listener = (TUint)(iSessions.size() - 1) % Listeners();
+        aSession->Add(*this, listener, aName, iSessionPriority + aPriorityOffset, iSessionStackBytes);
     }
     catch ( ... ) {                                 // Don't handle the exception per se, just perform cleanup and pass it on.
         iSessions.pop_back();
@@ -556,9 +914,12 @@ void SocketTcpServer::Add(const TChar* aName, SocketTcpSession* aSession, TInt a
     }
 }
 
-THandle SocketTcpServer::Accept(Endpoint& aClientEndpoint)
+THandle SocketTcpServer::Accept(Endpoint& aClientEndpoint, TUint aListener)
 {
-    LOGF(kNetwork, "SocketTcpServer::Accept\n");
+    LOGF(kNetwork, "SocketTcpServer::Accept L = %u\n", aListener);
+    if (aListener > 0) {
+        return iListeners[aListener-1]->AcceptSession(aClientEndpoint);
+    }
     AutoMutex a(iMutex);                        // wait to become the single accepting thread
     if (iTerminating)
         THROW(NetworkError);
@@ -579,16 +940,58 @@ SocketTcpServer::~SocketTcpServer()
 
     // cause exception in pending AND subsequent accept attempts in session threads.
     Interrupt(true);
+    for (TUint i = 0; i < iListeners.size(); i++) {
+        iListeners[i]->Interrupt(true);
+    }
     TUint count = (TUint)iSessions.size();
     for (TUint i = 0; i < count; i++) {             // delete all sessions
         iSessions[i]->Terminate();                    // Kill and Join the TcpSession thread
         delete iSessions[i];
     }
+    for (TUint i = 0; i < iListeners.size(); i++) {
+        delete iListeners[i];
+    }
 
     Close();
     LOGF(kNetwork, "<SocketTcpServer::~SocketTcpServer\n");
 }
 
+// SocketTcpServer::Listener
+
+SocketTcpServer::Listener::Listener(Environment& aEnv, SocketTcpServer& aServer, const TChar* aName, const Endpoint& aEndpoint, TUint aSlots)
+    : iServer(aServer)
+    , iMutex(aName)
+{
+    iHandle = SocketCreate(aEnv, eSocketTypeStream);
+    try {
+        OpenHome::Os::NetworkSocketSetReuseAddress(iHandle);
+        TryNetworkTcpSetNoDelay(iHandle);
+        if (!OpenHome::Os::NetworkSocketTrySetReusePort(iHandle)) {
+            THROW(NetworkError);
+        }
+        Bind(aEndpoint);
+        Listen(aSlots);
+    }
+    catch (NetworkError&) {
+        Close();
+        throw;
+    }
+}
+
+SocketTcpServer::Listener::~Listener()
+{
+    Close();
+}
+
+THandle SocketTcpServer::Listener::AcceptSession(Endpoint& aClientEndpoint)
+{
+    AutoMutex a(iMutex);
+    if (iServer.Terminating()) {
+        THROW(NetworkError);
+    }
+    return Accept(aClientEndpoint);
+}
+
 // Tcp Session
 
 SocketTcpSession::SocketTcpSession()
@@ -597,9 +1000,10 @@ SocketTcpSession::SocketTcpSession()
 }
 
 // Called when the session is added to a server
-void SocketTcpSession::Add(SocketTcpServer& aServer, const TChar* aName, TUint aPriority, TUint aStackBytes)
+void SocketTcpSession::Add(SocketTcpServer& aServer, TUint aListener, const TChar* aName, TUint aPriority, TUint aStackBytes)
 {
     iServer = &aServer;
+    iListener = aListener;
     iThread = new ThreadFunctor(aName, MakeFunctor(*this, &SocketTcpSession::Start), aPriority, aStackBytes);
     iThread->Start();
 }
@@ -610,7 +1014,7 @@ void SocketTcpSession::Start()
     LOGF(kNetwork, ">SocketTcpSession::Start()\n");
     for (;;) {
         try {
-            Open(iServer->Accept(iClientEndpoint));            // accept a connection for this session
+            Open(iServer->Accept(iClientEndpoint, iListener));            // accept a connection for this session
         } catch (NetworkError&) {                // server is being destroyed
             LOG2F(kNetwork, kError, "-SocketTcpSession::Start() Network Accept Exception\n");
             break;
@@ -722,6 +1126,12 @@ void SocketUdpBase::Send(const Brx& aBuffer, const Endpoint& aEndpoint)
     SendTo(aBuffer, aEndpoint);
 }
 
+void SocketUdpBase::SendBatch(const Brx* const aBuffers[], const Endpoint aEndpoints[], TUint aCount)
+{
+    LOGF(kNetwork, "> SocketUdpBase::SendBatch\n");
+    SendToBatch(aBuffers, aEndpoints, aCount);
+}
+
 Endpoint SocketUdpBase::Receive(Bwx& aBuffer)
 {
     LOGF(kNetwork, "> SocketUdpBase::Receive\n");
@@ -731,6 +1141,14 @@ Endpoint SocketUdpBase::Receive(Bwx& aBuffer)
     return endpoint;
 }
 
+TUint SocketUdpBase::ReceiveBatch(Bwx* const aBuffers[], Endpoint aSenders[], TUint aCount)
+{
+    LOGF(kNetwork, "> SocketUdpBase::ReceiveBatch\n");
+    const TUint count = ReceiveFromBatch(aBuffers, aSenders, aCount);
+    LOGF(kNetwork, "< SocketUdpBase::ReceiveBatch\n");
+    return count;
+}
+
 void SocketUdpBase::ReCreate()
 {
     Close();
@@ -892,6 +1310,62 @@ void UdpReader::ReadInterrupt()
     }
 }
 
+// UdpBatchReader
+
+UdpBatchReader::UdpBatchReader(SocketUdpBase& aSocket, TUint aMaxDatagramBytes)
+    : iSocket(aSocket)
+    , iCount(0)
+    , iIndex(0)
+    , iOpen(true)
+{
+    for (TUint i=0; i<kMaxDatagrams; i++) {
+        iDatagrams[i] = new Bwh(aMaxDatagramBytes);
+    }
+}
+
+UdpBatchReader::~UdpBatchReader()
+{
+    for (TUint i=0; i<kMaxDatagrams; i++) {
+        delete iDatagrams[i];
+    }
+}
+
+Endpoint UdpBatchReader::Sender() const
+{
+    return iSender;
+}
+
+void UdpBatchReader::Read(Bwx& aBuffer)
+{
+    if (!iOpen) {
+        THROW(ReaderError);
+    }
+    if (iIndex == iCount) {
+        iIndex = iCount = 0;
+        try {
+            iCount = iSocket.ReceiveBatch(iDatagrams, iSenders, kMaxDatagrams);
+        }
+        catch (NetworkError&) {
+            THROW(ReaderError);
+        }
+    }
+    const Brx& datagram = *iDatagrams[iIndex];
+    const TUint bytes = std::min(datagram.Bytes(), aBuffer.MaxBytes());
+    aBuffer.Replace(datagram.Ptr(), bytes);
+    iSender = iSenders[iIndex++];
+    iOpen = false;
+}
+
+void UdpBatchReader::ReadFlush()
+{
+    iOpen = true;
+}
+
+void UdpBatchReader::ReadInterrupt()
+{
+    iSocket.Interrupt(true);
+}
+
 // UdpWriter
 
 UdpWriter::UdpWriter(SocketUdpBase& aSocket, const Endpoint& aEndpoint)
@@ -926,3 +1400,76 @@ void UdpWriter::WriteFlush()
 {
     iOpen = true;
 }
+
+// UdpBatchWriter
+
+UdpBatchWriter::UdpBatchWriter(TUint aMaxDatagramBytes)
+    : iCount(0)
+{
+    for (TUint i=0; i<kMaxDatagrams; i++) {
+        iDatagrams[i] = new Bwh(aMaxDatagramBytes);
+    }
+}
+
+UdpBatchWriter::~UdpBatchWriter()
+{
+    for (TUint i=0; i<kMaxDatagrams; i++) {
+        delete iDatagrams[i];
+    }
+}
+
+TUint UdpBatchWriter::Count() const
+{
+    return iCount;
+}
+
+void UdpBatchWriter::Send(SocketUdpBase& aSocket, const Endpoint& aEndpoint)
+{
+    const Brx* buffers[kMaxDatagrams];
+    Endpoint endpoints[kMaxDatagrams];
+    const TUint count = iCount;
+    for (TUint i=0; i<count; i++) {
+        buffers[i] = iDatagrams[i];
+        endpoints[i] = aEndpoint;
+    }
+    if (count == 0) {
+        return;
+    }
+    try {
+        aSocket.SendBatch(buffers, endpoints, count);
+    }
+    catch (NetworkError&) {
+        Clear();
+        THROW(WriterError);
+    }
+    Clear();
+}
+
+void UdpBatchWriter::Clear()
+{
+    for (TUint i=0; i<=iCount && i<kMaxDatagrams; i++) {
+        iDatagrams[i]->SetBytes(0);
+    }
+    iCount = 0;
+}
+
+void UdpBatchWriter::Write(TByte aValue)
+{
+    if (iCount == kMaxDatagrams || !iDatagrams[iCount]->TryAppend(aValue)) {
+        THROW(WriterError);
+    }
+}
+
+void UdpBatchWriter::Write(const Brx& aBuffer)
+{
+    if (iCount == kMaxDatagrams || !iDatagrams[iCount]->TryAppend(aBuffer)) {
+        THROW(WriterError);
+    }
+}
+
+void UdpBatchWriter::WriteFlush()
+{
+    if (iCount < kMaxDatagrams && iDatagrams[iCount]->Bytes() > 0) {
+        iCount++;
+    }
+}
@@ -41,31 +41,48 @@ enum ESocketType
 class Endpoint
 {
 public:
-    static const TUint kMaxAddressBytes = 16;
-    static const TUint kMaxEndpointBytes = 22;
+    static const TUint kMaxAddressBytes = 16;            // IpV4 only
+    static const TUint kMaxEndpointBytes = 22;           // IpV4 only
+    static const TUint kMaxAddress6Bytes = 52;           // IpV6, including any "%<scope id>" suffix
+    static const TUint kMaxEndpoint6Bytes = kMaxAddress6Bytes + 8;
+    static const TUint kAddress6Bytes = 16;
     typedef Bws<kMaxAddressBytes> AddressBuf;
     typedef Bws<kMaxEndpointBytes> EndpointBuf;
+    typedef Bws<kMaxAddress6Bytes> Address6Buf;
+    typedef Bws<kMaxEndpoint6Bytes> Endpoint6Buf;
+    typedef TByte Address6[kAddress6Bytes];              // network byte order
 public:
     Endpoint();
-    Endpoint(TUint aPort, const Brx& aAddress);          // specify port, specify ip address from string e.g. "192.168.0.1"
+    Endpoint(TUint aPort, const Brx& aAddress);          // specify port, specify ip address from string e.g. "192.168.0.1" or "fe80::1%2"
     Endpoint(TUint aPort, TIpAddress aAddress);          // specify port, specify ip address from uint
+    Endpoint(TUint aPort, const Address6& aAddress, TUint32 aScopeId = 0);
     void SetPort(TUint aPort);                           // set port
     void SetPort(const Endpoint& aEndpoint);             // set port from other endpoint
     void SetAddress(const Brx& aAddress);                // set address from string e.g. "192.168.0.1"
     void SetAddress(TIpAddress aAddress);
     void SetAddress(const Endpoint& aEndpoint);          // set address from other endpoint
+    void SetAddress6(const Address6& aAddress, TUint32 aScopeId = 0); // IpV4-mapped addresses are stored as IpV4
     void Replace(const Endpoint& aEndpoint);             // set endpoint from other endpoint
     TBool Equals(const Endpoint& aEndpoint) const;       // test if this endpoint is equal to the specified endpoint
     inline TBool operator==(const Endpoint& aEndpoint) const { return Equals(aEndpoint); }
-    TIpAddress Address() const;
+    TIpAddress Address() const;                          // 0 for IpV6 endpoints
     TUint16 Port() const;                                // return port as a network order uint16
+    TBool IsV6() const;
+    void GetAddress6(Address6& aAddress) const;          // IpV4 addresses are returned IpV4-mapped
+    TUint32 ScopeId() const;                             // interface index of a link-local IpV6 address
     void AppendAddress(Bwx& aAddress) const;
     void AppendEndpoint(Bwx& aEndpoint) const;
     void GetAddressOctets(TByte (&aOctets)[4]) const;
     static void AppendAddress(Bwx& aAddressBuffer, TIpAddress aAddress);
+private:
+    static TBool TryParseAddress6(const Brx& aAddress, Address6& aBytes, TUint32& aScopeId);
+    void AppendAddress6(Bwx& aAddress) const;
 private:
     TIpAddress iAddress;
     TUint16 iPort;
+    TBool iV6;
+    TUint32 iScopeId;
+    Address6 iAddress6;
 };
 
 class Socket : public INonCopyable
@@ -82,10 +99,14 @@ protected:
     virtual ~Socket() {}
     TBool TryClose();
     void Send(const Brx& aBuffer);
+    void SendVector(const Brx* const aBuffers[], TUint aCount);
+    void SendFile(const TChar* aFilename, TUint aOffset, TUint aBytes);
     void SendTo(const Brx& aBuffer, const Endpoint& aEndpoint);
+    void SendToBatch(const Brx* const aBuffers[], const Endpoint aEndpoints[], TUint aCount);
     void Receive(Bwx& aBuffer);
     void Receive(Bwx& aBuffer, TUint aBytes);
     void ReceiveFrom(Bwx& aBuffer, Endpoint& aEndpoint);
+    TUint ReceiveFromBatch(Bwx* const aBuffers[], Endpoint aEndpoints[], TUint aCount);
     void Bind(const Endpoint& aEndpoint);
     void GetPort(TUint& aPort);
     void Listen(TUint aSlots);
@@ -151,6 +172,7 @@ public:
     void Write(TByte aValue);
     void Write(const Brx& aBuffer);
     void WriteFlush();
+    void WriteVector(const Brx* const aBuffers[], TUint aCount);
 
     // IReaderSource
     /**
@@ -190,7 +212,7 @@ protected:
     virtual ~SocketTcpSession();
     Endpoint ClientEndpoint() const;
 private:
-    void Add(SocketTcpServer& aServer, const TChar* aName, TUint aPriority, TUint aStackBytes);
+    void Add(SocketTcpServer& aServer, TUint aListener, const TChar* aName, TUint aPriority, TUint aStackBytes);
     void Start();
     void Open(THandle aHandle);
     void Close();
@@ -199,6 +221,7 @@ private:
     Mutex iMutex;
     TBool iOpen;
     SocketTcpServer* iServer;
+    TUint iListener;
     ThreadFunctor* iThread;
     Endpoint iClientEndpoint;
 };
@@ -211,21 +234,40 @@ class SocketTcpServer : public Socket
 public:
     SocketTcpServer(Environment& aEnv, const TChar* aName, TUint aPort, TIpAddress aInterface,
                     TUint aSessionPriority = kPriorityHigh, TUint aSessionStackBytes = Thread::kDefaultStackBytes,
-                    TUint aSlots = 128);
+                    TUint aSlots = 128, TUint aListeners = 1);
     // Add is not thread safe, but why would you want that?
+    // Sessions are shared round-robin between listeners.
     void Add(const TChar* aName, SocketTcpSession* aSession, TInt aPriorityOffset = 0);
     TUint Port() const { return iPort; }
     TIpAddress Interface() const { return iInterface; }
+    TUint Listeners() const { return (TUint)iListeners.size() + 1; } // may be less than requested if SO_REUSEPORT is unavailable
     ~SocketTcpServer(); // Closes the server
+private:
+    /**
+     * Additional listening socket bound to the server's port using SO_REUSEPORT.
+     * The OS spreads incoming connections between the server and its listeners,
+     * allowing sessions attached to different listeners to accept in parallel.
+     */
+    class Listener : public Socket
+    {
+    public:
+        Listener(Environment& aEnv, SocketTcpServer& aServer, const TChar* aName, const Endpoint& aEndpoint, TUint aSlots);
+        ~Listener();
+        THandle AcceptSession(Endpoint& aClientEndpoint);
+    private:
+        SocketTcpServer& iServer;
+        Mutex iMutex;               // allows one thread to accept from this listener at a time
+    };
 private:
     TBool Terminating();            // indicates server is in process of being destroyed
-    THandle Accept(Endpoint& aClientEndpoint); // accept a connection and return the session handle
+    THandle Accept(Endpoint& aClientEndpoint, TUint aListener); // accept a connection and return the session handle
 private:
     Mutex iMutex;                   // allows one thread to accept at a time
     TUint iSessionPriority;         // priority given to all session threads
     TUint iSessionStackBytes;       // stack bytes given to all session threads
     TBool iTerminating;
     std::vector<SocketTcpSession*> iSessions;
+    std::vector<Listener*> iListeners;
     TUint iPort;
     TIpAddress iInterface;
 };
@@ -237,7 +279,9 @@ class SocketUdpBase : public Socket
 public:
     void SetTtl(TUint aTtl);
     void Send(const Brx& aBuffer, const Endpoint& aEndpoint);
+    void SendBatch(const Brx* const aBuffers[], const Endpoint aEndpoints[], TUint aCount); // aBuffers[i] is sent to aEndpoints[i]
     Endpoint Receive(Bwx& aBuffer);
+    TUint ReceiveBatch(Bwx* const aBuffers[], Endpoint aSenders[], TUint aCount); // blocks for >=1 datagram; returns count received
     TUint Port() const;
     ~SocketUdpBase();
 protected:
@@ -298,6 +342,33 @@ private:
     TBool iOpen;
 };
 
+/**
+ * Alternative to UdpReader which fetches every datagram already queued on the socket
+ * (up to kMaxDatagrams) in a single system call.  Each Read() - ReadFlush() pair still
+ * consumes a single datagram.
+ */
+class UdpBatchReader : public IReaderSource, public INonCopyable
+{
+public:
+    static const TUint kMaxDatagrams = 16;
+public:
+    UdpBatchReader(SocketUdpBase& aSocket, TUint aMaxDatagramBytes);
+    ~UdpBatchReader();
+    Endpoint Sender() const; // sender of last completed Read()
+public: // from IReaderSource
+    void Read(Bwx& aBuffer);
+    void ReadFlush();
+    void ReadInterrupt();
+private:
+    SocketUdpBase& iSocket;
+    Bwx* iDatagrams[kMaxDatagrams];
+    Endpoint iSenders[kMaxDatagrams];
+    TUint iCount;
+    TUint iIndex;
+    Endpoint iSender;
+    TBool iOpen;
+};
+
 /**
  * Utility class which enforces the Write() - WriteFlush() useage pattern
  * This class may be useful to subclasses of SocketUdp or SocketUdpMulticast
@@ -315,6 +386,30 @@ private:
     TBool iOpen;
 };
 
+/**
+ * Queues complete datagrams (one per Write() - WriteFlush() sequence) so that several
+ * can be passed to SocketUdpBase::SendBatch() together.
+ * Throws WriterError if a datagram exceeds aMaxDatagramBytes or more than kMaxDatagrams are queued
+ */
+class UdpBatchWriter : public IWriter, public INonCopyable
+{
+public:
+    static const TUint kMaxDatagrams = 16;
+public:
+    UdpBatchWriter(TUint aMaxDatagramBytes);
+    ~UdpBatchWriter();
+    TUint Count() const; // number of complete datagrams queued
+    void Send(SocketUdpBase& aSocket, const Endpoint& aEndpoint); // sends then clears all queued datagrams
+    void Clear();        // discards all queued datagrams, including any partially written
+public: // from IWriter
+    void Write(TByte aValue);
+    void Write(const Brx& aBuffer);
+    void WriteFlush();
+private:
+    Bwh* iDatagrams[kMaxDatagrams];
+    TUint iCount;
+};
+
 } // namespace OpenHome
 
 #endif // HEADER_NETWORK
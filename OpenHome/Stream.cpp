@@ -531,22 +531,55 @@ void Swx::Write(const Brx& aBuffer)
 {
     TByte* ptr = Ptr();
     TUint bytes = aBuffer.Bytes();
-    if (iBytes + bytes > iMaxBytes) { // would overflow, drain the buffer
-        WriteDrain();
-        if (bytes > iMaxBytes) { // would still overflow
-            try {
-                iWriter.Write(aBuffer); // pass it on
-                return;
+    if (iBytes + bytes > iMaxBytes) { // would overflow, pass it on with the buffered data
+        try {
+            if (iBytes == 0) {
+                iWriter.Write(aBuffer);
             }
-            catch (WriterError&) {
-                Error();
+            else { // in one write if our writer supports it
+                Brn buffered(ptr, iBytes);
+                const Brx* buffers[] = { &buffered, &aBuffer };
+                iWriter.WriteVector(buffers, 2);
+                iBytes = 0;
             }
+            return;
+        }
+        catch (WriterError&) {
+            Error();
         }
     }
     memcpy(ptr + iBytes, aBuffer.Ptr(), bytes);
     iBytes += bytes;
 }
 
+void Swx::WriteVector(const Brx* const aBuffers[], TUint aCount)
+{
+    TUint bytes = 0;
+    for (TUint i=0; i<aCount; i++) {
+        bytes += aBuffers[i]->Bytes();
+    }
+    if (iBytes + bytes <= iMaxBytes || aCount > kMaxVectorBuffers) {
+        IWriter::WriteVector(aBuffers, aCount);
+        return;
+    }
+    Brn buffered(Ptr(), iBytes);
+    const Brx* buffers[kMaxVectorBuffers + 1];
+    TUint count = 0;
+    if (iBytes > 0) {
+        buffers[count++] = &buffered;
+    }
+    for (TUint i=0; i<aCount; i++) {
+        buffers[count++] = aBuffers[i];
+    }
+    try {
+        iWriter.WriteVector(buffers, count);
+        iBytes = 0;
+    }
+    catch (WriterError&) {
+        Error();
+    }
+}
+
 void Swx::WriteDrain()
 {
     if (iBytes) {
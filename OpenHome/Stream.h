@@ -35,9 +35,17 @@ public:
     virtual void Write(TByte aValue) = 0;
     virtual void Write(const Brx& aBuffer) = 0;
     virtual void WriteFlush() = 0;
+    virtual void WriteVector(const Brx* const aBuffers[], TUint aCount); // as Write() for each buffer in turn.  Override if they can be gathered into a single write
     virtual ~IWriter() {};
 };
 
+inline void IWriter::WriteVector(const Brx* const aBuffers[], TUint aCount)
+{
+    for (TUint i=0; i<aCount; i++) {
+        Write(*aBuffers[i]);
+    }
+}
+
 class Sxx : public INonCopyable
 {
     friend class Swp;
@@ -196,10 +204,12 @@ private:
 
 class Swx : public Sxx, public IWriter
 {
+    static const TUint kMaxVectorBuffers = 8;
 public: // from IWriter
     void Write(TByte aValue);
     void Write(const Brx& aBuffer);
     void WriteFlush();
+    void WriteVector(const Brx* const aBuffers[], TUint aCount);
 private:
     void WriteDrain();
 protected:
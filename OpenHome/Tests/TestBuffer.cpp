@@ -365,6 +365,25 @@ void SuiteHeap::Test()
     TEST(src.Ptr() == NULL);
     TEST(trg.Ptr() != NULL);
     }
+
+    {
+    // transferring to a Brhz only copies if there's no room for the nul terminator
+    Bwh src(8);
+    src.Append("stuff");
+    const TByte* ptr = src.Ptr();
+    Brhz trg;
+    src.TransferTo(trg);
+    TEST(src.Bytes() == 0);
+    TEST(src.Ptr() == NULL);
+    TEST(trg.Ptr() == ptr);
+    TEST(trg.Bytes() == 5);
+    TEST(strcmp(trg.CString(), "stuff") == 0);
+    Bwh full("qwerty");
+    full.TransferTo(trg);
+    TEST(full.Ptr() == NULL);
+    TEST(trg.Bytes() == 6);
+    TEST(strcmp(trg.CString(), "qwerty") == 0);
+    }
 }
 
 class SuiteSplit : public Suite
@@ -0,0 +1,132 @@
+#include <OpenHome/Private/TestFramework.h>
+#include <OpenHome/Private/Compression.h>
+#include <OpenHome/Private/Http.h>
+#include <OpenHome/Buffer.h>
+
+using namespace OpenHome;
+using namespace OpenHome::TestFramework;
+
+class SuiteCompression : public Suite
+{
+public:
+    SuiteCompression() : Suite("Test Compression") {}
+    void Test();
+private:
+    void TestRoundTrip(const Brx& aData, Compression::EFormat aFormat);
+};
+
+void SuiteCompression::TestRoundTrip(const Brx& aData, Compression::EFormat aFormat)
+{
+    Bwh compressed;
+    Bwh decompressed;
+    Compression::Compress(aData, compressed, aFormat);
+    TEST(compressed.Bytes() > 0);
+    Compression::Decompress(compressed, decompressed, aFormat);
+    TEST(decompressed == aData);
+}
+
+void SuiteCompression::Test()
+{
+    if (!Compression::Available()) {
+        // built without zlib
+        Bwh buf;
+        TEST_THROWS(Compression::Compress(Brn("some text"), buf, Compression::eGzip), CompressionError);
+        TEST_THROWS(Compression::Decompress(Brn("some text"), buf, Compression::eDeflate), CompressionError);
+        return;
+    }
+    const Compression::EFormat formats[] = { Compression::eGzip, Compression::eDeflate };
+    for (TUint i=0; i<sizeof(formats)/sizeof(formats[0]); i++) {
+        const Compression::EFormat format = formats[i];
+
+        // empty and tiny inputs
+        TestRoundTrip(Brx::Empty(), format);
+        TestRoundTrip(Brn("a"), format);
+
+        // repetitive text (as for device/service descriptions) should shrink considerably
+        Bwh xml(64 * 1024);
+        while (xml.Bytes() + 64 < xml.MaxBytes()) {
+            xml.Append("<stateVariable sendEvents=\"no\"><name>A_ARG_TYPE_");
+            xml.Append((TByte)('A' + (xml.Bytes() % 26)));
+            xml.Append("</name></stateVariable>");
+        }
+        TestRoundTrip(xml, format);
+        Bwh compressed;
+        Compression::Compress(xml, compressed, format);
+        TEST(compressed.Bytes() < xml.Bytes() / 4);
+
+        // incompressible data must survive too (it will be stored rather than huffman coded)
+        Bwh noise(100 * 1024);
+        TUint seed = 1;
+        while (noise.Bytes() < noise.MaxBytes()) {
+            seed = seed * 1103515245 + 12345;
+            noise.Append((TByte)(seed >> 16));
+        }
+        TestRoundTrip(noise, format);
+
+        // corrupt or truncated input
+        Bwh decompressed;
+        Bwh corrupt(compressed);
+        corrupt[corrupt.Bytes() / 2] ^= 0xff;
+        TEST_THROWS(Compression::Decompress(corrupt, decompressed, format), CompressionError);
+        Brn truncated(compressed.Ptr(), compressed.Bytes() / 2);
+        TEST_THROWS(Compression::Decompress(truncated, decompressed, format), CompressionError);
+    }
+
+    // formats aren't interchangeable
+    Bwh gzip;
+    Bwh decompressed;
+    Compression::Compress(Brn("some text"), gzip, Compression::eGzip);
+    TEST_THROWS(Compression::Decompress(gzip, decompressed, Compression::eDeflate), CompressionError);
+}
+
+class SuiteAcceptEncoding : public Suite
+{
+public:
+    SuiteAcceptEncoding() : Suite("Test Accept-Encoding") {}
+    void Test();
+private:
+    void Parse(const Brx& aValue);
+private:
+    HttpHeaderAcceptEncoding iHeader;
+};
+
+void SuiteAcceptEncoding::Parse(const Brx& aValue)
+{
+    IHttpHeader& header = iHeader;
+    header.Reset();
+    header.Process(aValue);
+}
+
+void SuiteAcceptEncoding::Test()
+{
+    TEST(!iHeader.Gzip());
+    TEST(!iHeader.Deflate());
+
+    Parse(Http::kAcceptEncodingGzipDeflate);
+    TEST(iHeader.Gzip());
+    TEST(iHeader.Deflate());
+
+    Parse(Brn("GZIP"));
+    TEST(iHeader.Gzip());
+    TEST(!iHeader.Deflate());
+
+    Parse(Brn("br, deflate;q=0.5"));
+    TEST(!iHeader.Gzip());
+    TEST(iHeader.Deflate());
+
+    Parse(Brn("gzip;q=0, deflate; q=0.000"));
+    TEST(!iHeader.Gzip());
+    TEST(!iHeader.Deflate());
+
+    Parse(Brn("identity"));
+    TEST(!iHeader.Gzip());
+    TEST(!iHeader.Deflate());
+}
+
+void TestCompression()
+{
+    Runner runner("Compression Testing\n");
+    runner.Add(new SuiteCompression());
+    runner.Add(new SuiteAcceptEncoding());
+    runner.Run();
+}
@@ -378,6 +378,39 @@ void TcpSessionTest::Run()
     }
 }
 
+class SuiteTcpServerListeners : public Suite, public INonCopyable
+{
+public:
+    SuiteTcpServerListeners(TIpAddress aInterface) : Suite("Tcp server with several listeners"), iInterface(aInterface) {}
+    void Test();
+private:
+    TIpAddress iInterface;
+};
+
+void SuiteTcpServerListeners::Test()
+{
+    static const TUint kListeners = 4;
+    SocketTcpServer server(*gEnv, "TSLX", 0, iInterface, kPriorityHigh, Thread::kDefaultStackBytes, 128, kListeners);
+    TEST(server.Listeners() == kListeners || server.Listeners() == 1); // 1 if the platform lacks SO_REUSEPORT
+    for (TUint i=0; i<server.Listeners(); i++) {
+        server.Add("TSLS", new TcpSessionEcho());
+    }
+
+    // every connection is served, whichever listener the OS hands it to
+    Bws<26> tx("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    const Endpoint endpoint(server.Port(), iInterface);
+    for (TUint i=0; i<4*kListeners; i++) {
+        SocketTcpClient client;
+        client.Open(*gEnv);
+        client.Connect(endpoint, 1000);
+        client.Write(tx);
+        Bws<26> rx;
+        client.Read(rx);
+        client.Close();
+        TEST(rx == tx);
+    }
+}
+
 class SuiteTcpServerShutdown : public Suite, public INonCopyable
 {
 public:
@@ -466,6 +499,13 @@ public:
     void Test();
 };
 
+static TBool Address6Formats(const TChar* aLiteral, const TChar* aExpected)
+{
+    Endpoint::Address6Buf buf;
+    Endpoint(0, Brn(aLiteral)).AppendAddress(buf);
+    return (buf == Brn(aExpected));
+}
+
 void SuiteEndpoint::Test()
 {
     // Test bad DNS look ups
@@ -487,6 +527,50 @@ void SuiteEndpoint::Test()
     TByte ip[4];
     ep.GetAddressOctets(ip);
     TEST((ip[0] == 127) && (ip[1] == 0) && (ip[2] == 0) && (ip[3] == 1));
+    TEST(!ep.IsV6());
+
+    // IpV6 literals, formatted as RFC 5952
+    Endpoint ep6(1900, Brn("FF02:0:0:0:0:0:0:C"));
+    TEST(ep6.IsV6());
+    TEST(ep6.Address() == 0);
+    Endpoint::Endpoint6Buf buf6;
+    ep6.AppendEndpoint(buf6);
+    TEST(buf6 == Brn("[ff02::c]:1900"));
+    TEST(ep6.Equals(Endpoint(1900, Brn("[ff02::c]"))));
+    TEST(!ep6.Equals(Endpoint(1901, Brn("ff02::c"))));
+    TEST(!ep6.Equals(Endpoint(1900, Brn("ff02::d"))));
+    TEST(Address6Formats("::", "::"));
+    TEST(Address6Formats("0:0:0:0:0:0:0:1", "::1"));
+    TEST(Address6Formats("2001:db8:0:0:1:0:0:1", "2001:db8::1:0:0:1"));
+    TEST(Address6Formats("2001:0db8:0:1:1:1:1:1", "2001:db8:0:1:1:1:1:1"));
+    TEST(Address6Formats("2001:db8::", "2001:db8::"));
+    TEST(Address6Formats("::1.2.3.4", "::102:304"));
+
+    // scope ids are kept and distinguish otherwise equal link-local addresses
+    Endpoint link(80, Brn("[fe80::1%3]"));
+    TEST(link.ScopeId() == 3);
+    buf6.SetBytes(0);
+    link.AppendEndpoint(buf6);
+    TEST(buf6 == Brn("[fe80::1%3]:80"));
+    TEST(!link.Equals(Endpoint(80, Brn("fe80::1%4"))));
+    Endpoint copy;
+    copy.Replace(link);
+    TEST(copy.Equals(link));
+
+    // IpV4-mapped addresses are held as IpV4
+    Endpoint mapped(80, Brn("::ffff:127.0.0.1"));
+    TEST(!mapped.IsV6());
+    TEST(mapped.Address() == Arch::BigEndian4(0x7F000001));
+    Endpoint::Address6 bytes;
+    mapped.GetAddress6(bytes);
+    TEST(Endpoint(80, bytes).Equals(mapped));
+    TEST(bytes[10] == 0xff && bytes[11] == 0xff && bytes[12] == 127 && bytes[15] == 1);
+
+    const TChar* bad[] = { ":", ":1::", "1:::2", "1::2::3", "12345::", "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7",
+                           "1:2:3:4:5:6:7:8::", "g::", "fe80::1%", "fe80::1%x", "::1.2.3.256", "::1.2.3", "1.2.3.4::" };
+    for (TUint i=0; i<sizeof(bad)/sizeof(bad[0]); i++) {
+        TEST_THROWS(ep.SetAddress(Brn(bad[i])), NetworkError);
+    }
 }
 
 const Brn kMulticastAddress("239.252.0.0");
@@ -704,6 +788,201 @@ void SuiteUnicast::Receiver()
     } while (val != kQuit);
 }
 
+class SuiteUdpBatch : public Suite
+{
+public:
+    SuiteUdpBatch(TIpAddress aInterface);
+    ~SuiteUdpBatch();
+private:
+    void Test();
+private:
+    static const TUint kMsgBytes = 64;
+    static const TUint kMsgCount = 20; // more than fit in a single batch
+private:
+    SocketUdp* iSender;
+    SocketUdp* iReceiver;
+    Endpoint iEndpoint;
+};
+
+SuiteUdpBatch::SuiteUdpBatch(TIpAddress aInterface)
+    : Suite("Udp batch send/receive")
+{
+    iReceiver = new SocketUdp(*gEnv, 0, aInterface);
+    iEndpoint = Endpoint(iReceiver->Port(), aInterface);
+    iSender = new SocketUdp(*gEnv, 0, aInterface);
+}
+
+SuiteUdpBatch::~SuiteUdpBatch()
+{
+    delete iSender;
+    delete iReceiver;
+}
+
+void SuiteUdpBatch::Test()
+{
+    Bws<kMsgBytes> msgs[kMsgCount];
+    const Brx* buffers[kMsgCount];
+    Endpoint endpoints[kMsgCount];
+    for (TUint i=0; i<kMsgCount; i++) {
+        for (TUint j=0; j<=i; j++) {
+            msgs[i].Append((TByte)i);
+        }
+        buffers[i] = &msgs[i];
+        endpoints[i] = iEndpoint;
+    }
+    iSender->SendBatch(buffers, endpoints, kMsgCount);
+
+    // every datagram is read separately, in order, with its length and sender intact
+    UdpBatchReader reader(*iReceiver, kMsgBytes);
+    Bws<kMsgBytes> buf;
+    for (TUint i=0; i<kMsgCount; i++) {
+        reader.Read(buf);
+        TEST(buf == msgs[i]);
+        TEST(reader.Sender().Port() == iSender->Port());
+        TEST_THROWS(reader.Read(buf), ReaderError);
+        reader.ReadFlush();
+    }
+
+    // datagrams written to a UdpBatchWriter are only sent together by Send()
+    UdpBatchWriter writer(kMsgBytes);
+    writer.Write(Brn("abc"));
+    writer.Write('d');
+    writer.WriteFlush();
+    writer.WriteFlush(); // empty datagrams aren't queued
+    writer.Write(Brn("efg"));
+    writer.WriteFlush();
+    TEST(writer.Count() == 2);
+    writer.Send(*iSender, iEndpoint);
+    TEST(writer.Count() == 0);
+    reader.Read(buf);
+    TEST(buf == Brn("abcd"));
+    reader.ReadFlush();
+    reader.Read(buf);
+    TEST(buf == Brn("efg"));
+    reader.ReadFlush();
+
+    // oversized datagrams and queue overflow are reported as WriterError
+    Bws<kMsgBytes+1> big;
+    big.SetBytes(big.MaxBytes());
+    TEST_THROWS(writer.Write(big), WriterError);
+    writer.Clear();
+    for (TUint i=0; i<UdpBatchWriter::kMaxDatagrams; i++) {
+        writer.Write(msgs[0]);
+        writer.WriteFlush();
+    }
+    TEST_THROWS(writer.Write(msgs[0]), WriterError);
+    writer.Clear();
+    TEST(writer.Count() == 0);
+}
+
+// SuiteSocketInterrupt
+
+class SuiteSocketInterrupt : public Suite
+{
+public:
+    SuiteSocketInterrupt(TIpAddress aInterface);
+    ~SuiteSocketInterrupt();
+private:
+    void Test();
+    void StartRead();
+    void ReadThread();
+    TBool ReadCompleted(TUint aTimeoutMs);
+private:
+    static const TUint kBlockedMs = 200;
+    static const TUint kTimeoutMs = 5000;
+    SocketUdp* iSender;
+    SocketUdp* iReceiver;
+    Endpoint iEndpoint;
+    ThreadFunctor* iReader;
+    Semaphore iReadDone;
+    TBool iInterrupted;
+    Bws<64> iBuf;
+};
+
+SuiteSocketInterrupt::SuiteSocketInterrupt(TIpAddress aInterface)
+    : Suite("Socket interrupt")
+    , iReadDone("SIRD", 0)
+    , iInterrupted(false)
+{
+    iReceiver = new SocketUdp(*gEnv, 0, aInterface);
+    iEndpoint = Endpoint(iReceiver->Port(), aInterface);
+    iSender = new SocketUdp(*gEnv, 0, aInterface);
+    iReader = new ThreadFunctor("SIRT", MakeFunctor(*this, &SuiteSocketInterrupt::ReadThread));
+    iReader->Start();
+}
+
+SuiteSocketInterrupt::~SuiteSocketInterrupt()
+{
+    iReceiver->Interrupt(true); // in case a failed test left a read blocked
+    delete iReader;
+    delete iSender;
+    delete iReceiver;
+}
+
+void SuiteSocketInterrupt::Test()
+{
+    // interrupting a blocked read
+    StartRead();
+    TEST(!ReadCompleted(kBlockedMs));
+    iReceiver->Interrupt(true);
+    TEST(ReadCompleted(kTimeoutMs));
+    TEST(iInterrupted);
+
+    // clearing the interrupt (even one signalled repeatedly) re-arms the socket so reads block again
+    iReceiver->Interrupt(true);
+    iReceiver->Interrupt(false);
+    StartRead();
+    TEST(!ReadCompleted(kBlockedMs));
+    iSender->Send(Brn("interrupt"), iEndpoint);
+    TEST(ReadCompleted(kTimeoutMs));
+    TEST(!iInterrupted);
+    TEST(iBuf == Brn("interrupt"));
+
+    // ...and can be interrupted again
+    StartRead();
+    TEST(!ReadCompleted(kBlockedMs));
+    iReceiver->Interrupt(true);
+    TEST(ReadCompleted(kTimeoutMs));
+    TEST(iInterrupted);
+    iReceiver->Interrupt(false);
+}
+
+void SuiteSocketInterrupt::StartRead()
+{
+    iInterrupted = false;
+    iBuf.SetBytes(0);
+    iReader->Signal();
+}
+
+void SuiteSocketInterrupt::ReadThread()
+{
+    try {
+        for (;;) {
+            iReader->Wait();
+            try {
+                (void)iReceiver->Receive(iBuf);
+            }
+            catch (NetworkError&) {
+                iInterrupted = true;
+            }
+            iReadDone.Signal();
+        }
+    }
+    catch (ThreadKill&) {
+    }
+}
+
+TBool SuiteSocketInterrupt::ReadCompleted(TUint aTimeoutMs)
+{
+    try {
+        iReadDone.Wait(aTimeoutMs);
+        return true;
+    }
+    catch (Timeout&) {
+        return false;
+    }
+}
+
 class MainNetworkTestThread : public Thread
 {
 public:
@@ -719,8 +998,11 @@ void MainNetworkTestThread::Run()
     Runner runner("Network System");
     runner.Add(new SuiteTcpClient(iInterface));
     runner.Add(new SuiteSocketServer(iInterface));
+    runner.Add(new SuiteTcpServerListeners(iInterface));
     runner.Add(new SuiteTcpServerShutdown(iInterface));
     runner.Add(new SuiteEndpoint());
+    runner.Add(new SuiteUdpBatch(iInterface));
+    runner.Add(new SuiteSocketInterrupt(iInterface));
     //runner.Add(new SuiteUnicast(iInterface));
     // SuiteMulticast disabled because Linn network setup means that each multicast message is duplicated when
     // running on a core server (used for automated post-commit tests)
@@ -1,5 +1,6 @@
 #include <OpenHome/Private/TestFramework.h>
 #include <OpenHome/Private/Stream.h>
+#include <OpenHome/Private/Http.h>
 #include <cstdarg>
 
 using namespace OpenHome;
@@ -305,11 +306,220 @@ void SuiteWriterRingBuffer::Test()
     }
 }
 
+class SuiteWriterHttpChunked : public Suite
+{
+public:
+    SuiteWriterHttpChunked() : Suite("Test WriterHttpChunked") {}
+    void Test();
+};
+
+void SuiteWriterHttpChunked::Test()
+{
+    WriterBwh writerBwh(64);
+    WriterHttpChunked writer(writerBwh);
+    writer.SetChunked(true);
+    writer.Write(Brn("Hello"));
+    writer.Write(Brx::Empty()); // mustn't terminate the body early
+    writer.Write(Brn(", world"));
+    writer.WriteFlush();
+    TEST(writerBwh.Buffer() == Brn("5\r\nHello\r\n7\r\n, world\r\n0\r\n\r\n"));
+
+    Bwh body;
+    ReaderBuffer readerBuffer(writerBwh.Buffer());
+    ReaderHttpChunked reader(readerBuffer);
+    reader.SetChunked(true);
+    for (;;) {
+        Brn buf = reader.Read(4);
+        if (buf.Bytes() == 0) {
+            break;
+        }
+        body.Grow(body.Bytes() + buf.Bytes());
+        body.Append(buf);
+    }
+    TEST(body == Brn("Hello, world"));
+
+    // bodies of unknown size are streamed; data is passed on as the buffer fills
+    writerBwh.Reset();
+    Bws<1024> block;
+    Bwh expected(64 * block.MaxBytes());
+    for (TUint i=0; i<64; i++) {
+        block.SetBytes(0);
+        for (TUint j=0; j<block.MaxBytes(); j++) {
+            block.Append((TByte)(i + j));
+        }
+        writer.Write(block);
+        expected.Append(block);
+    }
+    TEST(writerBwh.Buffer().Bytes() > 32 * block.Bytes());
+    writer.WriteFlush();
+
+    body.SetBytes(0);
+    ReaderBuffer readerStreamed(writerBwh.Buffer());
+    ReaderHttpChunked readerChunked(readerStreamed);
+    readerChunked.SetChunked(true);
+    for (;;) {
+        Brn buf = readerChunked.Read(1000);
+        if (buf.Bytes() == 0) {
+            break;
+        }
+        body.Grow(body.Bytes() + buf.Bytes());
+        body.Append(buf);
+    }
+    TEST(body == expected);
+}
+
+class SuiteHttpHeaderRange : public Suite
+{
+public:
+    SuiteHttpHeaderRange() : Suite("Test HttpHeaderRange") {}
+    void Test();
+private:
+    void Parse(const TChar* aValue);
+private:
+    HttpHeaderRange iHeader;
+};
+
+void SuiteHttpHeaderRange::Parse(const TChar* aValue)
+{
+    IHttpHeader& header = iHeader;
+    header.Reset();
+    header.Process(Brn(aValue));
+}
+
+void SuiteHttpHeaderRange::Test()
+{
+    TUint first = 0;
+    TUint bytes = 0;
+    Parse("bytes=0-99");
+    TEST(iHeader.Received());
+    TEST(iHeader.Resolve(1000, first, bytes));
+    TEST(first == 0 && bytes == 100);
+    TEST(iHeader.Resolve(50, first, bytes));
+    TEST(first == 0 && bytes == 50);
+
+    Parse("bytes=500-");
+    TEST(iHeader.Resolve(1000, first, bytes));
+    TEST(first == 500 && bytes == 500);
+    TEST(!iHeader.Resolve(500, first, bytes));
+
+    Parse("bytes=-100");
+    TEST(iHeader.Resolve(1000, first, bytes));
+    TEST(first == 900 && bytes == 100);
+    TEST(iHeader.Resolve(10, first, bytes));
+    TEST(first == 0 && bytes == 10);
+    Parse("bytes=-0");
+    TEST(!iHeader.Resolve(1000, first, bytes));
+
+    // unsupported or invalid ranges are ignored
+    Parse("bytes=0-1,5-6");
+    TEST(!iHeader.Received());
+    Parse("bytes=10-5");
+    TEST(!iHeader.Received());
+    Parse("bytes=-");
+    TEST(!iHeader.Received());
+    Parse("items=0-5");
+    TEST(!iHeader.Received());
+    Parse("bytes=a-5");
+    TEST(!iHeader.Received());
+}
+
+class WriterGatherCounter : public IWriter
+{
+public:
+    WriterGatherCounter() : iBuffer(64), iWrites(0), iVectorWrites(0) {}
+    const Brx& Buffer() const { return iBuffer.Buffer(); }
+    TUint Writes() const { return iWrites; }
+    TUint VectorWrites() const { return iVectorWrites; }
+public: // from IWriter
+    void Write(TByte aValue) { iWrites++; iBuffer.Write(aValue); }
+    void Write(const Brx& aBuffer) { iWrites++; iBuffer.Write(aBuffer); }
+    void WriteFlush() {}
+    void WriteVector(const Brx* const aBuffers[], TUint aCount)
+    {
+        iVectorWrites++;
+        for (TUint i=0; i<aCount; i++) {
+            iBuffer.Write(*aBuffers[i]);
+        }
+    }
+private:
+    WriterBwh iBuffer;
+    TUint iWrites;
+    TUint iVectorWrites;
+};
+
+class SuiteSwxVector : public Suite
+{
+public:
+    SuiteSwxVector() : Suite("Test Swx vectored writes") {}
+    void Test();
+};
+
+void SuiteSwxVector::Test()
+{
+    Bws<100> body;
+    body.Fill('b');
+    body.SetBytes(body.MaxBytes());
+
+    // buffered data and a write too large to buffer leave together
+    {
+        WriterGatherCounter counter;
+        Sws<64> sws(counter);
+        sws.Write(Brn("header"));
+        sws.Write(body);
+        TEST(counter.Writes() == 0);
+        TEST(counter.VectorWrites() == 1);
+        TEST(counter.Buffer().Bytes() == 6 + body.Bytes());
+        sws.WriteFlush();
+        TEST(counter.Buffer().Bytes() == 6 + body.Bytes());
+    }
+
+    // nothing buffered, so a large write is simply passed on
+    {
+        WriterGatherCounter counter;
+        Sws<64> sws(counter);
+        sws.Write(body);
+        TEST(counter.Writes() == 1);
+        TEST(counter.VectorWrites() == 0);
+    }
+
+    // vectors which fit are buffered; others are passed on with any buffered data
+    {
+        WriterGatherCounter counter;
+        Sws<64> sws(counter);
+        Brn a("abc");
+        Brn b("def");
+        const Brx* small[] = { &a, &b };
+        sws.WriteVector(small, 2);
+        TEST(counter.Buffer().Bytes() == 0);
+        const Brx* large[] = { &a, &body };
+        sws.WriteVector(large, 2);
+        TEST(counter.VectorWrites() == 1);
+        TEST(counter.Buffer().Bytes() == 6 + 3 + body.Bytes());
+        TEST(counter.Buffer().Split(0, 9) == Brn("abcdefabc"));
+    }
+
+    // chunked writer frames a vector as a single chunk
+    {
+        WriterBwh writerBwh(64);
+        WriterHttpChunked writer(writerBwh);
+        writer.SetChunked(true);
+        Brn a("Hello");
+        Brn b(", world");
+        const Brx* buffers[] = { &a, &b };
+        writer.WriteVector(buffers, 2);
+        writer.WriteFlush();
+        TEST(writerBwh.Buffer() == Brn("c\r\nHello, world\r\n0\r\n\r\n"));
+    }
+}
+
 void TestStream()
 {
     Runner runner("Stream Testing\n");
     runner.Add(new SuiteReaderBinary());
     runner.Add(new SuiteWriterBinary());
     runner.Add(new SuiteWriterRingBuffer());
+    runner.Add(new SuiteWriterHttpChunked());
+    runner.Add(new SuiteHttpHeaderRange());
+    runner.Add(new SuiteSwxVector());
     runner.Run();
 }
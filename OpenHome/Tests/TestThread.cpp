@@ -535,6 +535,61 @@ void SuiteMutex::Test()
     delete mutexTh;
 }
 
+class SuiteAtomic : public Suite
+{
+public:
+    SuiteAtomic() : Suite("Atomics") {}
+    void Test();
+};
+
+class AtomicThread : public Thread
+{
+public:
+    static const TUint kIterations = 100000;
+public:
+    AtomicThread(Atomic& aAtomic, Semaphore& aDone) : Thread("ATMT"), iAtomic(aAtomic), iDone(aDone) {}
+    void Run();
+private:
+    Atomic& iAtomic;
+    Semaphore& iDone;
+};
+
+void AtomicThread::Run()
+{
+    for (TUint i=0; i<kIterations; i++) {
+        (void)iAtomic.Add(1);
+    }
+    iDone.Signal();
+}
+
+void SuiteAtomic::Test()
+{
+    Atomic atomic;
+    TEST(atomic.Value() == 0);
+    TEST(atomic.Add(5) == 5);
+    TEST(atomic.Add(-7) == -2);
+    TEST(atomic.Exchange(3) == -2);
+    TEST(atomic.Value() == 3);
+
+    // updates from several threads must not be lost
+    (void)atomic.Exchange(0);
+    static const TUint kNumThreads = 4;
+    AtomicThread* threads[kNumThreads];
+    Semaphore done("ATMD", 0);
+    TUint i;
+    for (i=0; i<kNumThreads; i++) {
+        threads[i] = new AtomicThread(atomic, done);
+        threads[i]->Start();
+    }
+    for (i=0; i<kNumThreads; i++) {
+        done.Wait();
+    }
+    for (i=0; i<kNumThreads; i++) {
+        delete threads[i];
+    }
+    TEST(atomic.Value() == (TInt)(kNumThreads * AtomicThread::kIterations));
+}
+
 class SuitePerformance : public Suite
 {
 public:
@@ -998,6 +1053,7 @@ void MainTestThread::Run()
     Runner runner("Threading System");
     runner.Add(new SuiteSemaphore());
     runner.Add(new SuiteMutex());
+    runner.Add(new SuiteAtomic());
     runner.Add(new SuiteAutoMutex());
     runner.Add(new SuiteAutoSemaphore());
     if (iFull) {
@@ -97,6 +97,29 @@ void Mutex::Signal()
 }
 
 
+// Atomic
+
+Atomic::Atomic(TInt aValue)
+    : iValue(aValue)
+{
+}
+
+TInt Atomic::Add(TInt aDelta)
+{
+    return OpenHome::Os::AtomicAdd(&iValue, aDelta);
+}
+
+TInt Atomic::Exchange(TInt aValue)
+{
+    return OpenHome::Os::AtomicExchange(&iValue, aValue);
+}
+
+TInt Atomic::Value() const
+{
+    return OpenHome::Os::AtomicAdd(&iValue, 0);
+}
+
+
 // Thread
 
 const TUint OpenHome::Thread::kDefaultStackBytes = 32 * 1024;
@@ -67,6 +67,22 @@ private:
     TChar iName[5];
 };
 
+/**
+ * Integer which can be read and updated from several threads without a lock.
+ *
+ * All operations are full memory barriers.
+ */
+class Atomic : public INonCopyable
+{
+public:
+    Atomic(TInt aValue = 0);
+    TInt Add(TInt aDelta); // returns the updated value
+    TInt Exchange(TInt aValue); // returns the previous value
+    TInt Value() const;
+private:
+    mutable volatile TInt32 iValue;
+};
+
 /**
  * Abstract runnable thread class
  *
@@ -280,6 +280,30 @@ int32_t OsMutexLock(THandle aMutex);
  */
 int32_t OsMutexUnlock(THandle aMutex);
 
+/**
+ * Atomically add to a 32-bit value.
+ *
+ * Must act as a full memory barrier.
+ *
+ * @param[in] aValue      Value to update.
+ * @param[in] aDelta      Amount to add.  May be negative or 0.
+ *
+ * @return  the updated value
+ */
+int32_t OsAtomicAdd(volatile int32_t* aValue, int32_t aDelta);
+
+/**
+ * Atomically replace a 32-bit value.
+ *
+ * Must act as a full memory barrier.
+ *
+ * @param[in] aValue      Value to update.
+ * @param[in] aNewValue   Value to store.
+ *
+ * @return  the previous value
+ */
+int32_t OsAtomicExchange(volatile int32_t* aValue, int32_t aNewValue);
+
 /**
  * Pointer to a function which must be called from the native thread entrypoint
  *
@@ -438,6 +462,44 @@ int32_t OsNetworkConnect(THandle aHandle, TIpAddress aAddress, uint16_t aPort, u
  */
 int32_t OsNetworkSend(THandle aHandle, const uint8_t* aBuffer, uint32_t aBytes);
 
+/**
+ * Buffer passed to OsNetworkSendVector()
+ */
+typedef struct OsNetworkBuffer
+{
+    const uint8_t* iPtr;    /**< Data to send */
+    uint32_t       iBytes;  /**< Number of bytes of 'iPtr' to send */
+} OsNetworkBuffer;
+
+/**
+ * Send several buffers to the endpoint we're OsNetworkConnect()ed to
+ *
+ * This is equivalent to the BSD sendmsg() function, gathering all buffers into as few
+ * system calls (and TCP segments) as possible
+ *
+ * @param[in] aHandle      Socket handle returned from OsNetworkCreate()
+ * @param[in] aBuffers     Array of buffers to send, in order
+ * @param[in] aCount       Number of elements in 'aBuffers'
+ *
+ * @return  total number of bytes sent (>0) on success; -1 on failure
+ */
+int32_t OsNetworkSendVector(THandle aHandle, const OsNetworkBuffer* aBuffers, uint32_t aCount);
+
+/**
+ * Send part of a file to the endpoint we're OsNetworkConnect()ed to
+ *
+ * Implementations should use the kernel's sendfile() or equivalent where available,
+ * avoiding copying the file's data through user space.
+ *
+ * @param[in] aHandle      Socket handle returned from OsNetworkCreate()
+ * @param[in] aFilename    Path of the file to send
+ * @param[in] aOffset      Offset in bytes of the first byte to send
+ * @param[in] aBytes       Number of bytes to send
+ *
+ * @return  number of bytes sent (>=0) on success; -1 on failure
+ */
+int32_t OsNetworkSendFile(THandle aHandle, const char* aFilename, uint32_t aOffset, uint32_t aBytes);
+
 /**
  * Send data to the specified endpoint
  *
@@ -453,6 +515,32 @@ int32_t OsNetworkSend(THandle aHandle, const uint8_t* aBuffer, uint32_t aBytes);
  */
 int32_t OsNetworkSendTo(THandle aHandle, const uint8_t* aBuffer, uint32_t aBytes, TIpAddress aAddress, uint16_t aPort);
 
+/**
+ * Datagram passed to OsNetworkSendToBatch() or OsNetworkReceiveFromBatch()
+ */
+typedef struct OsNetworkDatagram
+{
+    uint8_t*   iPtr;        /**< Data to send or buffer to receive into */
+    uint32_t   iBytes;      /**< Bytes to send.  When receiving, capacity of 'iPtr' on entry
+                                 and bytes received on return */
+    TIpAddress iAddress;    /**< IpV4 address (in network byte order) to send to or received from */
+    uint16_t   iPort;       /**< Port [0..65535] to send to or received from */
+} OsNetworkDatagram;
+
+/**
+ * Send several datagrams, each to its own endpoint
+ *
+ * This is equivalent to the Linux sendmmsg() function.  Platforms without a batch
+ * send may implement it as repeated calls to OsNetworkSendTo()
+ *
+ * @param[in] aHandle      Socket handle returned from OsNetworkCreate()
+ * @param[in] aDatagrams   Array of datagrams to send, in order
+ * @param[in] aCount       Number of elements in 'aDatagrams'
+ *
+ * @return  number of datagrams sent (aCount on success); -1 if none could be sent
+ */
+int32_t OsNetworkSendToBatch(THandle aHandle, const OsNetworkDatagram* aDatagrams, uint32_t aCount);
+
 /**
  * Receive 0..aBytes of data from the endpoint we're OsNetworkConnect()ed to
  *
@@ -481,6 +569,22 @@ int32_t OsNetworkReceive(THandle aHandle, uint8_t* aBuffer, uint32_t aBytes);
  */
 int32_t OsNetworkReceiveFrom(THandle aHandle, uint8_t* aBuffer, uint32_t aBytes, TIpAddress* aAddress, uint16_t* aPort);
 
+/**
+ * Receive one or more datagrams, setting the sender's endpoint for each
+ *
+ * This is equivalent to the Linux recvmmsg() function.  Blocks until at least one
+ * datagram is available then returns any others already queued, up to aCount.
+ * Platforms without a batch receive may return a single datagram.
+ *
+ * @param[in]     aHandle     Socket handle returned from OsNetworkCreate()
+ * @param[in,out] aDatagrams  Array of datagrams to receive into.  iPtr and iBytes must be
+ *                            set by the caller; iBytes, iAddress and iPort are set on return
+ * @param[in]     aCount      Number of elements in 'aDatagrams'
+ *
+ * @return  number of datagrams received (1..aCount) on success; -1 on failure
+ */
+int32_t OsNetworkReceiveFromBatch(THandle aHandle, OsNetworkDatagram* aDatagrams, uint32_t aCount);
+
 /**
  * Stop a socket's send/receive operations, interrupting any pending request.
  *
@@ -595,6 +699,18 @@ int32_t OsNetworkTcpSetNoDelay(THandle aHandle);
  */
 int32_t OsNetworkSocketSetReuseAddress(THandle aHandle);
 
+/**
+ * Allow several listening sockets to bind the same address and port, with the OS
+ * distributing incoming connections between them (SO_REUSEPORT).
+ *
+ * Must be called on every such socket before it is bound.
+ *
+ * @param[in] aHandle      Socket handle returned from OsNetworkCreate()
+ *
+ * @return  0 on success; -1 on failure or if the platform doesn't support this
+ */
+int32_t OsNetworkSocketSetReusePort(THandle aHandle);
+
 /**
  * Set the ttl (time to live) value, affecting whether multicast datagrams are
  * forwarded beyond the local network
@@ -163,6 +163,11 @@ void OpenHome::Os::NetworkSocketSetReuseAddress(THandle aHandle)
     }
 }
 
+TBool OpenHome::Os::NetworkSocketTrySetReusePort(THandle aHandle)
+{
+    return (OsNetworkSocketSetReusePort(aHandle) == 0);
+}
+
 void OpenHome::Os::NetworkSocketSetMulticastTtl(THandle aHandle, TUint8 aTtl)
 {
     int32_t err = OsNetworkSocketSetMulticastTtl(aHandle, aTtl);
@@ -39,6 +39,8 @@ public:
     inline static void MutexDestroy(THandle aMutex);
     inline static TInt MutexLock(THandle aMutex);
     inline static void MutexUnlock(THandle aMutex);
+    inline static TInt AtomicAdd(volatile TInt32* aValue, TInt aDelta);
+    inline static TInt AtomicExchange(volatile TInt32* aValue, TInt aNewValue);
     static void ThreadGetPriorityRange(OsContext* aContext, TUint& aHostMin, TUint& aHostMax);
     inline static THandle ThreadCreate(OsContext* aContext, const TChar* aName, TUint aPriority,
                                        TUint aStackBytes, ThreadEntryPoint aEntryPoint, void* aArg);
@@ -52,9 +54,13 @@ public:
     static TInt NetworkPort(THandle aHandle, TUint& aPort);
     static void NetworkConnect(THandle aHandle, const Endpoint& aEndpoint, TUint aTimeoutMs);
     inline static TInt NetworkSend(THandle aHandle, const Brx& aBuffer);
+    inline static TInt NetworkSendVector(THandle aHandle, const OsNetworkBuffer* aBuffers, TUint aCount);
+    inline static TInt NetworkSendFile(THandle aHandle, const TChar* aFilename, TUint aOffset, TUint aBytes);
     inline static TInt NetworkSendTo(THandle aHandle, const Brx& aBuffer, const Endpoint& aEndpoint);
+    inline static TInt NetworkSendToBatch(THandle aHandle, const OsNetworkDatagram* aDatagrams, TUint aCount);
     inline static TInt NetworkReceive(THandle aHandle, Bwx& aBuffer);
     static TInt NetworkReceiveFrom(THandle aHandle, Bwx& aBuffer, Endpoint& aEndpoint);
+    inline static TInt NetworkReceiveFromBatch(THandle aHandle, OsNetworkDatagram* aDatagrams, TUint aCount);
     inline static TInt NetworkInterrupt(THandle aHandle, TBool aInterrupt);
     inline static TInt NetworkClose(THandle aHandle);
     inline static TInt NetworkListen(THandle aHandle, TUint aSlots);
@@ -65,6 +71,7 @@ public:
     static void NetworkSocketSetReceiveTimeout(THandle aHandle, TUint aMilliSeconds);
     static void NetworkTcpSetNoDelay(THandle aHandle);
     static void NetworkSocketSetReuseAddress(THandle aHandle);
+    static TBool NetworkSocketTrySetReusePort(THandle aHandle);
     static void NetworkSocketSetMulticastTtl(THandle aHandle, TUint8 aTtl);
     static void NetworkSocketMulticastAddMembership(THandle aHandle, TIpAddress aInterface, TIpAddress aAddrsss);
     static void NetworkSocketMulticastDropMembership(THandle aHandle, TIpAddress aInterface, TIpAddress aAddress);
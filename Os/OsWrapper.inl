@@ -58,6 +58,10 @@ inline void Os::MutexUnlock(THandle aMutex)
     int status = OsMutexUnlock(aMutex);
     ASSERT(status == 0);
 }
+inline TInt Os::AtomicAdd(volatile TInt32* aValue, TInt aDelta)
+{ return OsAtomicAdd(aValue, aDelta); }
+inline TInt Os::AtomicExchange(volatile TInt32* aValue, TInt aNewValue)
+{ return OsAtomicExchange(aValue, aNewValue); }
 inline THandle Os::ThreadCreate(OsContext* aContext, const TChar* aName, TUint aPriority,
                                 TUint aStackBytes, ThreadEntryPoint aEntryPoint, void* aArg)
 { return OsThreadCreate(aContext, aName, aPriority, aStackBytes, aEntryPoint, aArg); }
@@ -72,10 +76,18 @@ inline TBool Os::ThreadSupportsPriorities(OsContext* aContext)
 
 inline TInt Os::NetworkSend(THandle aHandle, const Brx& aBuffer)
 { return OsNetworkSend(aHandle, aBuffer.Ptr(), aBuffer.Bytes()); }
+inline TInt Os::NetworkSendVector(THandle aHandle, const OsNetworkBuffer* aBuffers, TUint aCount)
+{ return OsNetworkSendVector(aHandle, aBuffers, aCount); }
+inline TInt Os::NetworkSendFile(THandle aHandle, const TChar* aFilename, TUint aOffset, TUint aBytes)
+{ return OsNetworkSendFile(aHandle, aFilename, aOffset, aBytes); }
 inline TInt Os::NetworkSendTo(THandle aHandle, const Brx& aBuffer, const Endpoint& aEndpoint)
 { return OsNetworkSendTo(aHandle, aBuffer.Ptr(), aBuffer.Bytes(), aEndpoint.Address(), aEndpoint.Port()); }
+inline TInt Os::NetworkSendToBatch(THandle aHandle, const OsNetworkDatagram* aDatagrams, TUint aCount)
+{ return OsNetworkSendToBatch(aHandle, aDatagrams, aCount); }
 inline TInt Os::NetworkReceive(THandle aHandle, Bwx& aBuffer)
 { return OsNetworkReceive(aHandle, (uint8_t*)aBuffer.Ptr(), aBuffer.MaxBytes()); }
+inline TInt Os::NetworkReceiveFromBatch(THandle aHandle, OsNetworkDatagram* aDatagrams, TUint aCount)
+{ return OsNetworkReceiveFromBatch(aHandle, aDatagrams, aCount); }
 inline TInt Os::NetworkInterrupt(THandle aHandle, TBool aInterrupt)
 { return OsNetworkInterrupt(aHandle, (aInterrupt? 1:0)); }
 inline TInt Os::NetworkClose(THandle aHandle)
@@ -22,6 +22,7 @@
 #include <sys/types.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/ioctl.h>
 #include <net/if.h>
 #include <netinet/in.h>
@@ -29,6 +30,8 @@
 #if !defined(PLATFORM_MACOSX_GNU) && !defined(PLATFORM_FREEBSD)
 # include <linux/netlink.h>
 # include <linux/rtnetlink.h>
+# include <sys/sendfile.h>
+# include <sys/eventfd.h>
 #endif /* !PLATFORM_MACOSX_GNU && !PLATFORM_FREEBSD */
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -47,6 +50,15 @@
 #define kMinStackBytes (1024 * 512)
 #define kThreadSchedPolicy (SCHED_RR)
 #define kMaxThreadNameChars 16
+#define kMaxSendVectorBuffers 16
+#define kMaxBatchDatagrams 16
+
+#if !defined(PLATFORM_MACOSX_GNU) && !defined(PLATFORM_FREEBSD) && (!defined(__ANDROID__) || __ANDROID_API__ >= 21)
+# define USE_MMSG /* sendmmsg() and recvmmsg() available */
+#endif
+#if !defined(PLATFORM_MACOSX_GNU) && !defined(PLATFORM_FREEBSD)
+# define USE_EVENTFD /* wake interrupted sockets using an eventfd rather than a pipe */
+#endif
 
 #define TEMP_FAILURE_RETRY_2(expression, handle)                            \
     (__extension__                                                          \
@@ -463,6 +475,24 @@ int32_t OsMutexUnlock(THandle aMutex)
     return (status==0? 0 : -1);
 }
 
+int32_t OsAtomicAdd(volatile int32_t* aValue, int32_t aDelta)
+{
+    return __sync_add_and_fetch(aValue, aDelta);
+}
+
+int32_t OsAtomicExchange(volatile int32_t* aValue, int32_t aNewValue)
+{
+    /* __sync_lock_test_and_set is only an acquire barrier so use compare-and-swap instead */
+    int32_t prev = *aValue;
+    for (;;) {
+        const int32_t actual = __sync_val_compare_and_swap(aValue, prev, aNewValue);
+        if (actual == prev) {
+            return prev;
+        }
+        prev = actual;
+    }
+}
+
 void OsThreadGetPriorityRange(OsContext* aContext, uint32_t* aHostMin, uint32_t* aHostMax)
 {
     // FIXME - 50/150 copied from previous expectations of threadEntrypoint
@@ -616,17 +646,15 @@ int32_t OsThreadSupportsPriorities(OsContext* aContext)
 typedef struct OsNetworkHandle
 {
     int32_t    iSocket;
-    int32_t    iPipe[2];
+    int32_t    iWakeRead;   /* selected alongside iSocket; readable when interrupted */
+    int32_t    iWakeWrite;  /* same fd as iWakeRead when USE_EVENTFD */
     int32_t    iInterrupted;
     OsContext* iCtx;
 }OsNetworkHandle;
 
 static int nfds(const OsNetworkHandle* aHandle)
 {
-    int nfds = aHandle->iPipe[1];
-    if (aHandle->iPipe[0] > nfds) {
-        nfds = aHandle->iPipe[0];
-    }
+    int nfds = aHandle->iWakeRead;
     if (aHandle->iSocket > nfds) {
         nfds = aHandle->iSocket;
     }
@@ -664,6 +692,57 @@ static void sockaddrFromEndpoint(struct sockaddr_in* aAddr, TIpAddress aAddress,
     aAddr->sin_addr.s_addr = aAddress;
 }
 
+static int32_t CreateWakeup(OsNetworkHandle* aHandle)
+{
+#ifdef USE_EVENTFD
+    aHandle->iWakeRead = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    aHandle->iWakeWrite = aHandle->iWakeRead;
+    return aHandle->iWakeRead;
+#else
+    int32_t fds[2];
+    if (pipe(fds) == -1) {
+        return -1;
+    }
+    SetFdNonBlocking(fds[0]);
+    aHandle->iWakeRead = fds[0];
+    aHandle->iWakeWrite = fds[1];
+    return 0;
+#endif /* USE_EVENTFD */
+}
+
+static int32_t SignalWakeup(OsNetworkHandle* aHandle)
+{
+#ifdef USE_EVENTFD
+    uint64_t val = 1;
+#else
+    int32_t val = 1;
+#endif /* USE_EVENTFD */
+    return (TEMP_FAILURE_RETRY(write(aHandle->iWakeWrite, &val, sizeof(val))) == -1? -1 : 0);
+}
+
+static void ClearWakeup(OsNetworkHandle* aHandle)
+{
+#ifdef USE_EVENTFD
+    /* a single read resets an eventfd's counter */
+    uint64_t val;
+    (void)TEMP_FAILURE_RETRY(read(aHandle->iWakeRead, &val, sizeof(val)));
+#else
+    int32_t val;
+    while (TEMP_FAILURE_RETRY(read(aHandle->iWakeRead, &val, sizeof(val))) > 0) {
+        ;
+    }
+#endif /* USE_EVENTFD */
+}
+
+static int32_t CloseWakeup(OsNetworkHandle* aHandle)
+{
+    int32_t err = close(aHandle->iWakeRead);
+    if (aHandle->iWakeWrite != aHandle->iWakeRead) {
+        err |= close(aHandle->iWakeWrite);
+    }
+    return err;
+}
+
 static OsNetworkHandle* CreateHandle(OsContext* aContext, int32_t aSocket)
 {
     OsNetworkHandle* handle = (OsNetworkHandle*)malloc(sizeof(OsNetworkHandle));
@@ -674,11 +753,10 @@ static OsNetworkHandle* CreateHandle(OsContext* aContext, int32_t aSocket)
     if (handle == NULL) {
         return kHandleNull;
     }
-    if (pipe(handle->iPipe) == -1) {
+    if (CreateWakeup(handle) == -1) {
         free(handle);
         return kHandleNull;
     }
-    SetFdNonBlocking(handle->iPipe[0]);
     handle->iSocket = aSocket;
     assert(aSocket >= 0 && aSocket < MAX_FILE_DESCRIPTOR);
     handle->iInterrupted = 0;
@@ -755,7 +833,7 @@ int32_t OsNetworkConnect(THandle aHandle, TIpAddress aAddress, uint16_t aPort, u
 
     fd_set read;
     FD_ZERO(&read);
-    FD_SET(handle->iPipe[0], &read);
+    FD_SET(handle->iWakeRead, &read);
     fd_set write;
     FD_ZERO(&write);
     FD_SET(handle->iSocket, &write);
@@ -798,6 +876,118 @@ int32_t OsNetworkSend(THandle aHandle, const uint8_t* aBuffer, uint32_t aBytes)
     return sent;
 }
 
+int32_t OsNetworkSendVector(THandle aHandle, const OsNetworkBuffer* aBuffers, uint32_t aCount)
+{
+    OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
+    if (SocketInterrupted(handle)) {
+        return -1;
+    }
+    struct iovec iov[kMaxSendVectorBuffers];
+    uint32_t i = 0;
+    int32_t sent = 0;
+    while (i < aCount) {
+        /* gather as many buffers as fit in iov[], skipping any already sent */
+        uint32_t count = 0;
+        for (; i < aCount && count < kMaxSendVectorBuffers; i++) {
+            if (aBuffers[i].iBytes > 0) {
+                iov[count].iov_base = (void*)aBuffers[i].iPtr;
+                iov[count].iov_len = aBuffers[i].iBytes;
+                count++;
+            }
+        }
+        uint32_t first = 0;
+        while (first < count) {
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = &iov[first];
+            msg.msg_iovlen = count - first;
+            int32_t bytes = TEMP_FAILURE_RETRY_2(sendmsg(handle->iSocket, &msg, MSG_NOSIGNAL), handle);
+            if (bytes == -1) {
+                return sent;
+            }
+            sent += bytes;
+            /* advance past whatever the kernel accepted */
+            while (first < count && (size_t)bytes >= iov[first].iov_len) {
+                bytes -= (int32_t)iov[first].iov_len;
+                first++;
+            }
+            if (first < count) {
+                iov[first].iov_base = (uint8_t*)iov[first].iov_base + bytes;
+                iov[first].iov_len -= bytes;
+            }
+        }
+    }
+    return sent;
+}
+
+static int32_t SendFileCopy(OsNetworkHandle* aHandle, int aFd, uint32_t aOffset, uint32_t aBytes)
+{
+    uint8_t buf[8 * 1024];
+    int32_t sent = 0;
+    while (sent < (int32_t)aBytes) {
+        uint32_t len = aBytes - sent;
+        if (len > sizeof(buf)) {
+            len = sizeof(buf);
+        }
+        int32_t bytes = TEMP_FAILURE_RETRY(pread(aFd, buf, len, (off_t)(aOffset + sent)));
+        if (bytes <= 0) {
+            break;
+        }
+        int32_t written = OsNetworkSend(aHandle, buf, bytes);
+        if (written > 0) {
+            sent += written;
+        }
+        if (written != bytes) {
+            break;
+        }
+    }
+    return sent;
+}
+
+int32_t OsNetworkSendFile(THandle aHandle, const char* aFilename, uint32_t aOffset, uint32_t aBytes)
+{
+    OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
+    if (SocketInterrupted(handle)) {
+        return -1;
+    }
+    int fd = open(aFilename, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    int32_t sent = 0;
+#if !defined(PLATFORM_MACOSX_GNU) && !defined(PLATFORM_FREEBSD)
+    /* sendfile() can't be passed MSG_NOSIGNAL so block SIGPIPE for this thread instead,
+       discarding any raised because the peer has gone away */
+    sigset_t pipeMask;
+    sigset_t oldMask;
+    sigemptyset(&pipeMask);
+    sigaddset(&pipeMask, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeMask, &oldMask);
+    off_t offset = (off_t)aOffset;
+    int32_t bytes = 0;
+    do {
+        bytes = TEMP_FAILURE_RETRY_2(sendfile(handle->iSocket, fd, &offset, aBytes-sent), handle);
+        if (bytes > 0) {
+            sent += bytes;
+        }
+    } while (bytes > 0 && sent < (int32_t)aBytes);
+    const int err = errno;
+    if (bytes == -1 && err == EPIPE && !sigismember(&oldMask, SIGPIPE)) {
+        struct timespec zero = { 0, 0 };
+        (void)sigtimedwait(&pipeMask, NULL, &zero);
+    }
+    pthread_sigmask(SIG_SETMASK, &oldMask, NULL);
+    if (bytes == -1 && sent == 0 && (err == EINVAL || err == ENOSYS)) {
+        /* file or socket type doesn't support sendfile() */
+        sent = SendFileCopy(handle, fd, aOffset, aBytes);
+    }
+#else
+    sent = SendFileCopy(handle, fd, aOffset, aBytes);
+#endif
+    close(fd);
+    return sent;
+}
+
 int32_t OsNetworkSendTo(THandle aHandle, const uint8_t* aBuffer, uint32_t aBytes, TIpAddress aAddress, uint16_t aPort)
 {
     OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
@@ -817,6 +1007,51 @@ int32_t OsNetworkSendTo(THandle aHandle, const uint8_t* aBuffer, uint32_t aBytes
     return sent;
 }
 
+int32_t OsNetworkSendToBatch(THandle aHandle, const OsNetworkDatagram* aDatagrams, uint32_t aCount)
+{
+    OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
+    if (SocketInterrupted(handle)) {
+        return -1;
+    }
+    uint32_t sent = 0;
+#ifdef USE_MMSG
+    struct mmsghdr msgs[kMaxBatchDatagrams];
+    struct iovec iov[kMaxBatchDatagrams];
+    struct sockaddr_in addrs[kMaxBatchDatagrams];
+    while (sent < aCount) {
+        uint32_t count = aCount - sent;
+        if (count > kMaxBatchDatagrams) {
+            count = kMaxBatchDatagrams;
+        }
+        memset(msgs, 0, count * sizeof(msgs[0]));
+        uint32_t i;
+        for (i=0; i<count; i++) {
+            const OsNetworkDatagram* datagram = &aDatagrams[sent + i];
+            sockaddrFromEndpoint(&addrs[i], datagram->iAddress, datagram->iPort);
+            iov[i].iov_base = datagram->iPtr;
+            iov[i].iov_len = datagram->iBytes;
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int32_t ret = TEMP_FAILURE_RETRY_2(sendmmsg(handle->iSocket, msgs, count, MSG_NOSIGNAL), handle);
+        if (ret <= 0) {
+            break;
+        }
+        sent += ret;
+    }
+#else
+    for (; sent < aCount; sent++) {
+        const OsNetworkDatagram* datagram = &aDatagrams[sent];
+        if (OsNetworkSendTo(aHandle, datagram->iPtr, datagram->iBytes, datagram->iAddress, datagram->iPort) != (int32_t)datagram->iBytes) {
+            break;
+        }
+    }
+#endif /* USE_MMSG */
+    return (sent == 0 && aCount > 0? -1 : (int32_t)sent);
+}
+
 int32_t OsNetworkReceive(THandle aHandle, uint8_t* aBuffer, uint32_t aBytes)
 {
     OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
@@ -827,7 +1062,7 @@ int32_t OsNetworkReceive(THandle aHandle, uint8_t* aBuffer, uint32_t aBytes)
 
     fd_set read;
     FD_ZERO(&read);
-    FD_SET(handle->iPipe[0], &read);
+    FD_SET(handle->iWakeRead, &read);
     FD_SET(handle->iSocket, &read);
     fd_set error;
     FD_ZERO(&error);
@@ -859,7 +1094,7 @@ int32_t OsNetworkReceiveFrom(THandle aHandle, uint8_t* aBuffer, uint32_t aBytes,
 
     fd_set read;
     FD_ZERO(&read);
-    FD_SET(handle->iPipe[0], &read);
+    FD_SET(handle->iWakeRead, &read);
     FD_SET(handle->iSocket, &read);
     fd_set error;
     FD_ZERO(&error);
@@ -878,6 +1113,78 @@ int32_t OsNetworkReceiveFrom(THandle aHandle, uint8_t* aBuffer, uint32_t aBytes,
     return received;
 }
 
+#ifdef USE_MMSG
+static int32_t ReceiveFromBatch(OsNetworkHandle* aHandle, OsNetworkDatagram* aDatagrams, uint32_t aCount)
+{
+    struct mmsghdr msgs[kMaxBatchDatagrams];
+    struct iovec iov[kMaxBatchDatagrams];
+    struct sockaddr_in addrs[kMaxBatchDatagrams];
+    if (aCount > kMaxBatchDatagrams) {
+        aCount = kMaxBatchDatagrams;
+    }
+    memset(msgs, 0, aCount * sizeof(msgs[0]));
+    uint32_t i;
+    for (i=0; i<aCount; i++) {
+        iov[i].iov_base = aDatagrams[i].iPtr;
+        iov[i].iov_len = aDatagrams[i].iBytes;
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int32_t received = TEMP_FAILURE_RETRY_2(recvmmsg(aHandle->iSocket, msgs, aCount, MSG_DONTWAIT, NULL), aHandle);
+    for (i=0; received > 0 && i<(uint32_t)received; i++) {
+        aDatagrams[i].iBytes = msgs[i].msg_len;
+        aDatagrams[i].iAddress = addrs[i].sin_addr.s_addr;
+        aDatagrams[i].iPort = ntohs(addrs[i].sin_port);
+    }
+    return received;
+}
+#else
+static int32_t ReceiveFromBatch(OsNetworkHandle* aHandle, OsNetworkDatagram* aDatagrams, uint32_t aCount)
+{
+    uint32_t i;
+    for (i=0; i<aCount; i++) {
+        struct sockaddr_in addr;
+        socklen_t addrLen = sizeof(addr);
+        int32_t bytes = TEMP_FAILURE_RETRY_2(recvfrom(aHandle->iSocket, aDatagrams[i].iPtr, aDatagrams[i].iBytes, MSG_DONTWAIT, (struct sockaddr*)&addr, &addrLen), aHandle);
+        if (bytes == -1) {
+            break;
+        }
+        aDatagrams[i].iBytes = bytes;
+        aDatagrams[i].iAddress = addr.sin_addr.s_addr;
+        aDatagrams[i].iPort = ntohs(addr.sin_port);
+    }
+    return (i == 0? -1 : (int32_t)i);
+}
+#endif /* USE_MMSG */
+
+int32_t OsNetworkReceiveFromBatch(THandle aHandle, OsNetworkDatagram* aDatagrams, uint32_t aCount)
+{
+    OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
+    if (SocketInterrupted(handle)) {
+        return -1;
+    }
+
+    fd_set read;
+    FD_ZERO(&read);
+    FD_SET(handle->iWakeRead, &read);
+    FD_SET(handle->iSocket, &read);
+    fd_set error;
+    FD_ZERO(&error);
+    FD_SET(handle->iSocket, &error);
+
+    /* MSG_DONTWAIT avoids toggling the socket's blocking mode for every batch */
+    int32_t received = ReceiveFromBatch(handle, aDatagrams, aCount);
+    if (received==-1 && errno==EWOULDBLOCK) {
+        int32_t selectErr = TEMP_FAILURE_RETRY_2(select(nfds(handle), &read, NULL, &error, NULL), handle);
+        if (selectErr > 0 && FD_ISSET(handle->iSocket, &read)) {
+            received = ReceiveFromBatch(handle, aDatagrams, aCount);
+        }
+    }
+    return received;
+}
+
 int32_t OsNetworkInterrupt(THandle aHandle, int32_t aInterrupt)
 {
     int32_t err = 0;
@@ -885,16 +1192,11 @@ int32_t OsNetworkInterrupt(THandle aHandle, int32_t aInterrupt)
     OsContext* ctx = handle->iCtx;
     OsMutexLock(ctx->iMutex);
     handle->iInterrupted = aInterrupt;
-    int32_t val = 1;
     if (aInterrupt != 0) {
-        if (TEMP_FAILURE_RETRY(write(handle->iPipe[1], &val, sizeof(val))) == -1) {
-            err = -1;
-        }
+        err = SignalWakeup(handle);
     }
     else {
-        while (TEMP_FAILURE_RETRY(read(handle->iPipe[0], &val, sizeof(val))) > 0) {
-            ;
-        }
+        ClearWakeup(handle);
     }
     OsMutexUnlock(ctx->iMutex);
     return err;
@@ -906,8 +1208,7 @@ int32_t OsNetworkClose(THandle aHandle)
     int32_t err = 0;
     if (handle != NULL) {
         err  = close(handle->iSocket);
-        err |= close(handle->iPipe[0]);
-        err |= close(handle->iPipe[1]);
+        err |= CloseWakeup(handle);
         free(handle);
     }
     return err;
@@ -939,7 +1240,7 @@ THandle OsNetworkAccept(THandle aHandle, TIpAddress* aClientAddress, uint32_t* a
 
     fd_set read;
     FD_ZERO(&read);
-    FD_SET(handle->iPipe[0], &read);
+    FD_SET(handle->iWakeRead, &read);
     FD_SET(handle->iSocket, &read);
     fd_set error;
     FD_ZERO(&error);
@@ -1032,6 +1333,19 @@ int32_t OsNetworkSocketSetReuseAddress(THandle aHandle)
     return err;
 }
 
+int32_t OsNetworkSocketSetReusePort(THandle aHandle)
+{
+#if defined(SO_REUSEPORT) && !defined(PLATFORM_MACOSX_GNU)
+    /* Mac sets SO_REUSEPORT on all reusable sockets but doesn't balance connections between them */
+    OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
+    int32_t reuseport = 1;
+    return setsockopt(handle->iSocket, SOL_SOCKET, SO_REUSEPORT, &reuseport, sizeof(reuseport));
+#else
+    (void)aHandle;
+    return -1;
+#endif
+}
+
 int32_t OsNetworkSocketSetMulticastTtl(THandle aHandle, uint8_t aTtl)
 {
     OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
@@ -1314,7 +1628,7 @@ void adapterChangeObserverThread(void* aPtr)
         }
 
         FD_ZERO(&rfds);
-        FD_SET(handle->iPipe[0], &rfds);
+        FD_SET(handle->iWakeRead, &rfds);
         FD_SET(handle->iSocket, &rfds);
 
         FD_ZERO(&errfds);
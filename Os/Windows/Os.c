@@ -424,6 +424,16 @@ int32_t OsMutexUnlock(THandle aMutex)
     return 0;
 }
 
+int32_t OsAtomicAdd(volatile int32_t* aValue, int32_t aDelta)
+{
+    return InterlockedExchangeAdd((volatile LONG*)aValue, aDelta) + aDelta;
+}
+
+int32_t OsAtomicExchange(volatile int32_t* aValue, int32_t aNewValue)
+{
+    return InterlockedExchange((volatile LONG*)aValue, aNewValue);
+}
+
 typedef struct
 {
     HANDLE           iThread;
@@ -701,6 +711,80 @@ int32_t OsNetworkSend(THandle aHandle, const uint8_t* aBuffer, uint32_t aBytes)
     return sent;
 }
 
+int32_t OsNetworkSendVector(THandle aHandle, const OsNetworkBuffer* aBuffers, uint32_t aCount)
+{
+    WSABUF bufs[16];
+    uint32_t i = 0;
+    int32_t sent = 0;
+    OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
+    if (SocketInterrupted(handle)) {
+        return -1;
+    }
+    while (i < aCount) {
+        DWORD count = 0;
+        DWORD bytes = 0;
+        DWORD total = 0;
+        for (; i < aCount && count < sizeof(bufs)/sizeof(bufs[0]); i++) {
+            if (aBuffers[i].iBytes > 0) {
+                bufs[count].buf = (char*)aBuffers[i].iPtr;
+                bufs[count].len = aBuffers[i].iBytes;
+                total += aBuffers[i].iBytes;
+                count++;
+            }
+        }
+        if (count == 0) {
+            break;
+        }
+        /* blocking WSASend only completes once all data has been sent */
+        if (WSASend(handle->iSocket, bufs, count, &bytes, 0, NULL, NULL) != 0) {
+            return sent;
+        }
+        sent += bytes;
+        if (bytes != total) {
+            break;
+        }
+    }
+    return sent;
+}
+
+int32_t OsNetworkSendFile(THandle aHandle, const char* aFilename, uint32_t aOffset, uint32_t aBytes)
+{
+    /* TransmitFile would avoid the copy but needs Mswsock; read the file through a buffer instead */
+    uint8_t buf[8 * 1024];
+    int32_t sent = 0;
+    FILE* file;
+    OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;
+    if (SocketInterrupted(handle)) {
+        return -1;
+    }
+    if (fopen_s(&file, aFilename, "rb") != 0) {
+        return -1;
+    }
+    if (_fseeki64(file, aOffset, SEEK_SET) == 0) {
+        while (sent < (int32_t)aBytes) {
+            uint32_t len = aBytes - sent;
+            size_t bytes;
+            int32_t written;
+            if (len > sizeof(buf)) {
+                len = sizeof(buf);
+            }
+            bytes = fread(buf, 1, len, file);
+            if (bytes == 0) {
+                break;
+            }
+            written = OsNetworkSend(aHandle, buf, (uint32_t)bytes);
+            if (written > 0) {
+                sent += written;
+            }
+            if (written != (int32_t)bytes) {
+                break;
+            }
+        }
+    }
+    fclose(file);
+    return sent;
+}
+
 int32_t OsNetworkSendTo(THandle aHandle, const uint8_t* aBuffer, uint32_t aBytes, TIpAddress aAddress, uint16_t aPort)
 {
     int32_t sent = 0;
@@ -720,6 +804,18 @@ int32_t OsNetworkSendTo(THandle aHandle, const uint8_t* aBuffer, uint32_t aBytes
     return sent;
 }
 
+int32_t OsNetworkSendToBatch(THandle aHandle, const OsNetworkDatagram* aDatagrams, uint32_t aCount)
+{
+    uint32_t sent;
+    for (sent=0; sent<aCount; sent++) {
+        const OsNetworkDatagram* datagram = &aDatagrams[sent];
+        if (OsNetworkSendTo(aHandle, datagram->iPtr, datagram->iBytes, datagram->iAddress, datagram->iPort) != (int32_t)datagram->iBytes) {
+            break;
+        }
+    }
+    return (sent == 0 && aCount > 0? -1 : (int32_t)sent);
+}
+
 int32_t OsNetworkReceive(THandle aHandle, uint8_t* aBuffer, uint32_t aBytes)
 {
     int32_t received;
@@ -804,6 +900,21 @@ int32_t OsNetworkReceiveFrom(THandle aHandle, uint8_t* aBuffer, uint32_t aBytes,
     return received;
 }
 
+int32_t OsNetworkReceiveFromBatch(THandle aHandle, OsNetworkDatagram* aDatagrams, uint32_t aCount)
+{
+    /* Winsock has no batch receive; return a single datagram */
+    int32_t received;
+    if (aCount == 0) {
+        return -1;
+    }
+    received = OsNetworkReceiveFrom(aHandle, aDatagrams[0].iPtr, aDatagrams[0].iBytes, &aDatagrams[0].iAddress, &aDatagrams[0].iPort);
+    if (received < 0) {
+        return -1;
+    }
+    aDatagrams[0].iBytes = received;
+    return 1;
+}
+
 int32_t OsNetworkInterrupt(THandle aHandle, int32_t aInterrupt)
 {
     int32_t err = 0;
@@ -949,6 +1060,13 @@ int32_t OsNetworkSocketSetReuseAddress(THandle aHandle)
     return err;
 }
 
+int32_t OsNetworkSocketSetReusePort(THandle aHandle)
+{
+    /* SO_REUSEADDR doesn't balance connections between listening sockets on Windows */
+    UNUSED(aHandle);
+    return -1;
+}
+
 int32_t OsNetworkSocketSetMulticastTtl(THandle aHandle, uint8_t aTtl)
 {
     OsNetworkHandle* handle = (OsNetworkHandle*)aHandle;